@@ -38,25 +38,17 @@ public:
 };
 
 class AdvancedOrderTicket{
+    /* order params are stored inline so copies never touch the heap */
     order_condition _condition;
     condition_trigger _trigger;
-    std::unique_ptr<OrderParamaters> _order1;
-    std::unique_ptr<OrderParamaters> _order2;
-
-    static inline std::unique_ptr<OrderParamaters>
-    copy_order(const std::unique_ptr<OrderParamaters>& o)
-    { return o ? o->copy_new() : nullptr; }
-
-    static inline bool
-    cmp_orders(const std::unique_ptr<OrderParamaters>& o1,
-               const std::unique_ptr<OrderParamaters>& o2)
-    { return (o1 == o2) || (o1 && o2 && (*o1.get() == *o2.get())); }
+    OrderParamatersStorage _order1;
+    OrderParamatersStorage _order2;
 
 protected:
     AdvancedOrderTicket( order_condition condition,
                          condition_trigger trigger,
-                         OrderParamaters *order1 = nullptr,
-                         OrderParamaters *order2 = nullptr);
+                         const OrderParamatersStorage& order1 = nullptr,
+                         const OrderParamatersStorage& order2 = nullptr);
 
 public:
     static const AdvancedOrderTicket null;
@@ -64,16 +56,6 @@ public:
 
     AdvancedOrderTicket(); // null ticket
 
-    AdvancedOrderTicket(const AdvancedOrderTicket& aot);
-
-    AdvancedOrderTicket(AdvancedOrderTicket&& aot);
-
-    AdvancedOrderTicket&
-    operator=(const AdvancedOrderTicket& aot);
-
-    AdvancedOrderTicket&
-    operator=(AdvancedOrderTicket&& aot);
-
     inline order_condition
     condition() const
     { return _condition; }
@@ -96,7 +78,7 @@ public:
 
     inline void
     change_order1(const OrderParamaters& order)
-    { _order1 = std::move(order.copy_new()); }
+    { _order1 = order; }
 
     inline const OrderParamaters*
     order2() const
@@ -104,7 +86,7 @@ public:
 
     inline void
     change_order2(const OrderParamaters& order)
-    { _order2 = std::move(order.copy_new()); }
+    { _order2 = order; }
 
     bool
     operator==(const AdvancedOrderTicket& aot) const;
@@ -287,6 +269,50 @@ public:
     { return AdvancedOrderTicketAON(); }
 };
 
+
+/* display_size is stored as the size of order1 */
+class AdvancedOrderTicketICEBERG
+        : public AdvancedOrderTicket {
+protected:
+    AdvancedOrderTicketICEBERG(size_t display_size);
+
+public:
+    static const order_condition condition;
+    static const condition_trigger default_trigger;
+
+    static AdvancedOrderTicketICEBERG
+    build(size_t display_size);
+};
+
+
+/*
+ * pegged limit orders: the limit price is a cap, 'nticks' is the offset
+ * from the reference price AWAY from the other side of the market
+ *
+ *   primary - same side inside (buy: bid - nticks)
+ *   market  - opposite side inside (buy: ask - nticks)
+ *   mid     - mid-point, rounded passively (buy: mid - nticks)
+ *
+ * the reference ignores other pegged orders; re-pricing never crosses
+ */
+class AdvancedOrderTicketPEG
+        : public AdvancedOrderTicket {
+protected:
+    AdvancedOrderTicketPEG(order_condition condition, size_t nticks);
+
+public:
+    static const condition_trigger default_trigger;
+
+    static AdvancedOrderTicketPEG
+    build_primary(size_t nticks = 0);
+
+    static AdvancedOrderTicketPEG
+    build_market(size_t nticks = 0);
+
+    static AdvancedOrderTicketPEG
+    build_mid(size_t nticks = 0);
+};
+
 }; /* sob */
 
 #endif
@@ -56,7 +56,9 @@ enum class order_type {
     market,
     limit,
     stop,
-    stop_limit
+    stop_limit,
+    fill_or_kill,
+    immediate_or_cancel
 };
 
 enum class order_condition {
@@ -70,7 +72,11 @@ enum class order_condition {
     _trailing_stop_active, // private
     trailing_bracket,
     _trailing_bracket_active, // private
-    all_or_none
+    all_or_none,
+    iceberg,
+    primary_peg,
+    market_peg,
+    mid_peg
 };
 
 enum class condition_trigger {
@@ -97,7 +103,9 @@ enum class callback_msg{
     trigger_TRAILING_STOP_open_loss,
     trigger_TRAILING_STOP_adj_loss,
     trigger_TRAILING_STOP_close,
-    kill
+    kill,
+    trigger_PEG_adj,
+    modify
 };
 
 enum class fill_type{
@@ -124,6 +132,52 @@ using order_exec_cb_type = std::function<
     void(callback_msg,id_type,id_type,double,size_t)
     >;
 
+/* one (automatic) growth of the book, 'pause' is how long it was locked */
+struct book_growth_event {
+    double min_price;
+    double max_price;
+    size_t nticks_added;
+    bool above;
+    clock_type::duration pause;
+};
+
+using book_growth_cb_type = std::function<void(const book_growth_event&)>;
+
+/* (conflated) depth updates: price -> (size, side); 0 (both) if it's gone */
+using depth_update_type = std::map<double, std::pair<size_t, side_of_market>>;
+
+using depth_cb_type = std::function<void(const depth_update_type&)>;
+
+/* engine counters, since the book was created (ManagementInterface::stats) */
+struct engine_stats {
+    /* orders executed: from callers, and set off by them (stops etc.) */
+    unsigned long long orders_external;
+    unsigned long long orders_internal;
+    /* orders waiting for the dispatcher, now and at most */
+    unsigned long long external_queue_depth;
+    unsigned long long external_queue_hwm;
+    /* async callbacks waiting to be run, now and at most */
+    unsigned long long async_callback_backlog;
+    unsigned long long async_callback_hwm;
+    /*
+     * external orders that set off internal ones, the most one set off
+     * and the most queued at once
+     */
+    unsigned long long cascades;
+    unsigned long long cascade_max;
+    unsigned long long internal_queue_hwm;
+    /* trades (passes through the book), fills, and price levels visited */
+    unsigned long long trades;
+    unsigned long long matches;
+    unsigned long long levels_scanned;
+    unsigned long long levels_scanned_max;
+    /* the master lock, taken by the order path; waits in nanoseconds */
+    unsigned long long lock_acquisitions;
+    unsigned long long lock_contended;
+    unsigned long long lock_wait_ns;
+    unsigned long long lock_wait_max_ns;
+};
+
 std::string to_string(const order_type& ot);
 std::string to_string(const callback_msg& cm);
 std::string to_string(const side_of_market& s);
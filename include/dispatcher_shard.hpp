@@ -0,0 +1,173 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_SOB_DISPATCHER_SHARD
+#define JO_SOB_DISPATCHER_SHARD
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace sob{
+
+namespace detail{
+
+/* something w/ queued work (orders, callbacks) that a runner can run */
+class shard_client{
+public:
+    /* run up to 'max' queued items; true if there are still more */
+    virtual bool
+    run_queued(size_t max) = 0;
+
+protected:
+    ~shard_client() {}
+};
+
+
+/*
+ * a fixed set of threads shared by any number of clients (instead of a
+ * thread per client)
+ *
+ *   * a client w/ work queued gets in line via schedule() - ONCE, until
+ *     its queue drains - and the next free thread runs it 'batch' items at
+ *     a time, round-robin, so one busy client can't starve the rest
+ *   * a client is only ever run by one thread at a time (it isn't in line
+ *     while it's being run) so its items run in the order they're queued
+ *   * detach() takes a client out of line, waiting if it's being run, so
+ *     the client can be destroyed safely after
+ */
+class client_runner{
+    std::mutex _mtx;
+    std::condition_variable _ready_cond;
+    std::condition_variable _idle_cond;
+    std::deque<shard_client*> _ready;
+    std::vector<shard_client*> _running; /* one slot per thread */
+    size_t _nclients;
+    bool _stop;
+    const size_t _batch;
+
+    void
+    _run(size_t i);
+
+protected:
+    std::vector<std::thread> _threads;
+
+public:
+    client_runner(size_t nthreads, size_t batch);
+    virtual ~client_runner();
+
+    client_runner(const client_runner&) = delete;
+    client_runner& operator=(const client_runner&) = delete;
+
+    void
+    attach();
+
+    void
+    detach(shard_client *client);
+
+    void
+    schedule(shard_client *client);
+
+    size_t
+    nclients();
+
+    inline size_t
+    nthreads() const
+    { return _threads.size(); }
+};
+
+
+/* one (order) dispatcher thread shared by books, optionally pinned to a core */
+class dispatcher_shard
+        : public client_runner{
+    int _core;
+    bool _pinned;
+
+public:
+    static const size_t BATCH = 64;
+
+    /* core < 0 : don't pin */
+    explicit dispatcher_shard(int core = -1);
+
+    inline int
+    core() const
+    { return _core; }
+
+    /* did the pin (actually) take */
+    inline bool
+    pinned() const
+    { return _pinned; }
+};
+
+
+/* pin thread 't' to 'core'; false if we can't (or it failed) */
+bool
+pin_thread(std::thread& t, int core);
+
+
+/* the process-wide set of shards books can be created on */
+namespace shards{
+
+/* nshards == 0 : one per (hardware) core */
+void
+start(size_t nshards, bool pin);
+
+/* throws std::logic_error if any book is still on a shard */
+void
+stop();
+
+size_t
+count();
+
+/* throws std::out_of_range if there's no such shard */
+dispatcher_shard*
+get(size_t i);
+
+}; /* shards */
+
+
+/* the process-wide pool books (created while it's up) run async callbacks on */
+namespace callback_pool{
+
+static const size_t BATCH = 256;
+
+/* nthreads == 0 : one per (hardware) core */
+void
+start(size_t nthreads);
+
+/* throws std::logic_error if any book still uses the pool */
+void
+stop();
+
+/* 0 if the pool isn't running */
+size_t
+nthreads();
+
+/* nullptr if the pool isn't running */
+client_runner*
+get();
+
+}; /* callback_pool */
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_DISPATCHER_SHARD */
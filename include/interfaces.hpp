@@ -23,6 +23,8 @@ along with this program. If not, see http://www.gnu.org/licenses.
 
 #include "common.hpp"
 #include "advanced_order.hpp"
+#include "market_data.hpp"
+#include "latency.hpp"
 
 namespace sob{
 
@@ -105,10 +107,48 @@ public:
     virtual std::map<double,std::pair<size_t, side_of_market>>
     market_depth(size_t depth=8) const = 0;
 
-    /* new elems get put on back i.e beg() == oldest, end() == newest */
-    virtual const std::vector<timesale_entry_type>&
+    /*
+     * (a copy of) the trades still held - see set_time_and_sales() - oldest
+     * first i.e beg() == oldest, end() == newest
+     */
+    virtual std::vector<timesale_entry_type>
     time_and_sales() const = 0;
 
+    /*
+     * append the trades from sequence # 'seq' on (trades are numbered from
+     * 0) to 'buf' and return the sequence # of the next one - the cursor
+     * for the next call; if 'seq' has already been overwritten it starts
+     * at the oldest trade held. Doesn't take the book's lock - it's safe
+     * to poll from any thread while orders are being executed.
+     */
+    virtual unsigned long long
+    read_trades_since(unsigned long long seq,
+                      std::vector<timesale_entry_type>& buf) const = 0;
+
+    /*
+     * aggregates over the trades held w/ times in [from, to], computed in
+     * place (no copy of the trades, no lock): volume-weighted average
+     * price (0 if there weren't any), and volume at each price
+     */
+    virtual double
+    vwap(clock_type::time_point from, clock_type::time_point to) const = 0;
+
+    virtual std::map<double, unsigned long long>
+    volume_profile(clock_type::time_point from,
+                   clock_type::time_point to) const = 0;
+
+    /*
+     * append the book deltas (see market_data.hpp) from sequence # 'seq' on
+     * to 'buf' and return the sequence # of the next one; like
+     * read_trades_since() it doesn't lock. If 'seq' has been overwritten
+     * the deltas start later than asked for (buf's first seq) - the reader
+     * missed something and has to rebuild (restart the stream). Nothing,
+     * and 'seq' back, if the stream isn't running (start_book_deltas()).
+     */
+    virtual unsigned long long
+    read_book_deltas(unsigned long long seq,
+                     std::vector<book_delta>& buf) const = 0;
+
     virtual order_info
     get_order_info(id_type id) const = 0;
 
@@ -155,6 +195,38 @@ public:
     virtual bool 
     pull_order(id_type id) = 0;
 
+    /*
+     * amend a resting limit order in place (same id): 'new_size' is the
+     * total size of the order, 'new_price' of 0 keeps the current price
+     *
+     * decreasing size keeps time priority, increasing size or changing price
+     * loses it; a new price that can trade is sent through the matching
+     * engine like any other limit. callback_msg::modify is sent w/ the new
+     * price and size before any fills. returns false if 'id' isn't a resting
+     * (non-AON) limit order
+     */
+    virtual bool
+    modify_order(id_type id, size_t new_size, double new_price = 0) = 0;
+
+    /* 
+     * fill-or-kill: fill all 'size' at 'limit' or better, or kill it
+     * immediate-or-cancel: fill what we can at 'limit' or better, kill the rest
+     *
+     * neither is ever put on the book; callback_msg::kill is sent w/ the
+     * size that was NOT filled
+     */
+    virtual id_type
+    insert_fill_or_kill_order(bool buy,
+                              double limit,
+                              size_t size,
+                              order_exec_cb_type exec_cb = nullptr) = 0;
+
+    virtual id_type
+    insert_immediate_or_cancel_order(bool buy,
+                                     double limit,
+                                     size_t size,
+                                     order_exec_cb_type exec_cb = nullptr) = 0;
+
     virtual std::future<id_type>
     insert_limit_order_async(bool buy,
                              double limit,
@@ -175,6 +247,22 @@ public:
     virtual std::future<id_type> // 1 = true, 0 = false
     pull_order_async(id_type id) = 0;
 
+    virtual std::future<id_type> // 1 = true, 0 = false
+    modify_order_async(id_type id, size_t new_size, double new_price = 0) = 0;
+
+    virtual std::future<id_type>
+    insert_fill_or_kill_order_async(bool buy,
+                                    double limit,
+                                    size_t size,
+                                    order_exec_cb_type exec_cb = nullptr) = 0;
+
+    virtual std::future<id_type>
+    insert_immediate_or_cancel_order_async(bool buy,
+                                           double limit,
+                                           size_t size,
+                                           order_exec_cb_type exec_cb
+                                               = nullptr) = 0;
+
     virtual void
     wait_for_async_callbacks() = 0;
 };
@@ -336,6 +424,145 @@ public:
 
     virtual void
     grow_book_below(double new_min) = 0;
+
+    /*
+     * grow the book (in the dispatcher) instead of rejecting an order
+     * priced outside of it: by the larger of what the order needs and
+     * 'factor' x the current number of ticks, but never past 'max_ticks'
+     * (0 for no cap) - orders that would need more are rejected as before
+     *
+     * 'factor' == 0 turns it off (the default); 'growth_cb' is called for
+     * each growth, from the dispatcher thread, and MUST NOT call back
+     * into the orderbook
+     */
+    virtual void
+    set_auto_grow(double factor,
+                  size_t max_ticks = 0,
+                  book_growth_cb_type growth_cb = nullptr) = 0;
+
+    /*
+     * release the levels outside [new_min, new_max] (back to the OS); false,
+     * and the book is left as is, if an order, an advanced order's price or
+     * the last trade is out there
+     */
+    virtual bool
+    shrink_book(double new_min, double new_max) = 0;
+
+    /*
+     * keep the book within 'margin' ticks of its outermost orders (and the
+     * last trade): once a side has more than 2 x 'margin' empty ticks the
+     * dispatcher shrinks it back to 'margin' (0 turns it off, the default)
+     */
+    virtual void
+    set_auto_recenter(size_t margin) = 0;
+
+    /*
+     * append every order the book accepts (and every change to its range)
+     * to the journal at 'path', from here on - so start it on a new book, or
+     * one just rebuilt from the same journal; it's written - and fsync'd -
+     * by a background thread every 'commit_ms' (group commit) so an
+     * order can be acknowledged before it's on disk: sync_journal() blocks
+     * until it is
+     *
+     * callbacks aren't journaled; throws std::logic_error if a journal is
+     * already running, std::runtime_error if 'path' can't be opened (or
+     * isn't a journal for this tick size)
+     */
+    virtual void
+    start_journal(const std::string& path, unsigned commit_ms = 5) = 0;
+
+    /* syncs what's been appended and closes it */
+    virtual void
+    stop_journal() = 0;
+
+    virtual void
+    sync_journal() = 0;
+
+    /*
+     * rebuild the state of a journaled book by re-executing its journal
+     * (orders get the same ids); the book must be new - no orders yet,
+     * no journal running - and have the journal's tick size and (initial)
+     * range; returns the number of records replayed
+     */
+    virtual size_t
+    replay_journal(const std::string& path) = 0;
+
+    /*
+     * write the state of the book - resting orders (in time priority) and
+     * the advanced order state hanging off them, the cached pointers, ids
+     * and totals - to 'out' in a compact binary format; returns the number
+     * of orders. Time & sales and callbacks aren't part of it.
+     */
+    virtual size_t
+    snapshot(std::ostream& out) const = 0;
+
+    /*
+     * bulk-load a snapshot into a new book (no orders yet, no journal
+     * running, same tick size), bypassing matching; the book is resized
+     * to the snapshot's range. Returns the number of orders.
+     */
+    virtual size_t
+    restore(std::istream& in) = 0;
+
+    /*
+     * time & sales is a fixed-size ring: once 'capacity' (rounded up to a
+     * power of 2; default 1M) trades are held the oldest are overwritten.
+     * W/ an 'mmap_path' the ring lives in that (re-created) file, mapped
+     * shared, so it can be read from other processes (see timesales.hpp).
+     * The most recent trades - and their sequence #s - are carried over.
+     */
+    virtual void
+    set_time_and_sales(size_t capacity, const std::string& mmap_path = "") = 0;
+
+    /*
+     * publish every change to the visible limit book - order by order (L3)
+     * and level by level (L2) - to a ring of 'capacity' (rounded up to a
+     * power of 2) deltas, for read_book_deltas(); the first batch is the
+     * book as it is now (adds for every order and level). Throws
+     * std::logic_error if it's already running.
+     */
+    virtual void
+    start_book_deltas(size_t capacity = 1 << 16) = 0;
+
+    virtual void
+    stop_book_deltas() = 0;
+
+    /*
+     * conflated depth for slow consumers: every 'interval_ms' 'cb' gets the
+     * latest state of each level that changed since its last update (the
+     * first update is the whole book); the matching path just marks levels
+     * dirty and one publisher thread (per book) collects them. 'cb' is
+     * called from the publisher thread with no locks held (it can query
+     * the book or (un)subscribe); once unsubscribe_depth() returns it
+     * won't be called again. Returns the subscription id.
+     */
+    virtual unsigned long long
+    subscribe_depth(depth_cb_type cb, unsigned interval_ms = 10) = 0;
+
+    virtual bool
+    unsubscribe_depth(unsigned long long id) = 0;
+
+    /*
+     * time each stage of an order's trip through the book (latency_stage)
+     * into a histogram per stage; turning it on (again) starts them over,
+     * off leaves them as they are. Unless it's been on, or it's compiled
+     * out (-DSOB_NO_LATENCY_STATS), latency_stats() is empty.
+     */
+    virtual void
+    set_latency_stats(bool on) = 0;
+
+    virtual std::map<latency_stage, latency_summary>
+    latency_stats() const = 0;
+
+    virtual void
+    dump_latency_stats(std::ostream& out = std::cout) const = 0;
+
+    /*
+     * engine counters and high-water marks (see engine_stats); they're
+     * always on, cheap enough to leave that way
+     */
+    virtual engine_stats
+    stats() const = 0;
 };
 
 }; /* sob */
@@ -0,0 +1,192 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_SOB_JOURNAL
+#define JO_SOB_JOURNAL
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+
+#include "common.hpp"
+#include "advanced_order.hpp"
+
+namespace sob{
+
+namespace detail{
+
+/*
+ * binary, append-only order journal
+ *
+ *   header : "SOBJ" | u32 version | f64 tick_size | f64 min | f64 max
+ *   record : u32 length | u32 crc32 | u8 kind | ... (see journal_record)
+ *
+ * native byte order (it's a recovery log, not an exchange format); a
+ * torn record at the end (crash mid-write) is ignored by the reader and
+ * cut off by a writer re-opening the journal; a bad record anywhere else
+ * is an error
+ */
+struct journal_header{
+    static const uint32_t VERSION = 2;
+    double tick_size;
+    double min_price;
+    double max_price;
+};
+
+struct journal_record{
+    enum class kind : uint8_t {
+        order = 0,  /* external order (insert/pull/replace/modify) */
+        grow_above, /* limit = new max */
+        grow_below, /* limit = new min */
+        shrink      /* limit = new min, stop = new max */
+    };
+
+    kind k;
+    order_type type;
+    bool is_buy;
+    double limit;
+    double stop;
+    size_t sz;
+    id_type id;
+    AdvancedOrderTicket aot;
+
+    journal_record();
+
+    journal_record( order_type type,
+                    bool is_buy,
+                    double limit,
+                    double stop,
+                    size_t sz,
+                    id_type id,
+                    const AdvancedOrderTicket& aot );
+
+    journal_record(kind k, double a, double b = 0);
+};
+
+
+/*
+ * encodes records into an in-memory buffer (cheap, done by the dispatcher)
+ * and has a background thread write them out, fsync'ing once per batch
+ * ('group commit') every 'commit_interval' - or sooner if the buffer fills
+ */
+class journal_writer{
+    std::FILE *_file;
+    std::vector<char> _buf; /* PROTECTED by _mtx */
+    unsigned long long _nappended; /* bytes, PROTECTED by _mtx */
+    unsigned long long _nsynced; /* bytes, PROTECTED by _mtx */
+    size_t _nwaiting; /* blocked in sync(), PROTECTED by _mtx */
+    bool _stop;
+    bool _failed;
+    std::mutex _mtx;
+    std::condition_variable _cond;
+    std::condition_variable _synced_cond;
+    const std::chrono::milliseconds _commit_interval;
+    std::thread _thread;
+
+    static const size_t EAGER_BYTES = 1 << 20;
+
+    void
+    _run();
+
+public:
+    /*
+     * appends to 'path' (writes the header if it's new/empty); an existing
+     * journal is read through first and truncated after its last complete
+     * record; throws std::runtime_error if it's corrupt
+     */
+    journal_writer( const std::string& path,
+                    const journal_header& header,
+                    std::chrono::milliseconds commit_interval );
+    ~journal_writer();
+
+    journal_writer(const journal_writer&) = delete;
+    journal_writer& operator=(const journal_writer&) = delete;
+
+    void
+    append(const journal_record& rec);
+
+    /* block until everything appended so far is on disk; throws
+       std::runtime_error if a write failed */
+    void
+    sync();
+};
+
+
+/*
+ * reads a journal a chunk at a time, decoding as it goes; throws
+ * std::runtime_error if it isn't one
+ */
+class journal_reader{
+    std::FILE *_file;
+    std::vector<char> _buf; /* [_pos, _buf.size()) hasn't been decoded */
+    size_t _pos;
+    unsigned long long _offset; /* of _buf[0] in the file */
+    unsigned long long _valid; /* end of the last good record */
+    bool _eof;
+    bool _done;
+    journal_header _header;
+
+    static const size_t CHUNK_BYTES = 1 << 22;
+
+    /* make sure 'n' bytes from _pos are buffered; false if the file ends */
+    bool
+    _fill(size_t n);
+
+    /* is the rest of the file zero bytes (pre-allocated, never written)? */
+    bool
+    _rest_is_zero();
+
+public:
+    explicit journal_reader(const std::string& path);
+    ~journal_reader();
+
+    journal_reader(const journal_reader&) = delete;
+    journal_reader& operator=(const journal_reader&) = delete;
+
+    inline const journal_header&
+    header() const
+    { return _header; }
+
+    /*
+     * false at the end (or a torn record at the end); throws
+     * std::runtime_error if a record before that is corrupt
+     */
+    bool
+    next(journal_record& rec);
+
+    /* where the last good record (or the header) ends */
+    inline unsigned long long
+    valid_size() const
+    { return _valid; }
+
+    /* what's been read so far; the whole file once next() is false */
+    inline unsigned long long
+    size() const
+    { return _offset + _buf.size(); }
+};
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_JOURNAL */
@@ -0,0 +1,179 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#ifndef JO_SOB_LATENCY
+#define JO_SOB_LATENCY
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/*
+ * per-stage latency stats; -DSOB_NO_LATENCY_STATS compiles the stamping out
+ * of the order path completely (latency_stats() is then always empty)
+ */
+#if !defined(SOB_NO_LATENCY_STATS) && (defined(__x86_64__) || defined(_M_X64))
+#define SOB_LATENCY_RDTSC
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#elif defined(SOB_LATENCY_RDTSC)
+#include <x86intrin.h>
+#endif
+
+namespace sob{
+
+/*
+ * the stages of an order's trip through the book
+ *
+ *   queue    : enqueued (_push_external_order) -> picked up by the dispatcher
+ *   lock     : picked up -> holding the master lock
+ *   execute  : executing it, under the lock (all inline books record)
+ *   fulfil   : done executing -> fulfilling the promise (out of the lock,
+ *              w/ the result built; the caller is woken right after)
+ *   callback : async callback queued -> delivered (about to be called)
+ *   total    : enqueued -> fulfilling the promise
+ */
+enum class latency_stage : uint8_t {
+    queue = 0,
+    lock,
+    execute,
+    fulfil,
+    callback,
+    total
+};
+
+constexpr size_t NLATENCY_STAGES = 6;
+
+std::string
+to_string(latency_stage s);
+
+/* (all but 'count') in nanoseconds */
+struct latency_summary{
+    unsigned long long count;
+    double min;
+    double mean;
+    double p50;
+    double p90;
+    double p99;
+    double p999;
+    double max;
+};
+
+namespace detail{
+
+/* the TSC on x86-64, steady_clock ticks elsewhere */
+struct latency_clock{
+    static inline uint64_t
+    now()
+    {
+#ifdef SOB_LATENCY_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count() );
+#endif
+    }
+
+    /*
+     * calibrated against steady_clock from the first call on (blocks for a
+     * few ms the first time, if it has to)
+     */
+    static double
+    ns_per_tick();
+};
+
+/*
+ * HDR-style (log-linear) histogram of clock ticks: values < 8 get a bucket
+ * each, above that every power of 2 is split in 8 - so any value is off by
+ * < 12.5%, over the full 64-bit range, in 496 fixed buckets
+ *
+ * ONE writer at a time (the caller serializes them), so counters are
+ * bumped w/ relaxed load/store, not read-modify-write; readers may see a
+ * record half-done - and two writers (callers of an inline book's
+ * wait_for_async_callbacks()) can lose one - which is fine for stats
+ */
+class latency_histogram{
+public:
+    static const size_t NBUCKETS = 62 * 8;
+
+    latency_histogram();
+
+    inline void
+    record(uint64_t ticks)
+    {
+        _bump(_buckets[bucket(ticks)], 1);
+        _bump(_count, 1);
+        _bump(_sum, ticks);
+        if( ticks < _min.load(std::memory_order_relaxed) )
+            _min.store(ticks, std::memory_order_relaxed);
+        if( ticks > _max.load(std::memory_order_relaxed) )
+            _max.store(ticks, std::memory_order_relaxed);
+    }
+
+    void
+    reset();
+
+    latency_summary
+    summary(double ns_per_tick) const;
+
+    static inline size_t
+    bucket(uint64_t v)
+    {
+        if( v < 8 )
+            return static_cast<size_t>(v);
+        size_t e = 63 - _clz(v);
+        return (e - 2) * 8 + static_cast<size_t>((v >> (e - 3)) & 7);
+    }
+
+    /* highest value that lands in bucket 'b' */
+    static double
+    bucket_high(size_t b);
+
+private:
+    std::atomic<uint64_t> _buckets[NBUCKETS];
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _min;
+    std::atomic<uint64_t> _max;
+
+    static inline void
+    _bump(std::atomic<uint64_t>& a, uint64_t n)
+    { a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+
+    static inline size_t
+    _clz(uint64_t v)
+    {
+#ifdef _MSC_VER
+        unsigned long i;
+        _BitScanReverse64(&i, v);
+        return 63 - i;
+#else
+        return __builtin_clzll(v);
+#endif
+    }
+};
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_LATENCY */
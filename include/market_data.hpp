@@ -0,0 +1,127 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_SOB_MARKET_DATA
+#define JO_SOB_MARKET_DATA
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+namespace sob{
+
+/*
+ * one change to the (visible, non-AON limit) book
+ *
+ *   L3 - order_add     : 'id' rests at 'price' w/ 'size'
+ *        order_modify  : 'id' now has 'size' (same price/priority)
+ *        order_execute : 'size' of 'id' traded; it's gone once nothing's left
+ *        order_delete  : 'id' (w/ 'size' left) was pulled/cancelled/moved
+ *   L2 - level_add/level_modify : the 'is_buy' side at 'price' now has
+ *                                 'size' in total
+ *        level_delete          : ... has nothing
+ *
+ * everything one order (and what it sets off) did to the book is a
+ * 'batch': its L3 deltas, in the order they happened, then its L2 deltas;
+ * 'end_of_batch' marks the last one. A batch is published all at once.
+ */
+struct book_delta{
+    enum class type : uint8_t {
+        order_add = 0,
+        order_modify,
+        order_execute,
+        order_delete,
+        level_add,
+        level_modify,
+        level_delete
+    };
+    unsigned long long seq;
+    unsigned long long batch;
+    id_type id;
+    double price;
+    size_t size;
+    type dtype;
+    bool is_buy;
+    bool end_of_batch;
+
+    bool
+    is_L2() const
+    { return dtype >= type::level_add; }
+};
+
+std::string
+to_string(book_delta::type t);
+
+std::string
+to_string(const book_delta& d);
+
+std::ostream&
+operator<<(std::ostream& out, const book_delta& d);
+
+
+namespace detail{
+
+/*
+ * fixed-capacity ring of book deltas; same deal as timesales_ring - one
+ * writer (the dispatcher, a batch at a time), any number of lock-free
+ * readers, 'claimed' bumped before a batch is written and 'head' after
+ */
+class book_delta_ring{
+    std::vector<book_delta> _slots;
+    const uint64_t _mask;
+    std::atomic<uint64_t> _claimed;
+    std::atomic<uint64_t> _head;
+
+public:
+    /* 'capacity' is rounded up to a power of 2 */
+    explicit book_delta_ring(size_t capacity);
+
+    book_delta_ring(const book_delta_ring&) = delete;
+    book_delta_ring& operator=(const book_delta_ring&) = delete;
+
+    /* WRITER ONLY; sets seq and end_of_batch */
+    void
+    push_batch(std::vector<book_delta>& batch);
+
+    /*
+     * append the deltas from sequence # 'seq' on to 'buf'; if 'seq' has
+     * been overwritten it starts at the oldest one held (the reader has
+     * missed something - check buf's first seq - and needs to resync);
+     * returns the sequence # of the next delta
+     */
+    uint64_t
+    read_since(uint64_t seq, std::vector<book_delta>& buf) const;
+
+    inline uint64_t
+    head() const
+    { return _head.load(std::memory_order_acquire); }
+
+    inline size_t
+    capacity() const
+    { return static_cast<size_t>(_mask + 1); }
+};
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_MARKET_DATA */
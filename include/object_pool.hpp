@@ -0,0 +1,138 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_SOB_OBJECT_POOL
+#define JO_SOB_OBJECT_POOL
+
+#include <cstddef>
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <new>
+#include <type_traits>
+
+namespace sob{
+
+namespace detail{
+
+/*
+ * typed object pool for the (small) objects advanced orders hang off of
+ * their bndls (order links, brackets, contingent orders)
+ *
+ *   * objects live in fixed-size chunks so addresses never change
+ *   * released slots go on a free list and are handed out first
+ *   * each slot knows its pool so an object can be cloned/released
+ *     from places that don't have access to the orderbook (bndl copy/dtor)
+ *
+ * NOT thread-safe - only touched by the orderbook while _master_mtx is held
+ * (or from the orderbook's destructor)
+ */
+template<typename T>
+class object_pool{
+    struct slot{
+        object_pool *pool;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type obj;
+    };
+
+    static constexpr size_t CHUNK_SIZE = 64;
+
+    std::vector<std::unique_ptr<slot[]>> _chunks;
+    std::vector<slot*> _free;
+    size_t _nused;
+
+    static inline slot*
+    _slot_of(const T *obj)
+    {
+        return reinterpret_cast<slot*>(
+            const_cast<char*>(reinterpret_cast<const char*>(obj))
+            - offsetof(slot, obj) );
+    }
+
+    slot*
+    _next_slot()
+    {
+        if( _free.empty() ){
+            _chunks.emplace_back( new slot[CHUNK_SIZE] );
+            slot *s = _chunks.back().get();
+            for( size_t i = CHUNK_SIZE; i > 0; --i ){
+                s[i-1].pool = this;
+                _free.push_back( s + i - 1 );
+            }
+        }
+        slot *s = _free.back();
+        _free.pop_back();
+        return s;
+    }
+
+public:
+    object_pool()
+        : _nused(0)
+        {}
+
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    /* objects still in use are NOT destroyed (they're all trivial anyway) */
+    ~object_pool()
+    { assert( _nused == 0 ); }
+
+    template<typename... Args>
+    T*
+    acquire(Args&&... args)
+    {
+        slot *s = _next_slot();
+        T *obj = new (&s->obj) T{ std::forward<Args>(args)... };
+        ++_nused;
+        return obj;
+    }
+
+    /* copy into another slot of the same pool 'obj' came from */
+    static T*
+    clone(const T *obj)
+    {
+        object_pool *pool = _slot_of(obj)->pool;
+        slot *s = pool->_next_slot();
+        T *cpy = new (&s->obj) T(*obj);
+        ++pool->_nused;
+        return cpy;
+    }
+
+    static void
+    release(T *obj)
+    {
+        slot *s = _slot_of(obj);
+        object_pool *pool = s->pool;
+        obj->~T();
+        pool->_free.push_back(s);
+        assert( pool->_nused > 0 );
+        --pool->_nused;
+    }
+
+    inline size_t
+    size() const
+    { return _nused; }
+
+    inline size_t
+    capacity() const
+    { return _chunks.size() * CHUNK_SIZE; }
+};
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_OBJECT_POOL */
@@ -18,6 +18,7 @@ along with this program. If not, see http://www.gnu.org/licenses.
 #ifndef JO_SOB_ORDER
 #define JO_SOB_ORDER
 
+#include <new>
 #include "common.hpp"
 
 namespace sob{
@@ -255,6 +256,152 @@ public:
     { return true; }
 };
 
+/*
+ * inline (allocation-free) storage for either of the concrete types above;
+ * behaves like a nullable pointer to OrderParamaters but copies by value
+ */
+class OrderParamatersStorage{
+    enum class tag : char {
+        none = 0,
+        by_price,
+        by_nticks
+    };
+
+    tag _tag;
+    union{
+        OrderParamatersByPrice _by_price;
+        OrderParamatersByNTicks _by_nticks;
+    };
+
+    void
+    _copy(const OrderParamatersStorage& ops)
+    {
+        switch( ops._tag ){
+        case tag::by_price:
+            new (&_by_price) OrderParamatersByPrice(ops._by_price);
+            break;
+        case tag::by_nticks:
+            new (&_by_nticks) OrderParamatersByNTicks(ops._by_nticks);
+            break;
+        case tag::none:
+            break;
+        };
+        _tag = ops._tag;
+    }
+
+    void
+    _destroy()
+    {
+        switch( _tag ){
+        case tag::by_price:
+            _by_price.~OrderParamatersByPrice();
+            break;
+        case tag::by_nticks:
+            _by_nticks.~OrderParamatersByNTicks();
+            break;
+        case tag::none:
+            break;
+        };
+        _tag = tag::none;
+    }
+
+public:
+    OrderParamatersStorage()
+        : _tag(tag::none)
+        {}
+
+    OrderParamatersStorage(std::nullptr_t)
+        : _tag(tag::none)
+        {}
+
+    OrderParamatersStorage(const OrderParamatersByPrice& op)
+        : _tag(tag::by_price), _by_price(op)
+        {}
+
+    OrderParamatersStorage(const OrderParamatersByNTicks& op)
+        : _tag(tag::by_nticks), _by_nticks(op)
+        {}
+
+    OrderParamatersStorage(const OrderParamaters& op)
+        : _tag(tag::none)
+        {
+            if( op.is_by_price() ){
+                new (&_by_price) OrderParamatersByPrice( op.is_buy(),
+                    op.size(), op.limit_price(), op.stop_price() );
+                _tag = tag::by_price;
+            }else if( op.is_by_nticks() ){
+                new (&_by_nticks) OrderParamatersByNTicks( op.is_buy(),
+                    op.size(), op.limit_nticks(), op.stop_nticks() );
+                _tag = tag::by_nticks;
+            }else{
+                throw std::invalid_argument("invalid OrderParamaters type");
+            }
+        }
+
+    OrderParamatersStorage(const OrderParamatersStorage& ops)
+        : _tag(tag::none)
+        { _copy(ops); }
+
+    ~OrderParamatersStorage()
+    { _destroy(); }
+
+    OrderParamatersStorage&
+    operator=(const OrderParamatersStorage& ops)
+    {
+        if( this != &ops ){
+            _destroy();
+            _copy(ops);
+        }
+        return *this;
+    }
+
+    inline void
+    reset()
+    { _destroy(); }
+
+    inline OrderParamaters*
+    get()
+    {
+        switch( _tag ){
+        case tag::by_price: return &_by_price;
+        case tag::by_nticks: return &_by_nticks;
+        default: return nullptr;
+        };
+    }
+
+    inline const OrderParamaters*
+    get() const
+    { return const_cast<OrderParamatersStorage*>(this)->get(); }
+
+    inline OrderParamaters*
+    operator->()
+    { return get(); }
+
+    inline const OrderParamaters*
+    operator->() const
+    { return get(); }
+
+    inline OrderParamaters&
+    operator*()
+    { return *get(); }
+
+    inline const OrderParamaters&
+    operator*() const
+    { return *get(); }
+
+    explicit inline
+    operator bool() const
+    { return _tag != tag::none; }
+
+    inline bool
+    operator==(const OrderParamatersStorage& ops) const
+    { return (_tag == ops._tag) && (!(*this) || (*get() == *ops.get())); }
+
+    inline bool
+    operator!=(const OrderParamatersStorage& ops) const
+    { return !operator==(ops); }
+};
+
 }; /* sob */
 
 #endif /* JO_SOB_ORDER */
@@ -27,6 +27,11 @@ static constexpr bool
 is_limit(const limit_bndl& e)
 { return true; }
 
+static constexpr bool
+is_immediate(const order_queue_elem& e)
+{ return e.type == order_type::fill_or_kill
+         || e.type == order_type::immediate_or_cancel; }
+
 static constexpr bool
 is_limit(const stop_bndl& e)
 { return false; }
@@ -143,6 +148,35 @@ static constexpr bool
 is_not_AON(const _order_bndl& bndl )
 { return bndl.condition != order_condition::all_or_none; }
 
+static constexpr bool
+is_iceberg(const order_queue_elem& e)
+{ return e.condition == order_condition::iceberg; }
+
+static constexpr bool
+is_iceberg(const _order_bndl& bndl )
+{ return bndl.condition == order_condition::iceberg; }
+
+static constexpr bool
+is_pegged(const order_queue_elem& e)
+{ return e.condition == order_condition::primary_peg
+         || e.condition == order_condition::market_peg
+         || e.condition == order_condition::mid_peg; }
+
+static constexpr bool
+is_pegged(const _order_bndl& bndl)
+{ return bndl.condition == order_condition::primary_peg
+         || bndl.condition == order_condition::market_peg
+         || bndl.condition == order_condition::mid_peg; }
+
+static constexpr bool
+is_not_pegged_or_AON(const _order_bndl& bndl)
+{ return !is_pegged(bndl) && is_not_AON(bndl); }
+
+/* displayed + hidden (iceberg reserve) size */
+static constexpr size_t
+total_size(const _order_bndl& bndl )
+{ return is_iceberg(bndl) ? bndl.sz + bndl.iceberg.reserve : bndl.sz; }
+
 static constexpr bool
 needs_partial_fill(const order_queue_elem& e)
 { return e.trigger == condition_trigger::fill_partial; }
@@ -238,7 +272,7 @@ as_order_info(bool is_buy,
               double price,
               const limit_bndl& bndl,
               const AdvancedOrderTicket& aot)
-{ return order_info(order_type::limit, is_buy, price, 0, bndl.sz, aot); }
+{ return order_info(order_type::limit, is_buy, price, 0, total_size(bndl), aot); }
 
 static order_info
 as_order_info(bool is_buy,
@@ -0,0 +1,383 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_SOB_PAGED_LADDER
+#define JO_SOB_PAGED_LADDER
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <new>
+#include <tuple>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+namespace sob{
+
+namespace detail{
+
+/* platform virtual memory calls (src/orderbook/paged_ladder.cpp) */
+namespace vmem{
+
+size_t
+page_size();
+
+/* reserve zero-filled address space; nothing is usable until commit() */
+void*
+reserve(size_t bytes);
+
+/* make (part of) a reserved range usable; pages get backed on first write */
+void
+commit(void *addr, size_t bytes);
+
+/* give back the memory for the WHOLE pages in range; they read as zero after */
+void
+decommit(void *addr, size_t bytes);
+
+void
+release(void *addr, size_t bytes);
+
+/*
+ * (re)create 'path', 'bytes' long and zero-filled, and map it shared so
+ * other processes can see it; throws std::runtime_error
+ */
+void*
+map_file(const std::string& path, size_t bytes);
+
+void
+unmap_file(void *addr, size_t bytes);
+
+}; /* vmem */
+
+
+/*
+ * contiguous (price) ladder backed by reserved virtual memory
+ *
+ *   * the whole range is reserved up front but physical memory is only
+ *     committed for the pages that get written to, so a huge, fine-tick
+ *     book only costs memory where orders actually rest
+ *   * elements are constructed (placement-new) a block (~1 page) at a time
+ *     the first time one of them is written - the owner MUST call touch()
+ *     before it writes to an element; a bitmap records which blocks have
+ *     been so destruction/moves only visit those
+ *   * an element in a block that was never written reads as zero bytes,
+ *     which has to look like an empty, default-constructed T (checked)
+ *   * 'headroom' elements are reserved on each side so grow_front() and
+ *     grow_back() can extend the ladder IN PLACE - existing elements
+ *     (and pointers to them) are left alone
+ *   * shrink_front() and shrink_back() destroy elements and hand them back
+ *     to the headroom, decommitting their pages
+ *   * elements only move if a grow runs out of headroom (move_from into a
+ *     new, larger ladder); pointer arithmetic (plevel) is good anywhere
+ *     in [begin(), end()]
+ *
+ * NOT thread-safe
+ */
+template<typename T>
+class paged_ladder{
+    /* what we reserved */
+    T *_rbase;
+    size_t _rsize;
+    /* what's in use: [ _base, _base + _size ) */
+    T *_base;
+    size_t _size;
+    /*
+     * one bit per block (from _rbase); if set every element of the block
+     * that's in use has been constructed, if not none of them have
+     */
+    std::vector<bool> _written;
+
+    /* 64 MB of (virtual) headroom, at least, on each side */
+    static constexpr size_t MIN_HEADROOM_BYTES = sizeof(void*) >= 8
+                                               ? (size_t(1) << 26) : 0;
+
+    /* elements per block: enough to cover a page */
+    static size_t
+    _block_size()
+    {
+        static const size_t sz = (vmem::page_size() + sizeof(T) - 1)
+                               / sizeof(T);
+        return sz;
+    }
+
+    /* does constructing a T over zero bytes leave them zero? */
+    static bool
+    _default_is_zero()
+    {
+        static const bool is_zero = [](){
+            static const unsigned char zeros[sizeof(T)] = {};
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+            std::memset(static_cast<void*>(&buf), 0, sizeof(T));
+            T *t = ::new(static_cast<void*>(&buf)) T();
+            bool r = std::memcmp(t, zeros, sizeof(T)) == 0;
+            t->~T();
+            return r;
+        }();
+        return is_zero;
+    }
+
+    /* [b, e) of block 'i' that's in use */
+    inline std::pair<T*, T*>
+    _in_use(size_t i) const
+    {
+        T *b = std::max(_rbase + i * _block_size(), _base);
+        T *e = std::min(_rbase + (i + 1) * _block_size(), _base + _size);
+        return std::make_pair(b, std::max(b, e));
+    }
+
+    inline size_t
+    _block_of(const T *p) const
+    { return static_cast<size_t>(p - _rbase) / _block_size(); }
+
+    void
+    _construct_block(size_t i)
+    {
+        T *b, *e;
+        std::tie(b, e) = _in_use(i);
+        for( ; b < e; ++b )
+            ::new(static_cast<void*>(b)) T();
+        _written[i] = true;
+    }
+
+    /* call 'func' on every constructed element in [b, e) */
+    template<typename F>
+    void
+    _for_each_written(T *b, T *e, F func)
+    {
+        if( b >= e )
+            return;
+        for( size_t i = _block_of(b), last = _block_of(e - 1); i <= last; ++i ){
+            if( !_written[i] )
+                continue;
+            T *bb, *ee;
+            std::tie(bb, ee) = _in_use(i);
+            for( bb = std::max(bb, b), ee = std::min(ee, e); bb < ee; ++bb )
+                func(*bb);
+        }
+    }
+
+    void
+    _free()
+    {
+        if( _rbase ){
+            _for_each_written( _base, _base + _size, [](T& t){ t.~T(); } );
+            vmem::release(_rbase, _rsize * sizeof(T));
+        }
+        _rbase = _base = nullptr;
+        _rsize = _size = 0;
+        _written.clear();
+    }
+
+    /*
+     * destroy [b, e) - the (front or back) end of what's in use - leaving
+     * zero bytes; then unmark the blocks with nothing else in use and
+     * decommit what we can
+     */
+    void
+    _clear(T *b, T *e)
+    {
+        _for_each_written( b, e,
+            [](T& t){
+                t.~T();
+                std::memset(static_cast<void*>(&t), 0, sizeof(T));
+            }
+        );
+        T *keep_b = (b == _base) ? e : _base;
+        T *keep_e = (b == _base) ? _base + _size : b;
+        for( size_t i = _block_of(b), last = _block_of(e - 1); i <= last; ++i ){
+            T *bb = _rbase + i * _block_size();
+            T *ee = bb + _block_size();
+            if( ee <= keep_b || bb >= keep_e )
+                _written[i] = false;
+        }
+        vmem::decommit(b, static_cast<size_t>(e - b) * sizeof(T));
+    }
+
+    void
+    _steal(paged_ladder& ladder)
+    {
+        _rbase = ladder._rbase;
+        _rsize = ladder._rsize;
+        _base = ladder._base;
+        _size = ladder._size;
+        _written = std::move(ladder._written);
+        ladder._rbase = ladder._base = nullptr;
+        ladder._rsize = ladder._size = 0;
+        ladder._written.clear();
+    }
+
+public:
+    /* enough to (at least) double in either direction w/o moving */
+    static size_t
+    default_headroom(size_t n)
+    { return std::max(n, MIN_HEADROOM_BYTES / sizeof(T)); }
+
+    explicit paged_ladder(size_t n, size_t headroom = 0)
+        :
+            _rbase( static_cast<T*>(vmem::reserve((n + 2 * headroom)
+                                                  * sizeof(T))) ),
+            _rsize(n + 2 * headroom),
+            _base(_rbase + headroom),
+            _size(n),
+            _written( (_rsize + _block_size() - 1) / _block_size(), false )
+        {
+            static_assert( std::is_default_constructible<T>::value,
+                           "paged_ladder<T> requires a default-constructible T");
+            if( !_default_is_zero() ){
+                vmem::release(_rbase, _rsize * sizeof(T));
+                throw std::logic_error("paged_ladder<T> requires a T() that "
+                                       "is all zero bytes");
+            }
+            vmem::commit(_base, _size * sizeof(T));
+        }
+
+    paged_ladder(paged_ladder&& ladder)
+        { _steal(ladder); }
+
+    paged_ladder&
+    operator=(paged_ladder&& ladder)
+    {
+        if( this != &ladder ){
+            _free();
+            _steal(ladder);
+        }
+        return *this;
+    }
+
+    paged_ladder(const paged_ladder&) = delete;
+    paged_ladder& operator=(const paged_ladder&) = delete;
+
+    ~paged_ladder()
+    { _free(); }
+
+    /* construct the block 'p' is in (if need be); call BEFORE writing to *p */
+    inline void
+    touch(T *p)
+    {
+        assert( p >= _base && p < _base + _size );
+        size_t i = _block_of(p);
+        if( !_written[i] )
+            _construct_block(i);
+    }
+
+    /* move the (constructed) elements of 'ladder' into this, 'offset' in */
+    void
+    move_from(paged_ladder& ladder, size_t offset)
+    {
+        assert( ladder._size + offset <= _size );
+        T *src = ladder._base;
+        T *dest = _base + offset;
+        ladder._for_each_written( src, src + ladder._size,
+            [=](T& t){
+                T *d = dest + (&t - src);
+                touch(d);
+                *d = std::move(t);
+            }
+        );
+    }
+
+    /* extend the back by 'n' (empty) elements IN PLACE, if there's room */
+    bool
+    grow_back(size_t n)
+    {
+        if( n > back_headroom() )
+            return false;
+        vmem::commit(_base + _size, n * sizeof(T));
+        T *b = _base + _size;
+        _size += n;
+        /* the last block could already be written */
+        size_t i = _block_of(b - 1);
+        if( n && _written[i] ){
+            for( T *e = _in_use(i).second; b < e; ++b )
+                ::new(static_cast<void*>(b)) T();
+        }
+        return true;
+    }
+
+    /* extend the front by 'n' (empty) elements IN PLACE, if there's room */
+    bool
+    grow_front(size_t n)
+    {
+        if( n > front_headroom() )
+            return false;
+        vmem::commit(_base - n, n * sizeof(T));
+        T *e = _base;
+        _base -= n;
+        _size += n;
+        /* the first block could already be written */
+        size_t i = _block_of(e);
+        if( n && _written[i] ){
+            for( T *b = _in_use(i).first; b < e; ++b )
+                ::new(static_cast<void*>(b)) T();
+        }
+        return true;
+    }
+
+    /* give 'n' elements at the back back to the headroom */
+    void
+    shrink_back(size_t n)
+    {
+        assert( n < _size );
+        if( n ){
+            _clear(_base + _size - n, _base + _size);
+            _size -= n;
+        }
+    }
+
+    /* give 'n' elements at the front back to the headroom */
+    void
+    shrink_front(size_t n)
+    {
+        assert( n < _size );
+        if( n ){
+            _clear(_base, _base + n);
+            _base += n;
+            _size -= n;
+        }
+    }
+
+    inline size_t
+    front_headroom() const
+    { return static_cast<size_t>(_base - _rbase); }
+
+    inline size_t
+    back_headroom() const
+    { return _rsize - front_headroom() - _size; }
+
+    inline T*
+    begin() const
+    { return _base; }
+
+    inline T*
+    end() const
+    { return _base + _size; }
+
+    inline size_t
+    size() const
+    { return _size; }
+};
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_PAGED_LADDER */
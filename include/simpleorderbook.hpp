@@ -48,6 +48,13 @@ along with this program. If not, see http://www.gnu.org/licenses.
 #include "tick_price.hpp"
 #include "advanced_order.hpp"
 #include "order_paramaters.hpp"
+#include "object_pool.hpp"
+#include "paged_ladder.hpp"
+#include "dispatcher_shard.hpp"
+#include "journal.hpp"
+#include "snapshot.hpp"
+#include "timesales.hpp"
+#include "market_data.hpp"
 
 #ifdef DEBUG
 #undef NDEBUG
@@ -89,6 +96,10 @@ namespace sob {
  *      of a particular std::ratio type:
  *
  *      .create :  allocate and return an orderbook as FullInterface*
+ *      .create_on_shard : same as .create but the orderbook is run by one of
+ *                         the shared dispatcher threads (see StartShards)
+ *      .create_inline : same as .create but orders are executed in the
+ *                       caller's thread (no dispatcher/callback threads)
  *      .destroy : deallocate said object
  *      .is_managed : is the the passed orderbook pointer currently managed
  *      .get_all : get a vector of pointers of all the currently managed orderbooks
@@ -149,6 +160,9 @@ namespace detail {
         template<bool BuyStop> struct stop;
     };
     template<typename T> struct promise_helper;
+
+    /* drives the matching core directly (test/micro); not in the library */
+    struct core_probe;
 };
 
 class SimpleOrderbook {
@@ -176,6 +190,10 @@ public:
         using tick_size_func_type = double(*)();
         using price_to_tick_func_type = double(*)(double);
         using ticks_in_range_func_type = long long(*)(double, double);
+        using create_on_shard_func_type = FullInterface*(*)(double, double, size_t);
+        using create_inline_func_type = FullInterface*(*)(double, double);
+        using tick_memory_required_func_type =
+            unsigned long long(*)(double, double);
 
         const create_func_type create;
         const destroy_func_type destroy;
@@ -185,6 +203,9 @@ public:
         const tick_size_func_type tick_size;
         const price_to_tick_func_type price_to_tick;
         const ticks_in_range_func_type ticks_in_range;
+        const create_on_shard_func_type create_on_shard;
+        const create_inline_func_type create_inline;
+        const tick_memory_required_func_type tick_memory_required;
 
         explicit constexpr FactoryProxy( create_func_type create,
                                          destroy_func_type destroy,
@@ -193,7 +214,11 @@ public:
                                          destroy_all_func_type destroy_all,
                                          tick_size_func_type tick_size,
                                          price_to_tick_func_type price_to_tick,
-                                         ticks_in_range_func_type ticks_in_range )
+                                         ticks_in_range_func_type ticks_in_range,
+                                         create_on_shard_func_type create_on_shard,
+                                         create_inline_func_type create_inline,
+                                         tick_memory_required_func_type
+                                             tick_memory_required )
             :
                 create(create),
                 destroy(destroy),
@@ -202,7 +227,10 @@ public:
                 destroy_all(destroy_all),
                 tick_size(tick_size),
                 price_to_tick(price_to_tick),
-                ticks_in_range(ticks_in_range)
+                ticks_in_range(ticks_in_range),
+                create_on_shard(create_on_shard),
+                create_inline(create_inline),
+                tick_memory_required(tick_memory_required)
             {
             }
     };
@@ -222,7 +250,10 @@ public:
                 ImplTy::destroy_all,
                 ImplTy::tick_size_,
                 ImplTy::price_to_tick_,
-                ImplTy::ticks_in_range_
+                ImplTy::ticks_in_range_,
+                ImplTy::create_on_shard,
+                ImplTy::create_inline,
+                ImplTy::tick_memory_required_
                 );
     }
 
@@ -242,6 +273,42 @@ public:
     IsManaged(FullInterface *interface)
     { return master_rmanager.is_managed(interface); }
 
+    /*
+     * shared dispatcher threads ('shards'), optionally pinned to a core each;
+     * orderbooks created w/ FactoryProxy::create_on_shard don't get a
+     * dispatcher thread of their own, they're run by shard #n (of 'nshards',
+     * one per core if 0). StopShards throws if any of those still exist.
+     */
+    static inline void
+    StartShards(size_t nshards = 0, bool pin_cores = true)
+    { detail::shards::start(nshards, pin_cores); }
+
+    static inline void
+    StopShards()
+    { detail::shards::stop(); }
+
+    static inline size_t
+    ShardCount()
+    { return detail::shards::count(); }
+
+    /*
+     * shared pool of async callback threads ('nthreads', one per core if 0);
+     * orderbooks created while it's up run their async callbacks on it (in
+     * order, per book) instead of a callback thread of their own.
+     * StopCallbackPool throws if any of those still exist.
+     */
+    static inline void
+    StartCallbackPool(size_t nthreads = 0)
+    { detail::callback_pool::start(nthreads); }
+
+    static inline void
+    StopCallbackPool()
+    { detail::callback_pool::stop(); }
+
+    static inline size_t
+    CallbackPoolSize()
+    { return detail::callback_pool::nthreads(); }
+
     friend struct detail::sob_types;
 
 
@@ -251,7 +318,8 @@ private:
      * header definitions we need to include for derived template class.
      */
     class SimpleOrderbookBase
-        : public ManagementInterface{
+        : public ManagementInterface,
+          private detail::shard_client{
     protected:
 
         struct order_exec_cb_bndl{
@@ -308,11 +376,20 @@ private:
                 std::promise<std::pair<id_type, callback_queue_type>>&& promise
                 );
 
+            /* w/o a promise, for inline execution */
+            external_order_queue_elem( ORDER_QUEUE_ELEM_BASE_ARGS,
+                                       const AdvancedOrderTicket& aot );
+
             external_order_queue_elem();
 
             external_order_queue_elem&
             operator=( external_order_queue_elem&& elem );
 
+            bool has_promise;
+#ifndef SOB_NO_LATENCY_STATS
+            uint64_t t_queued = 0; /* latency_clock, if it was timed */
+#endif
+
             ~external_order_queue_elem();
         };
 
@@ -321,16 +398,16 @@ private:
                 : public order_queue_elem_base_{
             order_condition condition;
             condition_trigger trigger;
-            std::unique_ptr<OrderParamaters> cparams1;
-            std::unique_ptr<OrderParamaters> cparams2;
+            OrderParamatersStorage cparams1;
+            OrderParamatersStorage cparams2;
             id_type parent_id;
 
             order_queue_elem(
                 ORDER_QUEUE_ELEM_BASE_ARGS,
                 order_condition condition = order_condition::none,
                 condition_trigger trigger = condition_trigger::none,
-                std::unique_ptr<OrderParamaters>&& cparams1 = nullptr,
-                std::unique_ptr<OrderParamaters>&& cparams2 = nullptr,
+                const OrderParamatersStorage& cparams1 = nullptr,
+                const OrderParamatersStorage& cparams2 = nullptr,
                 id_type parent_id = 0
                 );
 
@@ -340,8 +417,8 @@ private:
                 id_type id,
                 order_condition condition = order_condition::none,
                 condition_trigger trigger = condition_trigger::none,
-                std::unique_ptr<OrderParamaters>&& cparams1 = nullptr,
-                std::unique_ptr<OrderParamaters>&& cparams2 = nullptr,
+                const OrderParamatersStorage& cparams1 = nullptr,
+                const OrderParamatersStorage& cparams2 = nullptr,
                 id_type parent_id = 0
                 );
 
@@ -353,21 +430,22 @@ private:
 
 
         struct order_link;
-        struct trailing_order_link;
+        using order_link_pool_type = detail::object_pool<order_link>;
 
         template<typename T>
         struct bracket_type{
             using order_paramaters_type = T;
+            using pool_type = detail::object_pool<bracket_type>;
             T first;
             T second;
             id_type active1, active2;
 
             static bracket_type*
-            New(const OrderParamaters& p1, const OrderParamaters& p2)
-            { return new bracket_type<T>{
-                reinterpret_cast<const T&>(p1),
-                reinterpret_cast<const T&>(p2),
-                0, 0 }; }
+            New(pool_type& pool, const OrderParamaters& p1,
+                const OrderParamaters& p2)
+            { return pool.acquire( reinterpret_cast<const T&>(p1),
+                                   reinterpret_cast<const T&>(p2),
+                                   id_type(0), id_type(0) ); }
         };
         using price_bracket_type = bracket_type<OrderParamatersByPrice>;
         using nticks_bracket_type = bracket_type<OrderParamatersByNTicks>;
@@ -375,19 +453,34 @@ private:
         template<typename T>
         struct contingent_order_type{
             using order_paramaters_type = T;
+            using pool_type = detail::object_pool<contingent_order_type>;
             T params;
             id_type active;
 
             static contingent_order_type*
-            New(const OrderParamaters& p1)
-            { return new contingent_order_type<T>{
-                reinterpret_cast<const T&>(p1), 0 }; }
+            New(pool_type& pool, const OrderParamaters& p1)
+            { return pool.acquire( reinterpret_cast<const T&>(p1), id_type(0) ); }
         };
         using contingent_price_order_type =
                 contingent_order_type<OrderParamatersByPrice>;
         using contingent_nticks_order_type =
                 contingent_order_type<OrderParamatersByNTicks>;
 
+        /*
+         * iceberg state lives inline in the bndl; 'sz' is what's displayed,
+         * 'reserve' is what's left to replenish from (in 'display' lots)
+         */
+        struct iceberg_type {
+            size_t display;
+            size_t reserve;
+        };
+
+        /* pegged state; 'limit' is the (price) cap the order was sent with */
+        struct pegged_type {
+            size_t nticks;
+            double limit;
+        };
+
 
         /*
          * base representation of orders internally (inside chains)
@@ -410,6 +503,8 @@ private:
                 price_bracket_type *price_bracket_orders;
                 nticks_bracket_type *nticks_bracket_orders;
                 size_t nticks;
+                iceberg_type iceberg;
+                pegged_type pegged;
             };
             operator bool() const { return sz; }
             _order_bndl();
@@ -466,20 +561,25 @@ private:
         };
 
 
-        /* one order to (quickly) find another */
+        /*
+         * one order to (quickly) find another
+         *
+         * (trailing brackets also need the nticks of the stop; tagged
+         *  rather than polymorphic so it can live in a pool)
+         */
         struct order_link{
+            enum class type : char { basic, trailing };
             id_type id;
             bool is_primary;
-            order_link(id_type id, bool is_primary)
-                : id(id), is_primary(is_primary) {}
-            virtual ~order_link(){}
-        };
-
-        struct trailing_order_link
-                : public order_link {
+            type ltype;
             size_t nticks;
-            trailing_order_link(id_type id, bool is_primary, size_t nticks)
-                : order_link(id, is_primary), nticks(nticks) {}
+            order_link(id_type id, bool is_primary)
+                : id(id), is_primary(is_primary), ltype(type::basic),
+                  nticks(0) {}
+            order_link(id_type id, bool is_primary, size_t nticks)
+                : id(id), is_primary(is_primary), ltype(type::trailing),
+                  nticks(nticks) {}
+            bool is_trailing() const { return ltype == type::trailing; }
         };
 
         /* info held for each exec callback in the deferred callback vector*/
@@ -490,6 +590,9 @@ private:
             id_type id2;
             double price;
             size_t sz;
+#ifndef SOB_NO_LATENCY_STATS
+            uint64_t t_pushed = 0; /* latency_clock, if it was timed */
+#endif
             dfrd_cb_elem(callback_msg msg, const order_exec_cb_type& exec_cb,
                          id_type id1, id_type id2, double price, size_t sz)
                 : msg(msg), exec_cb(exec_cb), id1(id1), id2(id2),
@@ -528,6 +631,10 @@ private:
             void
             erase( typename T::iterator iter );
 
+            /* move a node from (the same or) another chain to the back */
+            void
+            splice( chain_manager& from, typename T::iterator iter );
+
             void
             free(){ _chain.reset(); }
 
@@ -567,6 +674,8 @@ private:
             chain_manager<stop_chain_type> stops;
             chain_manager<aon_chain_type> aon_buys;
             chain_manager<aon_chain_type> aon_sells;
+            /* needs to be re-published to depth subscribers */
+            bool dirty = false;
 
             level() = default;
             level( const level& ) = delete;
@@ -585,12 +694,29 @@ private:
                              std::function<double(plevel)> itop,
                              std::function<plevel(double)> ptoi,
                              std::function<long long(double, double)> ticks_in_range,
-                             std::function<bool(double)> is_valid_price
+                             std::function<bool(double)> is_valid_price,
+                             std::function<bool(double)> auto_grow,
+                             std::function<bool(plevel, plevel)> shrink_book,
+                             detail::dispatcher_shard *shard,
+                             bool inline_exec
                              );
         ~SimpleOrderbookBase();
 
-         /* THE ORDER BOOK */
-        std::vector<level> _book;
+        /*
+         * per-book pools for the objects advanced order bndls point at
+         * (MUST be declared before _book so they outlive it)
+         */
+        order_link_pool_type _link_pool;
+        price_bracket_type::pool_type _price_bracket_pool;
+        nticks_bracket_type::pool_type _nticks_bracket_pool;
+        contingent_price_order_type::pool_type _contingent_price_pool;
+        contingent_nticks_order_type::pool_type _contingent_nticks_pool;
+
+        /*
+         * THE ORDER BOOK (every tick, reserved up front; pages are only
+         * backed by memory once orders rest on them)
+         */
+        detail::paged_ladder<level> _book;
 
         /* cached internal pointers(iterators) of the orderbook */
         plevel _beg;
@@ -675,12 +801,114 @@ private:
         std::set<id_type> _trailing_sell_stops;
         std::set<id_type> _trailing_buy_stops;
 
+        /* pegged orders and the (price) state they were last pegged to */
+        std::set<id_type> _pegged_orders;
+        std::tuple<double, double, double, double> _peg_inside;
+
         unsigned long long _total_volume;
         id_type _last_id;
         size_t _last_size;
 
-        /* time & sales */
-        std::vector<timesale_entry_type> _timesales;
+        /*
+         * time & sales; written by the dispatcher (under _master_mtx),
+         * readers std::atomic_load() it and don't lock
+         */
+        std::shared_ptr<detail::timesales_ring> _timesales;
+
+        /*
+         * book deltas (start_book_deltas); the ring is like _timesales.
+         * What an external order does to the book builds up in
+         * _pending_deltas (w/ the levels it touched) and is published as
+         * one batch, L2 changes last, when it's done (_flush_book_deltas);
+         * _published_* are the level sizes readers were last sent
+         */
+        std::shared_ptr<detail::book_delta_ring> _deltas;
+        std::vector<book_delta> _pending_deltas;
+        std::vector<std::pair<double, bool>> _touched_levels;
+        std::map<double, size_t> _published_bids;
+        std::map<double, size_t> _published_asks;
+        unsigned long long _delta_batch;
+
+        /*
+         * conflated depth subscriptions (subscribe_depth); the matching path
+         * only marks levels dirty (level::dirty, and its price goes on
+         * _dirty_levels), the publisher thread collects them - under
+         * _master_mtx, once per interval - into _depth_state and each
+         * subscriber's 'pending' update. _depth_subs and the publisher
+         * state are PROTECTED by _depth_sub_mtx (taken AFTER _master_mtx).
+         * Callbacks are made with NEITHER held; _depth_in_cb is the id
+         * (ids are never reused) of the one being called back, if any, so
+         * unsubscribe_depth() can wait it out
+         */
+        struct depth_subscriber{
+            depth_cb_type cb;
+            std::chrono::steady_clock::duration interval;
+            std::chrono::steady_clock::time_point next;
+            depth_update_type pending;
+        };
+
+        bool _depth_dirty_on;
+        std::vector<double> _dirty_levels;
+        depth_update_type _depth_state;
+        std::map<unsigned long long, depth_subscriber> _depth_subs;
+        unsigned long long _last_depth_sub_id;
+        std::mutex _depth_sub_mtx;
+        std::condition_variable _depth_sub_cond;
+        bool _depth_publisher_run;
+        std::thread _depth_publisher_thread;
+        unsigned long long _depth_in_cb;
+        std::condition_variable _depth_cb_done_cond;
+
+        /*
+         * per-stage latency stats (set_latency_stats), a histogram per
+         * latency_stage; allocated the first time they're turned on and
+         * kept until we go, so the order path only checks _latency_on
+         */
+        std::unique_ptr<detail::latency_histogram[]> _latency;
+        std::atomic<bool> _latency_on;
+
+        /*
+         * engine counters (stats()); each is only written under the lock
+         * noted, by one thread at a time, so they're relaxed atomics bumped
+         * w/ load/store (no read-modify-write) and read w/o a lock
+         */
+        struct engine_counters{
+            using counter = std::atomic<unsigned long long>;
+            /* _external_order_queue_mtx */
+            counter external_queue_hwm;
+            /* _async_callback_mtx */
+            counter async_callback_hwm;
+            /* _master_mtx */
+            counter orders_external;
+            counter orders_internal;
+            counter cascades;
+            counter cascade_max;
+            counter internal_queue_hwm;
+            counter trades;
+            counter matches;
+            counter levels_scanned;
+            counter levels_scanned_max;
+            counter lock_acquisitions;
+            counter lock_contended;
+            counter lock_wait_ns;
+            counter lock_wait_max_ns;
+
+            engine_counters();
+
+            static inline void
+            add(counter& c, unsigned long long n = 1)
+            {
+                c.store( c.load(std::memory_order_relaxed) + n,
+                         std::memory_order_relaxed );
+            }
+
+            static inline void
+            raise(counter& c, unsigned long long v)
+            {
+                if( v > c.load(std::memory_order_relaxed) )
+                    c.store(v, std::memory_order_relaxed);
+            }
+        } _counters;
 
         /* synchronous(manual) callbacks */
         callback_queue_type _callbacks_sync;
@@ -693,6 +921,19 @@ private:
         std::condition_variable _async_callback_done_cond;
         volatile bool _async_callbacks_done;
 
+        /* OR the shared pool runs them (if it was up when we were created) */
+        class AsyncCallbackClient
+                : public detail::shard_client{
+            SimpleOrderbookBase *_sob;
+        public:
+            AsyncCallbackClient(SimpleOrderbookBase *sob) : _sob(sob) {}
+            bool run_queued(size_t max);
+        };
+
+        detail::client_runner *_callback_pool;
+        AsyncCallbackClient _async_cb_client;
+        bool _async_cb_scheduled; /* PROTECTED by _async_callback_mtx */
+
         class AsyncCallbackThreadGuard {
             SimpleOrderbookBase *_sob;
             std::thread _t;
@@ -720,10 +961,39 @@ private:
         /* async order queu thread */
         std::thread _order_dispatcher_thread;
 
+        /* OR a shared dispatcher thread (and our own async callback thread) */
+        detail::dispatcher_shard *_shard;
+        /* OR neither; orders execute in the caller's thread */
+        const bool _inline;
+        bool _shard_scheduled; /* PROTECTED by _external_order_queue_mtx */
+        std::unique_ptr<AsyncCallbackThreadGuard> _shard_async_cb_thread;
+
         std::function<double(plevel)> _itop;
         std::function<plevel(double)> _ptoi;
         std::function<long long(double, double)> _ticks_in_range;
         std::function<bool(double)> _is_valid_price;
+        /* grow the book to (at least) include price, if policy allows */
+        std::function<bool(double)> _auto_grow;
+
+        /* shrink the book to [new_beg, new_end), if nothing is out there */
+        std::function<bool(plevel, plevel)> _shrink_book;
+
+        /* auto-grow policy (set_auto_grow) */
+        double _auto_grow_factor;
+        size_t _auto_grow_max_ticks;
+        book_growth_cb_type _growth_cb;
+
+        /* recenter policy (set_auto_recenter) */
+        static const size_t RECENTER_BACKOFF = 1024; // orders, after a fail
+        size_t _recenter_margin;
+        size_t _recenter_backoff;
+
+        /* write-ahead journal (start_journal), PROTECTED by _master_mtx */
+        std::shared_ptr<detail::journal_writer> _journal;
+
+        inline void
+        _journal_append(const detail::journal_record& rec)
+        { if( _journal ) _journal->append(rec); }
 
         friend struct detail::sob_types;
 
@@ -812,19 +1082,41 @@ private:
          */
         template<typename T> friend struct detail::promise_helper;
 
+        /*
+         * test friend for the matching-core microbenchmarks (test/micro)
+         * that call _trade, _hit_chain etc. on pre-built book states
+         */
+        friend struct detail::core_probe;
+
 
         /* handles the async/consumer side of the order queue */
         void
         _threaded_order_dispatcher();
 
+        /* handles the consumer side of the order queue for our shard */
+        bool
+        run_queued(size_t max);
+
         template<typename T>
         void
         _dispatch_external_order( const external_order_queue_elem& ee,
                                   std::promise<T>&& promise );
 
+        /* the rest of the book deltas it generates get published */
         id_type
         _execute_external_order(const external_order_queue_elem& e);
 
+        id_type
+        _do_execute_external_order(const external_order_queue_elem& e);
+
+        /* grow the book for any out-of-range prices (BEFORE we build) */
+        void
+        _auto_grow_for(const external_order_queue_elem& e);
+
+        /* shrink the book if a side is too far from the market (AFTER) */
+        void
+        _auto_recenter();
+
         /* all order types go through here */
         void
         _insert_order(order_queue_elem& e);
@@ -967,6 +1259,12 @@ private:
         void
         _insert_ALL_OR_NONE_order(const order_queue_elem& e);
 
+        void
+        _insert_ICEBERG_order(const order_queue_elem& e);
+
+        void
+        _insert_PEGGED_order(const order_queue_elem& e);
+
         /* internal insert orders once/if we have an id */
         template<bool BuyLimit>
         size_t
@@ -977,6 +1275,10 @@ private:
         void
         _insert_market_order(const order_queue_elem& e);
 
+        template<bool BuyLimit>
+        size_t
+        _insert_immediate_order(const order_queue_elem& e, bool allow_partial);
+
         template<bool BuyStop>
         void
         _insert_stop_order( const order_queue_elem& e,
@@ -997,6 +1299,9 @@ private:
         void
         _threaded_async_callback_executor();
 
+        bool
+        _run_async_callbacks(size_t max);
+
         void
         _notify_async_callbacks_done();
 
@@ -1031,6 +1336,39 @@ private:
         _trailing_limit_plevel(bool buy_limit, size_t nticks) const
         { return _plevel_offset<false>(buy_limit, nticks, _last); }
 
+        /* re-price pegged orders if the inside moved */
+        void
+        _adjust_pegged_orders();
+
+        void
+        _reprice_pegged_order(id_type id, bool is_buy, plevel p);
+
+        template<bool BidSide>
+        plevel
+        _peg_reference() const;
+
+        plevel
+        _peg_plevel( bool buy,
+                     order_condition condition,
+                     size_t nticks,
+                     double limit,
+                     plevel bid_ref,
+                     plevel ask_ref ) const;
+
+        std::tuple<double, double, double, double>
+        _peg_inside_now(plevel bid_ref, plevel ask_ref) const;
+
+        /* execute order in the caller's thread (inline books only) */
+        id_type
+        _execute_inline( order_type oty,
+                         bool buy,
+                         double limit,
+                         double stop,
+                         size_t size,
+                         const order_exec_cb_bndl& cb,
+                         const AdvancedOrderTicket& aot,
+                         id_type id );
+
         /* push order onto the external queue, BLOCK */
         id_type
         _push_external_order_sync( order_type oty,
@@ -1079,8 +1417,8 @@ private:
                             order_condition condition = order_condition::none,
                             condition_trigger cond_trigger
                                 = condition_trigger::fill_partial,
-                            std::unique_ptr<OrderParamaters>&& cparams1=nullptr,
-                            std::unique_ptr<OrderParamaters>&& cparams2=nullptr,
+                            const OrderParamatersStorage& cparams1 = nullptr,
+                            const OrderParamatersStorage& cparams2 = nullptr,
                             id_type id = 0,
                             id_type parent_id = 0 );
 
@@ -1098,6 +1436,10 @@ private:
         bool
         _pull_order(id_type id, bool pull_linked);
 
+        /* amend a resting limit order in place (price of 0 keeps price) */
+        bool
+        _modify_order(id_type id, size_t sz, double price);
+
         /* pull OCO (linked) order */
         template<typename ChainTy>
         void
@@ -1151,6 +1493,120 @@ private:
                                  plevel new_end,
                                  long long addr_offset);
 
+        /* called from shrink book to release [_beg, new_beg), [new_end, _end) */
+        bool
+        _release_levels(plevel new_beg, plevel new_end);
+
+        /* (see snapshot.cpp) */
+        void
+        _write_bndl(detail::binary_ostream& out, const _order_bndl& bndl) const;
+
+        void
+        _read_bndl(detail::binary_istream& in, _order_bndl& bndl);
+
+        /* bulk-load the body of a snapshot into a (new, resized) book */
+        size_t
+        _restore_snapshot(detail::binary_istream& in);
+
+        /*
+         * book deltas (see market_data.cpp): a limit order at 'p' was
+         * added/modified/executed/deleted; 'sz' is its new size (or what
+         * was executed); AON orders aren't visible and are ignored
+         */
+        inline void
+        _book_delta(book_delta::type t,
+                    plevel p,
+                    bool is_buy,
+                    const _order_bndl& bndl,
+                    size_t sz)
+        {
+            if( _depth_dirty_on )
+                _mark_depth_dirty(p);
+            if( _deltas )
+                _push_book_delta(t, p, is_buy, bndl, sz);
+        }
+
+        /* a resting order's size was changed in place (order_modify) */
+        void
+        _book_delta_resize(const chain_iter_wrap& iwrap);
+
+        void
+        _push_book_delta(book_delta::type t,
+                         plevel p,
+                         bool is_buy,
+                         const _order_bndl& bndl,
+                         size_t sz);
+
+        /* add the L2 changes and publish everything pending as a batch */
+        void
+        _flush_book_deltas();
+
+        /* order_add for every visible order (and flush) */
+        void
+        _seed_book_deltas();
+
+        /* take _master_mtx for the order path, counting any wait for it */
+        inline void
+        _lock_master_for_order()
+        {
+            if( !_master_mtx.try_lock() ){
+                auto t = std::chrono::steady_clock::now();
+                _master_mtx.lock();
+                unsigned long long ns = std::chrono::duration_cast<
+                    std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t ).count();
+                engine_counters::add(_counters.lock_contended);
+                engine_counters::add(_counters.lock_wait_ns, ns);
+                engine_counters::raise(_counters.lock_wait_max_ns, ns);
+            }
+            engine_counters::add(_counters.lock_acquisitions);
+        }
+
+        /* call BEFORE the first write to a level (see paged_ladder.hpp) */
+        inline void
+        _touch(plevel p)
+        { _book.touch(p); }
+
+        /* latency stats (see latency.cpp); 0 if they're off */
+        inline uint64_t
+        _latency_now() const
+        {
+#ifndef SOB_NO_LATENCY_STATS
+            if( _latency_on.load(std::memory_order_acquire) )
+                return detail::latency_clock::now();
+#endif
+            return 0;
+        }
+
+        /* the caller checks 'from' is non-zero (it was timed) */
+        inline void
+        _record_latency(latency_stage s, uint64_t from, uint64_t to)
+        { _latency[static_cast<size_t>(s)].record(to - from); }
+
+        /* conflated depth (see market_data.cpp) */
+        inline void
+        _mark_depth_dirty(plevel p)
+        {
+            if( !p->dirty ){
+                _touch(p);
+                p->dirty = true;
+                _dirty_levels.push_back( _itop(p) );
+            }
+        }
+
+        void
+        _mark_depth_dirty_all();
+
+        /* _dirty_levels -> _depth_state, subscribers (w/ both locks) */
+        void
+        _collect_depth_changes();
+
+        void
+        _depth_publisher();
+
+        void
+        _stop_depth_publisher();
+
 
         /* convert to valid tick price (throw invalid_argument if bad input) */
         double
@@ -1170,16 +1626,15 @@ private:
 
         /* check/build internal param object from user input for advanced
         * order types (uses _tick_price_or_throw to check user input) */
-        std::unique_ptr<OrderParamaters>
+        OrderParamatersStorage
         _build_nticks_params(bool buy,
                           size_t size,
                           const OrderParamaters *order) const;
 
-        std::unique_ptr<OrderParamaters>
+        OrderParamatersStorage
         _build_price_params(size_t size, const OrderParamaters *order) const;
 
-        std::pair<std::unique_ptr<OrderParamaters>,
-               std::unique_ptr<OrderParamaters>>
+        std::pair<OrderParamatersStorage, OrderParamatersStorage>
         _build_advanced_params(bool buy,
                                size_t size,
                                const AdvancedOrderTicket& advanced) const;
@@ -1188,7 +1643,7 @@ private:
         void
         _check_limit_order(bool buy,
                         double limit,
-                        std::unique_ptr<OrderParamaters> & op,
+                        const OrderParamatersStorage& op,
                         order_condition oc) const;
 
         /* check prices levels for trailing-stop/bracket orders are valid */
@@ -1232,6 +1687,31 @@ private:
                                  const AdvancedOrderTicket& advanced
                                      = AdvancedOrderTicket::null);
 
+        id_type
+        insert_fill_or_kill_order(bool buy,
+                                  double limit,
+                                  size_t size,
+                                  order_exec_cb_type exec_cb = nullptr);
+
+        std::future<id_type>
+        insert_fill_or_kill_order_async(bool buy,
+                                        double limit,
+                                        size_t size,
+                                        order_exec_cb_type exec_cb = nullptr);
+
+        id_type
+        insert_immediate_or_cancel_order(bool buy,
+                                         double limit,
+                                         size_t size,
+                                         order_exec_cb_type exec_cb = nullptr);
+
+        std::future<id_type>
+        insert_immediate_or_cancel_order_async(bool buy,
+                                               double limit,
+                                               size_t size,
+                                               order_exec_cb_type exec_cb
+                                                   = nullptr);
+
         id_type
         insert_market_order(bool buy,
                            size_t size,
@@ -1289,6 +1769,12 @@ private:
         std::future<id_type> // 1 = true, 0 = false
         pull_order_async(id_type id);
 
+        bool
+        modify_order(id_type id, size_t new_size, double new_price = 0);
+
+        std::future<id_type> // 1 = true, 0 = false
+        modify_order_async(id_type id, size_t new_size, double new_price = 0);
+
         id_type
         replace_with_limit_order(id_type id,
                                 bool buy,
@@ -1373,6 +1859,53 @@ private:
         void
         dump_internal_pointers(std::ostream& out = std::cout) const;
 
+        void
+        set_auto_grow(double factor,
+                      size_t max_ticks = 0,
+                      book_growth_cb_type growth_cb = nullptr);
+
+        void
+        set_auto_recenter(size_t margin);
+
+        void
+        start_journal(const std::string& path, unsigned commit_ms = 5);
+
+        void
+        stop_journal();
+
+        void
+        sync_journal();
+
+        size_t
+        snapshot(std::ostream& out) const;
+
+        void
+        set_time_and_sales(size_t capacity, const std::string& mmap_path = "");
+
+        void
+        start_book_deltas(size_t capacity = 1 << 16);
+
+        void
+        stop_book_deltas();
+
+        unsigned long long
+        subscribe_depth(depth_cb_type cb, unsigned interval_ms = 10);
+
+        bool
+        unsubscribe_depth(unsigned long long id);
+
+        void
+        set_latency_stats(bool on);
+
+        std::map<latency_stage, latency_summary>
+        latency_stats() const;
+
+        void
+        dump_latency_stats(std::ostream& out = std::cout) const;
+
+        engine_stats
+        stats() const;
+
         void
         dump_limits(std::ostream& out = std::cout) const
         { _dump_orders<side_of_trade::both, limit_chain_type>(out); }
@@ -1482,9 +2015,24 @@ private:
         id_type
         last_id() const;
 
-        const std::vector<timesale_entry_type>&
+        std::vector<timesale_entry_type>
         time_and_sales() const;
 
+        unsigned long long
+        read_trades_since(unsigned long long seq,
+                          std::vector<timesale_entry_type>& buf) const;
+
+        double
+        vwap(clock_type::time_point from, clock_type::time_point to) const;
+
+        std::map<double, unsigned long long>
+        volume_profile(clock_type::time_point from,
+                       clock_type::time_point to) const;
+
+        unsigned long long
+        read_book_deltas(unsigned long long seq,
+                         std::vector<book_delta>& buf) const;
+
     };
 
     /* (non-inline) definitions in tpp/orderbook/impl.tpp */
@@ -1499,7 +2047,10 @@ private:
         SimpleOrderbookImpl& operator=(const SimpleOrderbookImpl& sob) = delete;
         SimpleOrderbookImpl& operator=(SimpleOrderbookImpl&& sob) = delete;
 
-        SimpleOrderbookImpl( TickPrice<TickRatio> min, size_t incr );
+        SimpleOrderbookImpl( TickPrice<TickRatio> min,
+                             size_t incr,
+                             detail::dispatcher_shard *shard,
+                             bool inline_exec );
         ~SimpleOrderbookImpl() {}
 
         /* lowest price */
@@ -1519,6 +2070,14 @@ private:
         void /* NOT THREAD-SAFE */
         _grow_book(TickPrice<TickRatio> min, size_t incr, bool at_beg);
 
+        /* apply the auto-grow policy for an out-of-range price */
+        bool /* NOT THREAD-SAFE */
+        _auto_grow(double price);
+
+        /* release levels outside [new_beg, new_end) if they're empty */
+        bool /* NOT THREAD-SAFE */
+        _shrink_book(plevel new_beg, plevel new_end);
+
     public:
         void
         grow_book_above(double new_max);
@@ -1526,6 +2085,15 @@ private:
         void
         grow_book_below(double new_min);
 
+        bool
+        shrink_book(double new_min, double new_max);
+
+        size_t
+        replay_journal(const std::string& path);
+
+        size_t
+        restore(std::istream& in);
+
         double
         tick_size() const
         { return tick_size_(); }
@@ -1549,7 +2117,20 @@ private:
         { return create( TickPrice<TickRatio>(min), TickPrice<TickRatio>(max) ); }
 
         static FullInterface*
-        create( TickPrice<TickRatio> min, TickPrice<TickRatio> max );
+        create( TickPrice<TickRatio> min,
+                TickPrice<TickRatio> max,
+                detail::dispatcher_shard *shard = nullptr,
+                bool inline_exec = false );
+
+        static FullInterface*
+        create_on_shard(double min, double max, size_t shard)
+        { return create( TickPrice<TickRatio>(min), TickPrice<TickRatio>(max),
+                         detail::shards::get(shard) ); }
+
+        static FullInterface*
+        create_inline(double min, double max)
+        { return create( TickPrice<TickRatio>(min), TickPrice<TickRatio>(max),
+                         nullptr, true ); }
 
         static void
         destroy(FullInterface *interface)
@@ -1580,6 +2161,18 @@ private:
         { return ( TickPrice<TickRatio>(upper)
                  - TickPrice<TickRatio>(lower) ).as_ticks(); }
 
+        /*
+         * the (committed) ladder of levels a book over [lower, upper] is
+         * created with - one per tick plus the pad, min of 0 bumped a tick
+         * like create() does; pages are only backed once orders rest on
+         * them and NONE of the order/chain memory is counted
+         */
+        static constexpr unsigned long long
+        tick_memory_required_(double lower, double upper)
+        { return static_cast<unsigned long long>(
+                     ticks_in_range_(lower > 0 ? lower : tick_size_(), upper) + 2
+                 ) * sizeof(level); }
+
     }; /* SimpleOrderbookImpl */
 
     class ImplDeleter{
@@ -0,0 +1,136 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_SOB_SNAPSHOT
+#define JO_SOB_SNAPSHOT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+namespace sob{
+
+namespace detail{
+
+/*
+ * point-in-time (binary) snapshot of a book
+ *
+ *   header : "SOBS" | u32 version | f64 tick_size | f64 min | f64 max
+ *   body   : totals, cached pointers, id sets, then every level w/ orders
+ *            and its chains in (FIFO) order - see snapshot.cpp
+ *
+ * native byte order, like the journal
+ */
+struct snapshot_header{
+    static const uint32_t VERSION = 1;
+    double tick_size;
+    double min_price;
+    double max_price;
+};
+
+
+/* buffers writes to 'out' (in big chunks) */
+class binary_ostream{
+    std::ostream& _out;
+    std::vector<char> _buf;
+
+    static const size_t CHUNK_BYTES = 1 << 20;
+
+public:
+    explicit binary_ostream(std::ostream& out)
+        : _out(out), _buf()
+        { _buf.reserve(CHUNK_BYTES); }
+
+    ~binary_ostream()
+        { flush(); }
+
+    template<typename T>
+    inline void
+    put(T v)
+    {
+        const char *p = reinterpret_cast<const char*>(&v);
+        _buf.insert(_buf.end(), p, p + sizeof(T));
+        if( _buf.size() >= CHUNK_BYTES )
+            flush();
+    }
+
+    void
+    flush()
+    {
+        if( !_buf.empty() ){
+            _out.write(_buf.data(), _buf.size());
+            _buf.clear();
+        }
+    }
+};
+
+
+/* reads 'in' (in big chunks); throws std::runtime_error if it runs out */
+class binary_istream{
+    std::istream& _in;
+    std::vector<char> _buf;
+    size_t _pos;
+    size_t _len;
+
+    static const size_t CHUNK_BYTES = 1 << 20;
+
+    void
+    _fill(size_t need)
+    {
+        size_t left = _len - _pos;
+        std::memmove(_buf.data(), _buf.data() + _pos, left);
+        _in.read(_buf.data() + left, _buf.size() - left);
+        _len = left + static_cast<size_t>(_in.gcount());
+        _pos = 0;
+        if( _len < need )
+            throw std::runtime_error("snapshot truncated");
+    }
+
+public:
+    explicit binary_istream(std::istream& in)
+        : _in(in), _buf(CHUNK_BYTES), _pos(0), _len(0)
+        {}
+
+    template<typename T>
+    inline T
+    get()
+    {
+        if( _len - _pos < sizeof(T) )
+            _fill(sizeof(T));
+        T v;
+        std::memcpy(&v, _buf.data() + _pos, sizeof(T));
+        _pos += sizeof(T);
+        return v;
+    }
+};
+
+
+void
+write_snapshot_header(binary_ostream& out, const snapshot_header& header);
+
+/* throws std::runtime_error if 'in' isn't a snapshot */
+snapshot_header
+read_snapshot_header(binary_istream& in);
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_SNAPSHOT */
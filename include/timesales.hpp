@@ -0,0 +1,155 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_SOB_TIMESALES
+#define JO_SOB_TIMESALES
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+namespace sob{
+
+namespace detail{
+
+/*
+ * fixed-capacity time & sales ring, stored by column
+ *
+ *   * one writer (the dispatcher, under the master lock) and any number of
+ *     readers that DON'T take a lock: trades are numbered (sequence #s
+ *     from 0) and read_since() copies out everything from a cursor on
+ *   * the oldest trades are overwritten once it's full; a reader that
+ *     falls behind skips ahead (seqlock-style: 'claimed' is bumped before
+ *     a trade is written, 'head' after, so a reader can tell what it read
+ *     might have been overwritten underneath it and drop/redo it)
+ *   * times, prices and sizes are separate (contiguous) columns so the
+ *     windowed aggregates - vwap(), volume_profile() - run straight over
+ *     the ring (w/ SIMD where we have it) instead of copying trades out
+ *   * backed by reserved (lazily committed) memory or, w/ a 'path', by a
+ *     memory-mapped file other processes can read:
+ *
+ *       "SOBT" | u32 version | u64 capacity | u64 first | u64 claimed |
+ *       u64 head | (pad to 64) | i64 times[capacity] | f64 prices[capacity]
+ *       | u64 sizes[capacity]
+ *
+ *     ('first' is the sequence # the ring started at; times are clock_type
+ *      ticks; trade 'seq' is at index seq % capacity)
+ */
+class timesales_ring{
+    struct header{
+        char magic[4];
+        uint32_t version;
+        uint64_t capacity;
+        uint64_t first;
+        std::atomic<uint64_t> claimed;
+        std::atomic<uint64_t> head;
+    };
+
+    static const uint32_t VERSION = 1;
+
+    void *_mem;
+    size_t _bytes;
+    bool _mapped;
+    /* all-zero bytes is a valid header; nothing is constructed */
+    header *_hdr;
+    /*
+     * columns are plain (not atomic) so the reductions vectorize; readers
+     * only trust what they read once 'claimed' says it wasn't overwritten
+     */
+    int64_t *_times;
+    double *_prices;
+    uint64_t *_sizes;
+    uint64_t _mask;
+
+    /* call 'func(first_index, n)' on the (<= 2) runs of trades w/ times in
+       [from, to]; func.reset() and redo it (a bounded # of times, skipping
+       the oldest trades) if the writer overwrites what we read */
+    template<typename F>
+    void
+    _for_window(int64_t from, int64_t to, F& func) const;
+
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+    /* 'capacity' is rounded up to a power of 2; sequence #s start at 'seq' */
+    explicit timesales_ring( size_t capacity = DEFAULT_CAPACITY,
+                             const std::string& path = "",
+                             uint64_t seq = 0 );
+    ~timesales_ring();
+
+    timesales_ring(const timesales_ring&) = delete;
+    timesales_ring& operator=(const timesales_ring&) = delete;
+
+    static size_t
+    rounded_capacity(size_t capacity);
+
+    /* WRITER ONLY */
+    inline void
+    push(clock_type::time_point tp, double price, size_t size)
+    {
+        uint64_t h = _hdr->head.load(std::memory_order_relaxed);
+        _hdr->claimed.store(h + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t i = h & _mask;
+        _times[i] = tp.time_since_epoch().count();
+        _prices[i] = price;
+        _sizes[i] = size;
+        _hdr->head.store(h + 1, std::memory_order_release);
+    }
+
+    /*
+     * append the trades from sequence # 'seq' on (or from the oldest one
+     * still held, if it's been overwritten) to 'buf'; returns the sequence
+     * # of the next trade, i.e. the cursor for the next call
+     */
+    uint64_t
+    read_since(uint64_t seq, std::vector<timesale_entry_type>& buf) const;
+
+    /* volume-weighted average price of the trades held w/ times in
+       [from, to]; 0 if there aren't any */
+    double
+    vwap(clock_type::time_point from, clock_type::time_point to) const;
+
+    /* volume at each price over the trades held w/ times in [from, to] */
+    std::map<double, unsigned long long>
+    volume_profile(clock_type::time_point from,
+                   clock_type::time_point to) const;
+
+    /* sequence # of the next trade (= number of trades ever pushed) */
+    inline uint64_t
+    head() const
+    { return _hdr->head.load(std::memory_order_acquire); }
+
+    inline size_t
+    capacity() const
+    { return static_cast<size_t>(_mask + 1); }
+
+    inline bool
+    is_mapped() const
+    { return _mapped; }
+};
+
+}; /* detail */
+
+}; /* sob */
+
+#endif /* JO_SOB_TIMESALES */
@@ -500,6 +500,66 @@ def test_TrailingBracket():
         raise Exception("*** ERROR orders still exists in book ***")  
     
 
+def test_ICEBERG():
+    aot = sob.AdvancedOrderTicketICEBERG.build(SZ)
+    check_val(aot.condition, sob.CONDITION_ICEBERG, "ICEBERG.condition")
+    check_val(aot.trigger, sob.TRIGGER_NONE, "ICEBERG.trigger")
+    check_val(aot.display_size, SZ, "ICEBERG.display_size")
+
+    book = sob.SimpleOrderbook(TICK_TYPE, BOOK_MIN, BOOK_MAX)
+
+    def cb(msg,id1, id2, price, size):
+        pass #print("ICEBERG callback: ", msg, id1, id2, price, size)
+
+    o1 = book.sell_limit(BOOK_MID, SZ*3, cb, advanced=aot)
+    check_val(book.ask_size(), SZ, "ICEBERG.ask_size(1)")
+
+    o2 = book.sell_limit(BOOK_MID, SZ, cb)
+    o3 = book.buy_limit(BOOK_MID, int(SZ*1.5), cb)
+    # display filled and replenished behind o2, which takes the rest
+    check_val(book.ask_size(), int(SZ*1.5), "ICEBERG.ask_size(2)")
+    check_val(book.volume(), int(SZ*1.5), "ICEBERG.volume")
+
+    oi = book.get_order_info(o1)
+    check_val(oi.size, SZ*2, "ICEBERG.order_info.size")
+    check_val(oi.advanced.display_size, SZ, "ICEBERG.order_info.display_size")
+
+    book.pull_order(o1)
+    book.pull_order(o2)
+    check_val(book.ask_size(), 0, "ICEBERG.ask_size(3)")
+
+
+def test_PEG():
+    aot = sob.AdvancedOrderTicketPEG.build_primary(1)
+    check_val(aot.condition, sob.CONDITION_PRIMARY_PEG, "PEG.condition")
+    check_val(aot.trigger, sob.TRIGGER_NONE, "PEG.trigger")
+    check_val(aot.nticks, 1, "PEG.nticks")
+
+    book = sob.SimpleOrderbook(TICK_TYPE, BOOK_MIN, BOOK_MAX)
+
+    def cb(msg,id1, id2, price, size):
+        pass #print("PEG callback: ", msg, id1, id2, price, size)
+
+    book.sell_limit(BOOK_MID + BOOK_INCR*10, SZ, cb)
+    book.buy_limit(BOOK_MID, SZ, cb)
+    o1 = book.buy_limit(BOOK_MID + BOOK_INCR*5, SZ, cb, advanced=aot)
+
+    oi = book.get_order_info(o1)
+    if oi.limit != BOOK_MID - BOOK_INCR:
+        raise Exception("*** ERROR PEG.limit(%f) != %f ***" % (oi.limit, BOOK_MID - BOOK_INCR))
+    check_val(oi.advanced.condition, sob.CONDITION_PRIMARY_PEG, "PEG.order_info.condition")
+
+    book.buy_limit(BOOK_MID + BOOK_INCR*2, SZ, cb)
+    oi = book.get_order_info(o1)
+    if oi.limit != BOOK_MID + BOOK_INCR:
+        raise Exception("*** ERROR PEG.limit(%f) != %f ***" % (oi.limit, BOOK_MID + BOOK_INCR))
+
+    aot = sob.AdvancedOrderTicketPEG.build_mid()
+    check_val(aot.condition, sob.CONDITION_MID_PEG, "PEG(mid).condition")
+    aot = sob.AdvancedOrderTicketPEG.build_market(2)
+    check_val(aot.condition, sob.CONDITION_MARKET_PEG, "PEG(market).condition")
+
+
 def test_all():
     test_OCO()
     print("*** OCO - SUCCESS ***")
@@ -515,6 +575,10 @@ def test_all():
     print("*** TrailingBracket - SUCCESS ***")
     test_AON()
     print("*** AON - SUCCESS ***")
+    test_ICEBERG()
+    print("*** ICEBERG - SUCCESS ***")
+    test_PEG()
+    print("*** PEG - SUCCESS ***")
     print("*** SUCCESS ****")
 
 
@@ -99,6 +99,18 @@ struct pyAOT_AON
         : public pyAOT{
 };
 
+/* iceberg */
+struct pyAOT_ICEBERG
+        : public pyAOT{
+    size_t display_size;
+};
+
+/* pegged (primary, market, mid) */
+struct pyAOT_PEG
+        : public pyAOT{
+    size_t nticks;
+};
+
 #define BUILD_AOT_METHOD_DEF(m, f, doc) \
 {m, (PyCFunction)f, (METH_VARARGS | METH_KEYWORDS | METH_CLASS), doc}
 
@@ -116,6 +128,8 @@ extern PyTypeObject pyAOT_BRACKET_Active_type;
 extern PyTypeObject pyAOT_TrailingStop_Active_type;
 extern PyTypeObject pyAOT_TrailingBracket_Active_type;
 extern PyTypeObject pyAOT_AON_type;
+extern PyTypeObject pyAOT_ICEBERG_type;
+extern PyTypeObject pyAOT_PEG_type;
 
 #define BUILD_AOT_DERIVED_TYPE_OBJ_EX(obj, flags, meths, mmbrs, cnstr, base, name, doc) \
 PyTypeObject obj ## _type = { \
@@ -167,6 +181,8 @@ pyAOT_type_obj()
     : std::is_same<T, pyAOT_TrailingStop>::value ? &pyAOT_TrailingStop_type
     : std::is_same<T, pyAOT_TrailingBracket>::value ? &pyAOT_TrailingBracket_type
     : std::is_same<T, pyAOT_AON>::value ? &pyAOT_AON_type
+    : std::is_same<T, pyAOT_ICEBERG>::value ? &pyAOT_ICEBERG_type
+    : std::is_same<T, pyAOT_PEG>::value ? &pyAOT_PEG_type
     : throw std::runtime_error("invalid pyAOT type");
 }
 
@@ -39,8 +39,14 @@ struct Strings{
     sob_type[],
     low[],
     high[],
+    inline_exec[],
     new_max[],
     new_min[],
+    new_size[],
+    new_price[],
+    factor[],
+    max_ticks[],
+    margin[],
     price[],
     lower[],
     upper[],
@@ -53,6 +59,7 @@ struct Strings{
     nticks[],
     stop_nticks[],
     target_nticks[],
+    display_size[],
     advanced[],
     order_type[],
     /* pyAOT/pyOrderInfo member doc strings */
@@ -68,6 +75,7 @@ struct Strings{
     nticks_doc[],
     stop_nticks_doc[],
     target_nticks_doc[],
+    display_size_doc[],
     order_type_doc[],
     advanced_doc[];
 };
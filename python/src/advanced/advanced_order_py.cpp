@@ -121,6 +121,10 @@ py_to_native_aot<PyObject>(PyObject* obj)
         return py_to_native_aot(reinterpret_cast<pyAOT_TrailingBracket*>(obj));
     }else if( addr == reinterpret_cast<uintptr_t>(&pyAOT_AON_type) ){
         return py_to_native_aot(reinterpret_cast<pyAOT_AON*>(obj));
+    }else if( addr == reinterpret_cast<uintptr_t>(&pyAOT_ICEBERG_type) ){
+        return py_to_native_aot(reinterpret_cast<pyAOT_ICEBERG*>(obj));
+    }else if( addr == reinterpret_cast<uintptr_t>(&pyAOT_PEG_type) ){
+        return py_to_native_aot(reinterpret_cast<pyAOT_PEG*>(obj));
     }else{
         throw std::runtime_error("invalid pyAOT type");
     }
@@ -168,6 +172,14 @@ native_aot_to_py(const sob::AdvancedOrderTicket& aot)
     case sob::order_condition::all_or_none:
         obj = native_aot_to_py<pyAOT_AON>(aot);
         break;
+    case sob::order_condition::iceberg:
+        obj = native_aot_to_py<pyAOT_ICEBERG>(aot);
+        break;
+    case sob::order_condition::primary_peg: /* no break */
+    case sob::order_condition::market_peg: /* no break */
+    case sob::order_condition::mid_peg:
+        obj = native_aot_to_py<pyAOT_PEG>(aot);
+        break;
     default:
         return nullptr;
     };
@@ -0,0 +1,103 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <Python.h>
+#include <structmember.h>
+
+#include <map>
+
+#include "../../include/common_py.hpp"
+#include "../../include/advanced_order_py.hpp"
+#include "../../include/argparse_py.hpp"
+
+namespace {
+
+
+bool
+get_args(pyAOT_ICEBERG *obj,  PyObject *args, PyObject *kwds)
+{
+    static char* kwlist[] = {Strings::display_size, NULL};
+    return MethodArgs::parse(args, kwds, "k", kwlist, &obj->display_size);
+}
+
+int
+init(pyAOT_ICEBERG *self, PyObject *args, PyObject *kwds)
+{
+    if( get_args(self, args, kwds) ){
+        return init_base<sob::AdvancedOrderTicketICEBERG>(self);
+    }
+    return -1;
+}
+
+PyObject*
+build( PyObject *cls, PyObject *args, PyObject *kwds )
+{
+    pyAOT_ICEBERG *obj = pyAOT_new<pyAOT_ICEBERG>();
+    if( !obj ){
+        PyErr_SetString(PyExc_MemoryError, "order ticket allocation failed");
+        return NULL;
+    }
+    if( !get_args(obj, args, kwds)
+        || init_base<sob::AdvancedOrderTicketICEBERG>(obj) < 0 )
+    {
+        pyAOT_delete(obj);
+        return NULL;
+    }
+    return reinterpret_cast<PyObject*>(obj);
+}
+
+PyMethodDef methods[] = {
+    BUILD_AOT_METHOD_DEF("build", build, "build iceberg ticket"),
+    {NULL}
+};
+
+PyMemberDef members[] = {
+    BUILD_PY_OBJ_MEMBER_DEF(display_size, T_ULONG, pyAOT_ICEBERG),
+    {NULL}
+};
+
+}; /* namespace */
+
+template<>
+sob::AdvancedOrderTicket
+py_to_native_aot<pyAOT_ICEBERG>(pyAOT_ICEBERG* obj)
+{
+    return sob::AdvancedOrderTicketICEBERG::build( obj->display_size );
+}
+
+
+template<>
+pyAOT_ICEBERG*
+native_aot_to_py(const sob::AdvancedOrderTicket& aot)
+{
+    pyAOT_ICEBERG *obj = pyAOT_new<pyAOT_ICEBERG>();
+    if( !obj ){
+        PyErr_SetString(PyExc_MemoryError, "order ticket allocation failed");
+        return NULL;
+    }
+
+    obj->display_size = aot.order1()->size();
+    return obj;
+}
+
+
+BUILD_AOT_DERIVED_TYPE_OBJ(
+        pyAOT_ICEBERG,
+        "simpleorderbook.AdvancedOrderTicketICEBERG",
+        "AdvancedOrderTicket iceberg object"
+        );
+
@@ -0,0 +1,125 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <Python.h>
+#include <structmember.h>
+
+#include <map>
+
+#include "../../include/common_py.hpp"
+#include "../../include/advanced_order_py.hpp"
+#include "../../include/argparse_py.hpp"
+
+namespace {
+
+bool
+get_args(pyAOT_PEG *obj,  PyObject *args, PyObject *kwds)
+{
+    static char* kwlist[] = {Strings::nticks, NULL};
+    return MethodArgs::parse(args, kwds, "|k", kwlist, &obj->nticks);
+}
+
+/* no single condition for the type so we don't use init_base */
+template<sob::order_condition C>
+int
+init_peg(pyAOT_PEG *self)
+{
+    self->condition = static_cast<int>(C);
+    self->trigger = static_cast<int>(sob::AdvancedOrderTicketPEG::default_trigger);
+    return 0;
+}
+
+/* CONSTRUCTOR (primary peg) */
+int
+init(pyAOT_PEG *self, PyObject *args, PyObject *kwds)
+{
+    if( get_args(self, args, kwds) ){
+        return init_peg<sob::order_condition::primary_peg>(self);
+    }
+    return -1;
+}
+
+/* FACTORY */
+template<sob::order_condition C>
+PyObject*
+build( PyObject *cls, PyObject *args, PyObject *kwds )
+{
+    pyAOT_PEG *obj = pyAOT_new<pyAOT_PEG>();
+    if( !obj ){
+        PyErr_SetString(PyExc_MemoryError, "order ticket allocation failed");
+        return NULL;
+    }
+    if( !get_args(obj, args, kwds) || init_peg<C>(obj) < 0 ){
+        pyAOT_delete(obj);
+        return NULL;
+    }
+    return reinterpret_cast<PyObject*>(obj);
+}
+
+PyMethodDef methods[] = {
+    BUILD_AOT_METHOD_DEF("build_primary", build<sob::order_condition::primary_peg>,
+                         "build primary peg ticket"),
+    BUILD_AOT_METHOD_DEF("build_market", build<sob::order_condition::market_peg>,
+                         "build market peg ticket"),
+    BUILD_AOT_METHOD_DEF("build_mid", build<sob::order_condition::mid_peg>,
+                         "build mid-point peg ticket"),
+    {NULL}
+};
+
+PyMemberDef members[] = {
+    BUILD_PY_OBJ_MEMBER_DEF(nticks, T_ULONG, pyAOT_PEG),
+    {NULL}
+};
+
+}; /* namespace */
+
+template<>
+sob::AdvancedOrderTicket
+py_to_native_aot<pyAOT_PEG>(pyAOT_PEG* obj)
+{
+    switch( static_cast<sob::order_condition>(obj->condition) ){
+    case sob::order_condition::market_peg:
+        return sob::AdvancedOrderTicketPEG::build_market( obj->nticks );
+    case sob::order_condition::mid_peg:
+        return sob::AdvancedOrderTicketPEG::build_mid( obj->nticks );
+    default:
+        return sob::AdvancedOrderTicketPEG::build_primary( obj->nticks );
+    }
+}
+
+
+template<>
+pyAOT_PEG*
+native_aot_to_py(const sob::AdvancedOrderTicket& aot)
+{
+    pyAOT_PEG *obj = pyAOT_new<pyAOT_PEG>();
+    if( !obj ){
+        PyErr_SetString(PyExc_MemoryError, "order ticket allocation failed");
+        return NULL;
+    }
+
+    obj->nticks = aot.order1()->limit_nticks();
+    return obj;
+}
+
+
+BUILD_AOT_DERIVED_TYPE_OBJ(
+        pyAOT_PEG,
+        "simpleorderbook.AdvancedOrderTicketPEG",
+        "AdvancedOrderTicket pegged order object"
+        );
+
@@ -53,6 +53,8 @@ ORDER_TYPES = {
     {static_cast<int>(sob::order_type::limit), "ORDER_TYPE_LIMIT"},
     {static_cast<int>(sob::order_type::stop), "ORDER_TYPE_STOP"},
     {static_cast<int>(sob::order_type::stop_limit), "ORDER_TYPE_STOP_LIMIT"},
+    {static_cast<int>(sob::order_type::fill_or_kill), "ORDER_TYPE_FILL_OR_KILL"},
+    {static_cast<int>(sob::order_type::immediate_or_cancel), "ORDER_TYPE_IMMEDIATE_OR_CANCEL"},
 };
 
 const std::map<int, std::string>
@@ -73,7 +75,9 @@ CALLBACK_MESSAGES = {
     {static_cast<int>(sob::callback_msg::trigger_TRAILING_STOP_open_loss), "MSG_TRIGGER_TRAILING_STOP_OPEN_LOSS"},
     {static_cast<int>(sob::callback_msg::trigger_TRAILING_STOP_adj_loss), "MSG_TRIGGER_TRAILING_STOP_ADJ_LOSS"},
     {static_cast<int>(sob::callback_msg::trigger_TRAILING_STOP_close), "MSG_TRIGGER_TRAILING_STOP_CLOSE"},
-    {static_cast<int>(sob::callback_msg::kill), "MSG_KILL"}
+    {static_cast<int>(sob::callback_msg::kill), "MSG_KILL"},
+    {static_cast<int>(sob::callback_msg::trigger_PEG_adj), "MSG_TRIGGER_PEG_ADJ"},
+    {static_cast<int>(sob::callback_msg::modify), "MSG_MODIFY"}
 };
 
 const std::map<int, std::string>
@@ -94,7 +98,11 @@ ORDER_CONDITIONS = {
     {static_cast<int>(sob::order_condition::_bracket_active), "CONDITION_BRACKET_ACTIVE"},
     {static_cast<int>(sob::order_condition::_trailing_bracket_active), "CONDITION_TRAILING_BRACKET_ACTIVE"},
     {static_cast<int>(sob::order_condition::_trailing_stop_active), "CONDITION_TRAILING_STOP_ACTIVE"},
-    {static_cast<int>(sob::order_condition::all_or_none), "CONDITION_AON"}
+    {static_cast<int>(sob::order_condition::all_or_none), "CONDITION_AON"},
+    {static_cast<int>(sob::order_condition::iceberg), "CONDITION_ICEBERG"},
+    {static_cast<int>(sob::order_condition::primary_peg), "CONDITION_PRIMARY_PEG"},
+    {static_cast<int>(sob::order_condition::market_peg), "CONDITION_MARKET_PEG"},
+    {static_cast<int>(sob::order_condition::mid_peg), "CONDITION_MID_PEG"}
 };
 
 const std::map<int, std::string>
@@ -192,7 +200,6 @@ ticks_in_range(PyObject *self, PyObject *args, PyObject *kwds)
     return PyLong_FromLongLong(ticks);
 }
 
-/*
 PyObject*
 tick_memory_required(PyObject *self, PyObject *args, PyObject *kwds)
 {
@@ -221,7 +228,6 @@ tick_memory_required(PyObject *self, PyObject *args, PyObject *kwds)
     }
     return PyLong_FromUnsignedLongLong(mem);
 }
-*/
 
 PyMethodDef methods[] = {
     MDef::KeyArgs("tick_size", tick_size,
@@ -245,7 +251,6 @@ PyMethodDef methods[] = {
                   "    lower :: float :: lower price \n"
                   "    upper :: float :: upper price \n\n"
                   "    returns -> int \n"),
-/*
     MDef::KeyArgs("tick_memory_required", tick_memory_required,
                   "bytes of memory required for (pre-allocating) orderbook "
                   "internals. THIS IS NOT TOTAL MEMORY NEEDED! \n\n"
@@ -255,7 +260,6 @@ PyMethodDef methods[] = {
                   "    lower :: float :: lower price \n"
                   "    upper :: float :: upper price \n\n"
                   "    returns -> int \n"),
-*/
     {NULL}
 };
 
@@ -349,7 +353,9 @@ PyInit_simpleorderbook(void)
         || PyType_Ready(&pyAOT_BRACKET_Active_type) < 0
         || PyType_Ready(&pyAOT_TrailingBracket_Active_type) < 0
         || PyType_Ready(&pyAOT_TrailingStop_Active_type) < 0
-        || PyType_Ready(&pyAOT_AON_type) < 0 )
+        || PyType_Ready(&pyAOT_AON_type) < 0
+        || PyType_Ready(&pyAOT_ICEBERG_type) < 0
+        || PyType_Ready(&pyAOT_PEG_type) < 0 )
     {
         return NULL;
     }
@@ -392,6 +398,13 @@ PyInit_simpleorderbook(void)
     Py_INCREF(&pyAOT_AON_type);
     PyModule_AddObject(mod, "AdvancedOrderTicketAON", (PyObject*)&pyAOT_AON_type);
 
+    Py_INCREF(&pyAOT_ICEBERG_type);
+    PyModule_AddObject(mod, "AdvancedOrderTicketICEBERG",
+            (PyObject*)&pyAOT_ICEBERG_type);
+
+    Py_INCREF(&pyAOT_PEG_type);
+    PyModule_AddObject(mod, "AdvancedOrderTicketPEG", (PyObject*)&pyAOT_PEG_type);
+
     set_const_attributes(mod, SOB_TYPES);
     set_const_attributes(mod, ORDER_TYPES);
     set_const_attributes(mod, CALLBACK_MESSAGES);
@@ -275,6 +275,35 @@ SOB_pull_order(pySOB *self, PyObject *args, PyObject *kwds)
 }
 
 
+PyObject*
+SOB_modify_order(pySOB *self, PyObject *args, PyObject *kwds)
+{
+    static char* kwlist[] = {Strings::id, Strings::new_size, Strings::new_price,
+                             NULL};
+
+    sob::id_type id;
+    size_t new_size;
+    double new_price = 0;
+    if( !MethodArgs::parse(args, kwds, "kk|d", kwlist, &id, &new_size,
+                           &new_price) ){
+        return NULL;
+    }
+
+    bool rval = false;
+    Py_BEGIN_ALLOW_THREADS
+    try{
+        rval = self->interface->modify_order(id, new_size, new_price);
+    }catch(std::exception& e){
+        Py_BLOCK_THREADS
+        CONVERT_AND_THROW_NATIVE_EXCEPTION(e);
+        Py_UNBLOCK_THREADS
+    }
+    Py_END_ALLOW_THREADS
+
+    return PyBool_FromLong(static_cast<long>(rval));
+}
+
+
 PyObject*
 SOB_get_order_info(pySOB *self, PyObject *args, PyObject *kwds)
 {
@@ -528,6 +557,114 @@ SOB_grow_book(pySOB *self, PyObject *args, PyObject *kwds)
     Py_RETURN_NONE;
 }
 
+PyObject*
+SOB_shrink_book(pySOB *self, PyObject *args, PyObject *kwds)
+{
+    static char* kwlist[] = { Strings::new_min, Strings::new_max, NULL };
+
+    double lo, hi;
+    if( !MethodArgs::parse(args, kwds, "dd", kwlist, &lo, &hi) ){
+        return NULL;
+    }
+
+    bool rval = false;
+    Py_BEGIN_ALLOW_THREADS
+    try{
+        sob::ManagementInterface *ob =
+            dynamic_cast<sob::ManagementInterface*>(self->interface);
+        rval = ob->shrink_book(lo, hi);
+    }catch(std::exception& e){
+        Py_BLOCK_THREADS
+        CONVERT_AND_THROW_NATIVE_EXCEPTION(e);
+        Py_UNBLOCK_THREADS
+    }
+    Py_END_ALLOW_THREADS
+    return PyBool_FromLong(static_cast<long>(rval));
+}
+
+
+PyObject*
+SOB_set_auto_recenter(pySOB *self, PyObject *args, PyObject *kwds)
+{
+    static char* kwlist[] = { Strings::margin, NULL };
+
+    unsigned long margin;
+    if( !MethodArgs::parse(args, kwds, "k", kwlist, &margin) ){
+        return NULL;
+    }
+
+    try{
+        sob::ManagementInterface *ob =
+            dynamic_cast<sob::ManagementInterface*>(self->interface);
+        ob->set_auto_recenter(margin);
+    }catch(std::exception& e){
+        CONVERT_AND_THROW_NATIVE_EXCEPTION(e);
+    }
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+SOB_set_auto_grow(pySOB *self, PyObject *args, PyObject *kwds)
+{
+    static char* kwlist[] = { Strings::factor, Strings::max_ticks, NULL };
+
+    double factor;
+    unsigned long max_ticks = 0;
+    if( !MethodArgs::parse(args, kwds, "d|k", kwlist, &factor, &max_ticks) ){
+        return NULL;
+    }
+
+    try{
+        sob::ManagementInterface *ob =
+            dynamic_cast<sob::ManagementInterface*>(self->interface);
+        ob->set_auto_grow(factor, max_ticks);
+    }catch(std::exception& e){
+        CONVERT_AND_THROW_NATIVE_EXCEPTION(e);
+    }
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+SOB_stats(pySOB *self)
+{
+    sob::engine_stats s;
+    Py_BEGIN_ALLOW_THREADS
+    try{
+        sob::ManagementInterface *ob =
+            dynamic_cast<sob::ManagementInterface*>(self->interface);
+        s = ob->stats();
+    }catch(std::exception& e){
+        Py_BLOCK_THREADS
+        CONVERT_AND_THROW_NATIVE_EXCEPTION(e);
+        Py_UNBLOCK_THREADS
+    }
+    Py_END_ALLOW_THREADS
+
+    return Py_BuildValue(
+        "{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K}",
+        "orders_external", s.orders_external,
+        "orders_internal", s.orders_internal,
+        "external_queue_depth", s.external_queue_depth,
+        "external_queue_hwm", s.external_queue_hwm,
+        "async_callback_backlog", s.async_callback_backlog,
+        "async_callback_hwm", s.async_callback_hwm,
+        "cascades", s.cascades,
+        "cascade_max", s.cascade_max,
+        "internal_queue_hwm", s.internal_queue_hwm,
+        "trades", s.trades,
+        "matches", s.matches,
+        "levels_scanned", s.levels_scanned,
+        "levels_scanned_max", s.levels_scanned_max,
+        "lock_acquisitions", s.lock_acquisitions,
+        "lock_contended", s.lock_contended,
+        "lock_wait_ns", s.lock_wait_ns,
+        "lock_wait_max_ns", s.lock_wait_max_ns
+        );
+}
+
+
 PyObject*
 SOB_is_valid_price(pySOB *self, PyObject *args, PyObject *kwds)
 {
@@ -619,10 +756,12 @@ pySOB_init(pySOB *self, PyObject *args, PyObject *kwds)
 {
     double low, high;
     int sobty;
+    int inline_exec = 0;
 
     static char* kwlist[] = { Strings::sob_type, Strings::low,
-                              Strings::high, NULL };
-    if( !MethodArgs::parse(args, kwds, "idd", kwlist, &sobty, &low, &high) ){
+                              Strings::high, Strings::inline_exec, NULL };
+    if( !MethodArgs::parse(args, kwds, "idd|p", kwlist, &sobty, &low, &high,
+                           &inline_exec) ){
         return -1;
     }
 
@@ -645,7 +784,8 @@ pySOB_init(pySOB *self, PyObject *args, PyObject *kwds)
 
     Py_BEGIN_ALLOW_THREADS
     try{
-        ob = proxy.create(low,high);
+        ob = inline_exec ? proxy.create_inline(low,high)
+                         : proxy.create(low,high);
     }catch(const std::runtime_error & e){
         Py_BLOCK_THREADS
         PyErr_SetString(PyExc_RuntimeError, e.what());
@@ -738,6 +878,33 @@ PyMethodDef pySOB_methods[] = {
                   "    def grow_book_below(new_min) -> None \n\n"
                   "    new_min :: float :: new minimum order/trade price"),
 
+    MDef::KeyArgs("set_auto_grow", SOB_set_auto_grow,
+                  "grow the book instead of rejecting out-of-range orders \n\n"
+                  "    def set_auto_grow(factor, max_ticks=0) -> None \n\n"
+                  "    factor    :: float :: grow by (at least) factor x current "
+                  "ticks (0 to turn off) \n"
+                  "    max_ticks :: int   :: never grow past this many ticks "
+                  "(0 for no cap)"),
+
+    MDef::KeyArgs("shrink_book", SOB_shrink_book,
+                  "release the (empty) price levels outside a new range \n\n"
+                  "    def shrink_book(new_min, new_max) -> bool \n\n"
+                  "    new_min :: float :: new minimum order/trade price \n"
+                  "    new_max :: float :: new maximum order/trade price \n\n"
+                  "    returns -> False (nothing changes) if orders rest outside"),
+
+    MDef::KeyArgs("set_auto_recenter", SOB_set_auto_recenter,
+                  "shrink the book when it gets too far from the market \n\n"
+                  "    def set_auto_recenter(margin) -> None \n\n"
+                  "    margin :: int :: ticks to keep around the outermost "
+                  "orders (0 to turn off)"),
+
+    MDef::NoArgs("stats", SOB_stats,
+                 "engine counters and high-water marks \n\n"
+                 "    def stats() -> {name:int} \n\n"
+                 "    returns -> dict of orders_external/internal, queue depths, "
+                 "cascades, trades/matches/levels_scanned, lock waits (ns)"),
+
     MDef::KeyArgs("is_valid_price", SOB_is_valid_price,
                   "is price valid inside this book \n\n"
                   "    def is_valid_price(price) -> bool \n\n"
@@ -831,6 +998,14 @@ PyMethodDef pySOB_methods[] = {
         "    id :: int :: order ID \n\n"
         "    returns -> bool \n"),
 
+    MDef::KeyArgs("modify_order",SOB_modify_order,
+        " amend resting limit order in place (keeps order ID) \n\n"
+        "    def modify_order(id, new_size, new_price=0) -> success \n\n"
+        "    id        :: int   :: order ID \n"
+        "    new_size  :: int   :: new (total) size \n"
+        "    new_price :: float :: new limit price (0 keeps current price) \n\n"
+        "    returns -> bool \n"),
+
 #define DOCS_REPLACE_WITH_MARKET(arg1) \
     " replace old order with new " arg1 " market order \n\n" \
     "    def replace_with_" arg1 "_market(id, size, callback=None)"\
@@ -922,7 +1097,9 @@ PyTypeObject pySOB_type = {
     "SimpleOrderbook: interface for a C++ financial orderbook and matching engine.\n\n"
     "  type  ::  int  :: type of orderbook (e.g SOB_QUARTER_TICK)\n"
     "  low   :: float :: minimum price can trade at\n"
-    "  high  :: float :: maximum price can trade at\n" ,
+    "  high  :: float :: maximum price can trade at\n"
+    "  inline_exec :: bool :: execute orders in the calling thread, w/o a\n"
+    "                         dispatcher thread (e.g backtesting) [False]\n" ,
     0, 0, 0, 0, 0, 0,
     pySOB_methods,
     0, 0, 0, 0, 0, 0, 0,
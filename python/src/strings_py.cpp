@@ -26,8 +26,14 @@ char Strings::depth[] = "depth";
 char Strings::sob_type[] = "sob_type";
 char Strings::low[] = "low";
 char Strings::high[] = "high";
+char Strings::inline_exec[] = "inline_exec";
 char Strings::new_max[] = "new_max";
 char Strings::new_min[] = "new_min";
+char Strings::new_size[] = "new_size";
+char Strings::new_price[] = "new_price";
+char Strings::factor[] = "factor";
+char Strings::max_ticks[] = "max_ticks";
+char Strings::margin[] = "margin";
 char Strings::price[] = "price";
 char Strings::lower[] = "lower";
 char Strings::upper[] = "upper";
@@ -40,6 +46,7 @@ char Strings::target_limit[] = "target_limit";
 char Strings::nticks[] = "nticks";
 char Strings::stop_nticks[] = "stop_nticks";
 char Strings::target_nticks[] = "target_nticks";
+char Strings::display_size[] = "display_size";
 char Strings::advanced[] = "advanced";
 char Strings::order_type[] = "order_type";
 
@@ -55,5 +62,6 @@ char Strings::target_limit_doc[] = "advanced order target-limit price";
 char Strings::nticks_doc[] = "advanced order number of ticks";
 char Strings::stop_nticks_doc[] = "advanced order number of stop ticks";
 char Strings::target_nticks_doc[] = "advanced order number of target ticks";
+char Strings::display_size_doc[] = "advanced order (iceberg) displayed size";
 char Strings::order_type_doc[] = "order type (sob::order_type)";
 char Strings::advanced_doc[] = "advanced order ticket";
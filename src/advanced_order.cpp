@@ -22,8 +22,8 @@ namespace sob{
 /* BASE TICKET */
 AdvancedOrderTicket::AdvancedOrderTicket( order_condition condition,
                                           condition_trigger trigger,
-                                          OrderParamaters *order1,
-                                          OrderParamaters *order2 )
+                                          const OrderParamatersStorage& order1,
+                                          const OrderParamatersStorage& order2 )
     :
         _condition(condition),
         _trigger(trigger),
@@ -41,55 +41,13 @@ AdvancedOrderTicket::AdvancedOrderTicket() // null ticket
     {
     }
 
-AdvancedOrderTicket::AdvancedOrderTicket(const AdvancedOrderTicket& aot)
-    :
-        _condition( aot._condition ),
-        _trigger( aot._trigger ),
-        _order1( copy_order(aot._order1) ),
-        _order2( copy_order(aot._order2) )
-    {
-    }
-
-AdvancedOrderTicket::AdvancedOrderTicket(AdvancedOrderTicket&& aot)
-    :
-        _condition( aot._condition ),
-        _trigger( aot._trigger ),
-        _order1( std::move(aot._order1) ),
-        _order2( std::move(aot._order2) )
-    {
-    }
-
-AdvancedOrderTicket&
-AdvancedOrderTicket::operator=(const AdvancedOrderTicket& aot)
-{
-    if(*this != aot){
-        _condition = aot._condition;
-        _trigger = aot._trigger;
-        _order1 = std::move( copy_order(aot._order1) );
-        _order2 = std::move( copy_order(aot._order2) );
-    }
-    return *this;
-}
-
-AdvancedOrderTicket&
-AdvancedOrderTicket::operator=(AdvancedOrderTicket&& aot)
-{
-    if(*this != aot){
-        _condition = aot._condition;
-        _trigger = aot._trigger;
-        _order1 = std::move(aot._order1);
-        _order2 = std::move(aot._order2);
-    }
-    return *this;
-}
-
 bool
 AdvancedOrderTicket::operator==(const AdvancedOrderTicket& aot) const
 {
     return _condition == aot._condition
             && _trigger == aot._trigger
-            && cmp_orders(_order1, aot._order1)
-            && cmp_orders(_order2, aot._order2);
+            && _order1 == aot._order1
+            && _order2 == aot._order2;
 }
 
 const AdvancedOrderTicket AdvancedOrderTicket::null;
@@ -107,7 +65,7 @@ AdvancedOrderTicketOCO::AdvancedOrderTicketOCO( condition_trigger trigger,
                                                 double stop )
     :
         AdvancedOrderTicket( condition, trigger,
-                new OrderParamatersByPrice(is_buy, size, limit, stop) )
+                OrderParamatersByPrice(is_buy, size, limit, stop) )
     {
         if( size == 0 ){
             throw std::invalid_argument("invalid order size");
@@ -164,7 +122,7 @@ AdvancedOrderTicketOTO::AdvancedOrderTicketOTO( condition_trigger trigger,
                                                 double stop )
     :
         AdvancedOrderTicket( condition, trigger,
-                new OrderParamatersByPrice(is_buy, size, limit, stop) )
+                OrderParamatersByPrice(is_buy, size, limit, stop) )
     {
         if( size == 0 ){
             throw std::invalid_argument("invalid order size");
@@ -238,8 +196,8 @@ AdvancedOrderTicketBRACKET::AdvancedOrderTicketBRACKET(
         )
     :
         AdvancedOrderTicket( order_condition::bracket, trigger,
-                new OrderParamatersByPrice(is_buy,1,loss_limit, loss_stop),
-                new OrderParamatersByPrice(is_buy,1,target_limit, 0)
+                OrderParamatersByPrice(is_buy,1,loss_limit, loss_stop),
+                OrderParamatersByPrice(is_buy,1,target_limit, 0)
                 )
     {
     }
@@ -324,7 +282,7 @@ AdvancedOrderTicketTrailingStop::AdvancedOrderTicketTrailingStop(
         )
     :
         AdvancedOrderTicket( condition, trigger,
-                             new OrderParamatersByNTicks(0,0,0,nticks) )
+                             OrderParamatersByNTicks(0,0,0,nticks) )
     {
     }
 
@@ -353,8 +311,8 @@ AdvancedOrderTicketTrailingBracket::AdvancedOrderTicketTrailingBracket(
         )
     :
         AdvancedOrderTicket(condition, trigger,
-                new OrderParamatersByNTicks(0,0,0,stop_nticks),
-                new OrderParamatersByNTicks(0,0,target_nticks,0))
+                OrderParamatersByNTicks(0,0,0,stop_nticks),
+                OrderParamatersByNTicks(0,0,target_nticks,0))
     {
     }
 
@@ -383,6 +341,58 @@ const order_condition AdvancedOrderTicketAON::condition =
 const condition_trigger AdvancedOrderTicketAON::default_trigger =
         condition_trigger::none;
 
+
+/* ICEBERG */
+AdvancedOrderTicketICEBERG::AdvancedOrderTicketICEBERG(size_t display_size)
+    :
+        AdvancedOrderTicket( condition, default_trigger,
+                             OrderParamatersByPrice(0, display_size, 0, 0) )
+    {
+    }
+
+AdvancedOrderTicketICEBERG
+AdvancedOrderTicketICEBERG::build(size_t display_size)
+{
+    if( display_size == 0 ){
+        throw std::invalid_argument("display_size == 0");
+    }
+    return AdvancedOrderTicketICEBERG(display_size);
+}
+
+const order_condition AdvancedOrderTicketICEBERG::condition =
+        order_condition::iceberg;
+
+const condition_trigger AdvancedOrderTicketICEBERG::default_trigger =
+        condition_trigger::none;
+
+
+/* PEG */
+AdvancedOrderTicketPEG::AdvancedOrderTicketPEG( order_condition condition,
+                                                size_t nticks )
+    :
+        AdvancedOrderTicket( condition, default_trigger,
+                             OrderParamatersByNTicks(0,0,nticks,0) )
+    {
+        if( nticks > LONG_MAX ){
+            throw std::invalid_argument("nticks overflows long");
+        }
+    }
+
+AdvancedOrderTicketPEG
+AdvancedOrderTicketPEG::build_primary(size_t nticks)
+{ return AdvancedOrderTicketPEG(order_condition::primary_peg, nticks); }
+
+AdvancedOrderTicketPEG
+AdvancedOrderTicketPEG::build_market(size_t nticks)
+{ return AdvancedOrderTicketPEG(order_condition::market_peg, nticks); }
+
+AdvancedOrderTicketPEG
+AdvancedOrderTicketPEG::build_mid(size_t nticks)
+{ return AdvancedOrderTicketPEG(order_condition::mid_peg, nticks); }
+
+const condition_trigger AdvancedOrderTicketPEG::default_trigger =
+        condition_trigger::none;
+
 }; /* sob */
 
 
@@ -72,6 +72,14 @@ SOB_CLASS::_route_advanced_order(order_queue_elem& e)
     case order_condition::all_or_none:
         _insert_ALL_OR_NONE_order(e);
         break;
+    case order_condition::iceberg:
+        _insert_ICEBERG_order(e);
+        break;
+    case order_condition::primary_peg: /* no break */
+    case order_condition::market_peg: /* no break */
+    case order_condition::mid_peg:
+        _insert_PEGGED_order(e);
+        break;
     default:
         throw std::runtime_error("invalid advanced order condition");
     }
@@ -84,6 +92,10 @@ SOB_CLASS::_handle_advanced_order_trigger(_order_bndl& bndl, id_type id, size_t
     switch(bndl.condition){
     case order_condition::one_cancels_other:
     case order_condition::all_or_none:
+    case order_condition::iceberg:
+    case order_condition::primary_peg:
+    case order_condition::market_peg:
+    case order_condition::mid_peg:
         return false; /* NO OP */
     case order_condition::_trailing_stop_active:
         _handle_TRAILING_STOP_ACTIVE(bndl, id, sz);
@@ -121,6 +133,10 @@ SOB_CLASS::_handle_advanced_order_cancel(_order_bndl& bndl, id_type id, size_t s
     case order_condition::trailing_stop:
     case order_condition::_trailing_stop_active:
     case order_condition::all_or_none:
+    case order_condition::iceberg:
+    case order_condition::primary_peg:
+    case order_condition::market_peg:
+    case order_condition::mid_peg:
         return false; /* NO OP */
         /* no break */
     case order_condition::_trailing_bracket_active: /* no break */
@@ -144,7 +160,7 @@ SOB_CLASS::_handle_OTO(_order_bndl& bndl, id_type id, size_t sz)
 
     _exec_OTO_order( bndl.contingent_price_order->params, bndl.cb, id);
 
-    delete bndl.contingent_price_order;
+    contingent_price_order_type::pool_type::release(bndl.contingent_price_order);
     bndl.contingent_price_order = nullptr;
     bndl.condition = order_condition::none;
     bndl.trigger = condition_trigger::none;
@@ -166,7 +182,7 @@ SOB_CLASS::_handle_OCO(_order_bndl& bndl, id_type id, size_t sz)
     _exec_OCO_order( bndl, (loc->is_primary ? loc->id : id), id, loc->id );
 
     /* remove linked order from union */
-    delete bndl.linked_order;
+    order_link_pool_type::release(bndl.linked_order);
     bndl.linked_order = nullptr;
 
     bndl.condition = order_condition::none;
@@ -197,11 +213,13 @@ SOB_CLASS::_handle_bracket(_order_bndl& bndl, id_type id, size_t sz)
             auto& iwrap2 = _from_cache(bndl.price_bracket_orders->active2);
 
             iwrap1.incr_size(sz);
+            _book_delta_resize(iwrap1);
             _push_exec_callback( callback_msg::trigger_BRACKET_adj_loss,
                                  iwrap1->cb, iwrap1->id, iwrap1->id,
                                  _itop(iwrap1.p), iwrap1->sz);
 
             iwrap2.incr_size(sz);
+            _book_delta_resize(iwrap2);
             _push_exec_callback( callback_msg::trigger_BRACKET_adj_target,
                                  iwrap2->cb, iwrap2->id, iwrap2->id,
                                  _itop(iwrap2.p), iwrap2->sz);
@@ -226,10 +244,10 @@ SOB_CLASS::_handle_bracket(_order_bndl& bndl, id_type id, size_t sz)
          * 'active' condition
          */
         if( IsTrailing ){
-            delete bndl.nticks_bracket_orders;
+            nticks_bracket_type::pool_type::release(bndl.nticks_bracket_orders);
             bndl.nticks_bracket_orders = nullptr;
         }else{
-            delete bndl.price_bracket_orders;
+            price_bracket_type::pool_type::release(bndl.price_bracket_orders);
             bndl.price_bracket_orders = nullptr;
         }
     }
@@ -253,6 +271,7 @@ SOB_CLASS::_handle_active_bracket(_order_bndl& bndl, id_type id, size_t sz)
     /* SHOULDN'T THROW */
     auto& iwrap = _from_cache(other_id);
     iwrap.decr_size(sz);
+    _book_delta_resize(iwrap);
 
     auto msg = iwrap.is_limit()
             ? callback_msg::trigger_BRACKET_adj_target
@@ -280,6 +299,7 @@ SOB_CLASS::_handle_TRAILING_STOP(_order_bndl& bndl, id_type id, size_t sz)
         try{
             auto& iwrap = _from_cache(bndl.contingent_nticks_order->active);
             iwrap.incr_size(sz);
+            _book_delta_resize(iwrap);
             _push_exec_callback( callback_msg::trigger_TRAILING_STOP_adj_loss,
                                  iwrap->cb, iwrap->id, iwrap->id,
                                  _itop(iwrap.p), iwrap->sz );
@@ -294,7 +314,8 @@ SOB_CLASS::_handle_TRAILING_STOP(_order_bndl& bndl, id_type id, size_t sz)
     }
 
     if( sz == bndl.sz ){
-        delete bndl.contingent_nticks_order;
+        contingent_nticks_order_type::pool_type::release(
+            bndl.contingent_nticks_order);
         bndl.contingent_nticks_order = nullptr;
     }
 }
@@ -391,11 +412,11 @@ SOB_CLASS::_exec_bracket_order( const OrderParamaters& op1,
         limit = op2.limit_price();
     }
 
-    auto stop_order = op1.copy_new();
+    OrderParamatersStorage stop_order(op1);
     stop_order->change_size(sz);
 
     _push_internal_order( order_type::limit, op2.is_buy(), limit, 0, sz, cb, oc,
-                          trigger, std::move(stop_order),  nullptr, id_new, id );
+                          trigger, stop_order, nullptr, id_new, id );
 
 }
 
@@ -413,12 +434,12 @@ SOB_CLASS::_exec_TRAILING_STOP_order( const OrderParamaters& op,
     _push_exec_callback( callback_msg::trigger_TRAILING_STOP_open, cb,
                          id, id_new, 0, 0 );
 
-    auto stop_order = op.copy_new();
+    OrderParamatersStorage stop_order(op);
     stop_order->change_size(sz);
 
     _push_internal_order( order_type::stop, op.is_buy(), 0, 0, sz, cb,
                           order_condition::_trailing_stop_active, trigger,
-                          std::move(stop_order), nullptr, id_new, id );
+                          stop_order, nullptr, id_new, id );
 }
 
 
@@ -442,7 +463,8 @@ SOB_CLASS::_insert_OTO_order(const order_queue_elem& e)
     auto& order = _id_cache.at(e.id);
     assert(order);
 
-    order->contingent_price_order = contingent_price_order_type::New(*e.cparams1);
+    order->contingent_price_order =
+        contingent_price_order_type::New(_contingent_price_pool, *e.cparams1);
     order->condition = e.condition;
     order->trigger = e.trigger;
 }
@@ -494,8 +516,8 @@ SOB_CLASS::_insert_OCO_order(order_queue_elem& e)
     assert(order2);
 
     /* link each order with the other */
-    order1->linked_order = new order_link(e2.id, false);
-    order2->linked_order = new order_link(e.id, true);
+    order1->linked_order = _link_pool.acquire(e2.id, false);
+    order2->linked_order = _link_pool.acquire(e.id, true);
 
     /* transfer condition/trigger info */
     order1->condition = order2->condition = e.condition;
@@ -529,15 +551,17 @@ SOB_CLASS::_insert_bracket_order(const order_queue_elem& e)
     auto& order = _id_cache.at(e.id);
     assert(order);
 
-    auto cp1 = e.cparams1->copy_new();
-    auto cp2 = e.cparams2->copy_new();
+    OrderParamatersStorage cp1 = e.cparams1;
+    OrderParamatersStorage cp2 = e.cparams2;
     cp1->change_size( cp1->size() - filled );
     cp2->change_size( cp2->size() - filled );
 
     if( IsTrailing ){
-        order->nticks_bracket_orders = nticks_bracket_type::New(*cp1 ,*cp2);
+        order->nticks_bracket_orders =
+            nticks_bracket_type::New(_nticks_bracket_pool, *cp1 ,*cp2);
     }else{
-        order->price_bracket_orders = price_bracket_type::New(*cp1, *cp2);
+        order->price_bracket_orders =
+            price_bracket_type::New(_price_bracket_pool, *cp1, *cp2);
     }
 
     order->condition = e.condition;
@@ -601,11 +625,11 @@ SOB_CLASS::_insert_active_bracket_order(const order_queue_elem& e)
 
     /* link each order with the other */
     if( IsTrailing ){
-        order1->linked_order =  new trailing_order_link(id2, false, 0);
-        order2.linked_order = new trailing_order_link(e.id, true, nticks);
+        order1->linked_order = _link_pool.acquire(id2, false, size_t(0));
+        order2.linked_order = _link_pool.acquire(e.id, true, nticks);
     }else{
-        order1->linked_order = new order_link(id2, false);
-        order2.linked_order = new order_link(e.id, true);
+        order1->linked_order = _link_pool.acquire(id2, false);
+        order2.linked_order = _link_pool.acquire(e.id, true);
     }
 
     /* transfer condition/trigger info */
@@ -655,10 +679,11 @@ SOB_CLASS::_insert_TRAILING_STOP_order(const order_queue_elem& e)
     auto& order = _id_cache.at(e.id);
     assert( order );
 
-    auto cp1 = e.cparams1->copy_new();
+    OrderParamatersStorage cp1 = e.cparams1;
     cp1->change_size( cp1->size() - filled );
 
-    order->contingent_nticks_order = contingent_nticks_order_type::New(*cp1);
+    order->contingent_nticks_order =
+        contingent_nticks_order_type::New(_contingent_nticks_pool, *cp1);
     order->condition = e.condition;
     order->trigger = e.trigger;
 }
@@ -733,6 +758,60 @@ SOB_CLASS::_insert_ALL_OR_NONE_order(const order_queue_elem& e)
 }
 
 
+void
+SOB_CLASS::_insert_ICEBERG_order(const order_queue_elem& e)
+{
+    assert( detail::order::is_limit(e) );
+    assert( e.cparams1 );
+
+    /* trade the full size on the way in, like any other limit */
+    size_t filled = _route_basic_order<>(e, true);
+    if( filled == e.sz )
+        return;
+
+    /* only show 'display' of what's left; the rest goes in reserve */
+    auto& order = _id_cache.at(e.id);
+    assert( order );
+
+    size_t display = e.cparams1->size();
+    size_t rmndr = order->sz;
+    order->iceberg.display = display;
+    if( rmndr > display ){
+        order->iceberg.reserve = rmndr - display;
+        order->sz = display;
+        _book_delta_resize(order);
+    }
+}
+
+
+void
+SOB_CLASS::_insert_PEGGED_order(const order_queue_elem& e)
+{
+    assert( detail::order::is_limit(e) );
+    assert( e.cparams1 );
+    assert( e.cparams1->is_by_nticks() );
+
+    size_t nticks = e.cparams1->limit_nticks();
+
+    /* rest at the pegged price (the limit if there's nothing to peg to) */
+    order_queue_elem pe(e);
+    pe.limit = _itop( _peg_plevel(e.is_buy, e.condition, nticks, e.limit,
+                                  _peg_reference<true>(),
+                                  _peg_reference<false>()) );
+
+    size_t filled = _route_basic_order<>(pe, true);
+    if( filled == e.sz )
+        return;
+
+    auto& order = _id_cache.at(e.id);
+    assert( order );
+
+    order->pegged.nticks = nticks;
+    order->pegged.limit = e.limit;
+    _pegged_orders.insert(e.id);
+}
+
+
 void
 SOB_CLASS::_trailing_stop_insert(id_type id, bool is_buy)
 {
@@ -797,10 +876,9 @@ SOB_CLASS::_trailing_stop_adjust(id_type id, bool buy_stop, plevel p)
     bool is_ats = order::is_active_trailing_stop(bndl);
     assert( is_ats || order::is_active_trailing_bracket(bndl) );
     assert( is_ats || bndl.linked_order );
+    assert( is_ats || bndl.linked_order->is_trailing() );
 
-    size_t nticks = is_ats
-        ? bndl.nticks
-        : dynamic_cast<trailing_order_link*>(bndl.linked_order)->nticks;
+    size_t nticks = is_ats ? bndl.nticks : bndl.linked_order->nticks;
 
     plevel p_adj = _plevel_offset<true>(buy_stop, nticks, p);
     double price = _itop(p_adj);
@@ -814,6 +892,160 @@ SOB_CLASS::_trailing_stop_adjust(id_type id, bool buy_stop, plevel p)
 }
 
 
+void
+SOB_CLASS::_adjust_pegged_orders()
+{
+    if( _pegged_orders.empty() )
+        return;
+
+    plevel bid_ref = _peg_reference<true>();
+    plevel ask_ref = _peg_reference<false>();
+
+    /* only re-price if the reference/inside prices have changed */
+    auto inside = _peg_inside_now(bid_ref, ask_ref);
+    if( inside == _peg_inside )
+        return;
+
+    /* re-pricing changes the set (and the book) so work off a copy */
+    std::vector<id_type> ids(_pegged_orders.begin(), _pegged_orders.end());
+    for( id_type id : ids ){
+        auto iwrap = _id_cache.find(id);
+        if( iwrap == _id_cache.end() || !iwrap->second.is_limit() ){
+            /* filled (or moved to the aon chain) */
+            _pegged_orders.erase(id);
+            continue;
+        }
+
+        plevel p = iwrap->second.p;
+        const limit_bndl& bndl = *(iwrap->second.l_iter);
+        bool is_buy = _is_buy_order(p, bndl);
+
+        plevel p_adj = _peg_plevel(is_buy, bndl.condition, bndl.pegged.nticks,
+                                   bndl.pegged.limit, bid_ref, ask_ref);
+        if( p_adj != p )
+            _reprice_pegged_order(id, is_buy, p_adj);
+    }
+
+    /* our own re-pricing can move the inside; don't chase it */
+    _peg_inside = _peg_inside_now(bid_ref, ask_ref);
+}
+
+
+void
+SOB_CLASS::_reprice_pegged_order(id_type id, bool is_buy, plevel p)
+{
+    using namespace detail;
+
+    /* (temporarily) remove the order; loses time priority */
+    limit_bndl bndl = chain<limit_chain_type>::pop(this, id);
+    assert( bndl );
+    assert( order::is_pegged(bndl) );
+
+    pegged_type pegged = bndl.pegged;
+    double price = _itop(p);
+
+    _push_exec_callback( callback_msg::trigger_PEG_adj, bndl.cb, id, id,
+                         price, bndl.sz );
+
+    /* go through the limit path so AONs that can now fill will */
+    order_queue_elem e( order_type::limit, is_buy, price, 0, bndl.sz, bndl.cb,
+                        id, bndl.condition, bndl.trigger );
+    _route_basic_order<>(e, true);
+
+    try{
+        _from_cache(id)->pegged = pegged;
+    }catch( OrderNotInCache& ){
+        _pegged_orders.erase(id);
+    }
+}
+
+
+/* the best price level w/ a (non-AON) order that isn't itself pegged */
+template<bool BidSide>
+SOB_CLASS::plevel
+SOB_CLASS::_peg_reference() const
+{
+    using namespace detail;
+
+    if( BidSide ){
+        for( plevel p = _bid; p >= _beg && p >= _low_buy_limit; --p ){
+            if( chain<limit_chain_type>::atleast_if(p, 1,
+                                                    order::is_not_pegged_or_AON) )
+                return p;
+        }
+    }else{
+        for( plevel p = _ask; p < _end && p <= _high_sell_limit; ++p ){
+            if( chain<limit_chain_type>::atleast_if(p, 1,
+                                                    order::is_not_pegged_or_AON) )
+                return p;
+        }
+    }
+    return nullptr;
+}
+template SOB_CLASS::plevel SOB_CLASS::_peg_reference<true>() const;
+template SOB_CLASS::plevel SOB_CLASS::_peg_reference<false>() const;
+
+
+SOB_CLASS::plevel
+SOB_CLASS::_peg_plevel( bool buy,
+                        order_condition condition,
+                        size_t nticks,
+                        double limit,
+                        plevel bid_ref,
+                        plevel ask_ref ) const
+{
+    /* work in indices so offsets can't walk a pointer off the book */
+    long long ref = -1;
+    long long half = 0;
+
+    switch( condition ){
+    case order_condition::primary_peg:
+        if( buy ? bid_ref : ask_ref )
+            ref = (buy ? bid_ref : ask_ref) - _beg;
+        break;
+    case order_condition::market_peg:
+        if( buy ? ask_ref : bid_ref )
+            ref = (buy ? ask_ref : bid_ref) - _beg;
+        break;
+    case order_condition::mid_peg:
+        if( bid_ref && ask_ref ){
+            half = (ask_ref - bid_ref) / 2;
+            ref = buy ? (bid_ref - _beg) + half : (ask_ref - _beg) - half;
+        }
+        break;
+    default:
+        throw std::runtime_error("invalid peg condition");
+    };
+
+    long long cap = _ptoi(limit) - _beg;
+    long long i = cap;
+    if( ref >= 0 ){
+        long long n = static_cast<long long>(nticks);
+        i = buy ? std::min(ref - n, cap) : std::max(ref + n, cap);
+    }
+
+    /* never cross the other side */
+    if( buy && _ask < _end )
+        i = std::min<long long>(i, (_ask - _beg) - 1);
+    else if( !buy && _bid >= _beg )
+        i = std::max<long long>(i, (_bid - _beg) + 1);
+
+    i = std::max<long long>(i, 0);
+    i = std::min<long long>(i, (_end - _beg) - 1);
+    return _beg + i;
+}
+
+
+std::tuple<double, double, double, double>
+SOB_CLASS::_peg_inside_now(plevel bid_ref, plevel ask_ref) const
+{
+    return std::make_tuple( bid_ref ? _itop(bid_ref) : 0.0,
+                            ask_ref ? _itop(ask_ref) : 0.0,
+                            (_bid >= _beg) ? _itop(_bid) : 0.0,
+                            (_ask < _end) ? _itop(_ask) : 0.0 );
+}
+
+
 AdvancedOrderTicket
 SOB_CLASS::_bndl_to_aot(const _order_bndl& bndl) const
 {
@@ -843,6 +1075,14 @@ SOB_CLASS::_bndl_to_aot(const _order_bndl& bndl) const
         aot.change_order1( bndl.price_bracket_orders->first );
         aot.change_order2( bndl.price_bracket_orders->second );
         break;
+    case order_condition::iceberg:
+        aot.change_order1( OrderParamatersByPrice(0, bndl.iceberg.display, 0, 0) );
+        break;
+    case order_condition::primary_peg: /* no break */
+    case order_condition::market_peg: /* no break */
+    case order_condition::mid_peg:
+        aot.change_order1( OrderParamatersByNTicks(0, 0, bndl.pegged.nticks, 0) );
+        break;
     case order_condition::fill_or_kill: /* no break */
     case order_condition::_trailing_stop_active: /* no break */
         // TODO does active TS need to convert 'nticks' to Order Params ??
@@ -866,29 +1106,37 @@ SOB_CLASS::_bndl_to_aot(const _order_bndl& bndl) const
 }
 
 
-std::pair<std::unique_ptr<OrderParamaters>,
-          std::unique_ptr<OrderParamaters>>
+std::pair<OrderParamatersStorage, OrderParamatersStorage>
 SOB_CLASS::_build_advanced_params(bool buy,
                                   size_t size,
                                   const AdvancedOrderTicket& advanced) const
 {
-    std::unique_ptr<OrderParamaters> pp1;
-    std::unique_ptr<OrderParamaters> pp2;
+    /* built in place (NRVO); no copies of the storage out of here */
+    std::pair<OrderParamatersStorage, OrderParamatersStorage> pp;
 
     switch( advanced.condition() ){
     case order_condition::trailing_bracket:
-        pp2 = _build_nticks_params(!buy, size, advanced.order2());
+        pp.second = _build_nticks_params(!buy, size, advanced.order2());
         /* no break */
     case order_condition::trailing_stop:
-        pp1 = _build_nticks_params(!buy, size, advanced.order1());
+        pp.first = _build_nticks_params(!buy, size, advanced.order1());
         break;
     case order_condition::bracket:
-        pp1 = _build_price_params(size, advanced.order1());
-        pp2 = _build_price_params(size, advanced.order2());
+        pp.first = _build_price_params(size, advanced.order1());
+        pp.second = _build_price_params(size, advanced.order2());
         break;
     case order_condition::one_triggers_other: /* no break */
     case order_condition::one_cancels_other:
-        pp1 = _build_price_params(advanced.order1()->size(), advanced.order1());
+        pp.first = _build_price_params(advanced.order1()->size(),
+                                       advanced.order1());
+        break;
+    case order_condition::iceberg:
+        pp.first = OrderParamatersByPrice(buy, advanced.order1()->size(), 0, 0);
+        break;
+    case order_condition::primary_peg: /* no break */
+    case order_condition::market_peg: /* no break */
+    case order_condition::mid_peg:
+        pp.first = _build_nticks_params(buy, size, advanced.order1());
         break;
     case order_condition::fill_or_kill:
     case order_condition::all_or_none:
@@ -897,11 +1145,11 @@ SOB_CLASS::_build_advanced_params(bool buy,
         throw advanced_order_error("invalid order condition");
     };
 
-    return std::make_pair(std::move(pp1), std::move(pp2));
+    return pp;
 }
 
 
-std::unique_ptr<OrderParamaters>
+OrderParamatersStorage
 SOB_CLASS::_build_nticks_params(bool buy,
                                size_t size,
                                const OrderParamaters *order) const
@@ -917,15 +1165,12 @@ SOB_CLASS::_build_nticks_params(bool buy,
         throw advanced_order_error("stop_nticks too large");
     }
 
-    return std::unique_ptr<OrderParamaters>(
-            new OrderParamatersByNTicks(
-                buy, size, order->limit_nticks(), order->stop_nticks()
-                )
-    );
+    return OrderParamatersByNTicks( buy, size, order->limit_nticks(),
+                                    order->stop_nticks() );
 }
 
 
-std::unique_ptr<OrderParamaters>
+OrderParamatersStorage
 SOB_CLASS::_build_price_params(size_t size, const OrderParamaters *order) const
 {
     assert( order->is_by_price() );
@@ -955,18 +1200,14 @@ SOB_CLASS::_build_price_params(size_t size, const OrderParamaters *order) const
         throw advanced_order_error(e);
     }
 
-    return std::unique_ptr<OrderParamaters>(
-            new OrderParamatersByPrice(
-                order->is_buy(), size, limit, stop
-                )
-    );
+    return OrderParamatersByPrice( order->is_buy(), size, limit, stop );
 }
 
 
 void
 SOB_CLASS::_check_limit_order( bool buy,
                                double limit,
-                               std::unique_ptr<OrderParamaters>& op,
+                               const OrderParamatersStorage& op,
                                order_condition oc) const
 {
     assert( op->is_by_price() );
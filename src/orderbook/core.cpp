@@ -49,12 +49,23 @@ SOB_CLASS::SimpleOrderbookBase(
         std::function<double(plevel)> itop,
         std::function<plevel(double)> ptoi,
         std::function<long long(double, double)> ticks_in_range,
-        std::function<bool(double)> is_valid_price )
+        std::function<bool(double)> is_valid_price,
+        std::function<bool(double)> auto_grow,
+        std::function<bool(plevel, plevel)> shrink_book,
+        detail::dispatcher_shard *shard,
+        bool inline_exec )
     :
+        /* pools for advanced order objects */
+        _link_pool(),
+        _price_bracket_pool(),
+        _nticks_bracket_pool(),
+        _contingent_price_pool(),
+        _contingent_nticks_pool(),
         /* actual orderbook object */
-        _book(incr + 1), /*pad the beg side */
-        _beg( &(*_book.begin()) + 1 ),
-        _end( &(*_book.end())),
+        _book(incr + 1, /*pad the beg side */
+              decltype(_book)::default_headroom(incr + 1)),
+        _beg( _book.begin() + 1 ),
+        _end( _book.end() ),
         /* internal pointers for faster lookups */
         _last( 0 ),
         _bid( _beg - 1),
@@ -73,11 +84,36 @@ SOB_CLASS::SimpleOrderbookBase(
         _id_cache(),
         _trailing_sell_stops(),
         _trailing_buy_stops(),
+        _pegged_orders(),
+        _peg_inside(),
         /* internal trade stats */
         _total_volume(0),
         _last_id(0),
         _last_size(0),
-        _timesales(),
+        _timesales( std::make_shared<detail::timesales_ring>() ),
+        /* book deltas (off) */
+        _deltas(),
+        _pending_deltas(),
+        _touched_levels(),
+        _published_bids(),
+        _published_asks(),
+        _delta_batch(0),
+        /* conflated depth (no subscribers) */
+        _depth_dirty_on(false),
+        _dirty_levels(),
+        _depth_state(),
+        _depth_subs(),
+        _last_depth_sub_id(0),
+        _depth_sub_mtx(),
+        _depth_sub_cond(),
+        _depth_publisher_run(false),
+        _depth_publisher_thread(),
+        _depth_in_cb(0),
+        _depth_cb_done_cond(),
+        /* latency stats (off) */
+        _latency(),
+        _latency_on(false),
+        _counters(),
         /* sync callbacks */
         _callbacks_sync(),
         /* async callbacks */
@@ -86,6 +122,9 @@ SOB_CLASS::SimpleOrderbookBase(
         _async_callback_cond(),
         _async_callback_done_cond(),
         _async_callbacks_done(true),
+        _callback_pool( inline_exec ? nullptr : detail::callback_pool::get() ),
+        _async_cb_client(this),
+        _async_cb_scheduled(false),
         /* our threaded approach to order queuing/exec */
         _external_order_queue(),
         _external_order_queue_mtx(),
@@ -95,13 +134,41 @@ SOB_CLASS::SimpleOrderbookBase(
         /* core sync objects */
         _master_mtx(),
         _master_run_flag(true),
+        _order_dispatcher_thread(),
+        _shard(shard),
+        _inline(inline_exec),
+        _shard_scheduled(false),
+        _shard_async_cb_thread(),
         /* price <-> tick conversion functions */
         _itop(itop),
         _ptoi(ptoi),
         _ticks_in_range(ticks_in_range),
-        _is_valid_price(is_valid_price)
+        _is_valid_price(is_valid_price),
+        _auto_grow(auto_grow),
+        _shrink_book(shrink_book),
+        /* auto-grow/recenter policies */
+        _auto_grow_factor(0),
+        _auto_grow_max_ticks(0),
+        _growth_cb(),
+        _recenter_margin(0),
+        _recenter_backoff(0),
+        _journal()
     {
+        if( _inline ){
+            /* no threads; everything happens in the caller's */
+            return;
+        }
+        if( _shard ){
+            _shard_async_cb_thread.reset( new AsyncCallbackThreadGuard(this) );
+            /*** DONT THROW AFTER THIS POINT ***/
+            _shard->attach();
+            if( _callback_pool )
+                _callback_pool->attach();
+            return;
+        }
         /*** DONT THROW AFTER THIS POINT ***/
+        if( _callback_pool )
+            _callback_pool->attach();
         _order_dispatcher_thread =
             std::thread(std::bind(&SOB_CLASS::_threaded_order_dispatcher,this));
     }
@@ -109,8 +176,17 @@ SOB_CLASS::SimpleOrderbookBase(
 
 SOB_CLASS::~SimpleOrderbookBase()
     {
+        _stop_depth_publisher();
         _master_run_flag = false;
+        if( _inline )
+            return;
         try{
+            if( _shard ){
+                /* out of line (and not being run) after this */
+                _shard->detach(this);
+                _shard_async_cb_thread.reset();
+                return;
+            }
             {
                 std::lock_guard<std::mutex> lock(_external_order_queue_mtx);
                 _external_order_queue.emplace();
@@ -155,6 +231,39 @@ SOB_CLASS::_threaded_order_dispatcher()
 }
 
 
+/*
+ * called by our shard's thread (once we've been scheduled) to run queued
+ * orders, up to 'max' at a time; if we return true we're still in line
+ */
+bool
+SOB_CLASS::run_queued(size_t max)
+{
+    for( size_t i = 0; i < max; ++i ){
+        external_order_queue_elem e;
+        {
+            std::lock_guard<std::mutex> lock(_external_order_queue_mtx);
+            if( _external_order_queue.empty() || !_master_run_flag ){
+                _shard_scheduled = false;
+                return false;
+            }
+            e = std::move(_external_order_queue.front());
+            _external_order_queue.pop();
+        }
+
+        e.cb.is_synchronous()
+            ? _dispatch_external_order(e, std::move(e.promise_sync) )
+            : _dispatch_external_order(e, std::move(e.promise_async) );
+    }
+
+    std::lock_guard<std::mutex> lock(_external_order_queue_mtx);
+    if( _external_order_queue.empty() ){
+        _shard_scheduled = false;
+        return false;
+    }
+    return true;
+}
+
+
 template<typename T>
 void
 SOB_CLASS::_dispatch_external_order( const external_order_queue_elem& ee,
@@ -162,12 +271,25 @@ SOB_CLASS::_dispatch_external_order( const external_order_queue_elem& ee,
 {
     id_type ret;
     callback_queue_type copies;
+#ifndef SOB_NO_LATENCY_STATS
+    uint64_t t_picked = ee.t_queued ? _latency_now() : 0;
+    uint64_t t_locked = 0, t_executed = 0;
+#endif
 
     try{
          /* --- CRITICAL SECTION --- */
-         std::lock_guard<std::mutex> lock(_master_mtx);
+         _lock_master_for_order();
+         std::lock_guard<std::mutex> lock(_master_mtx, std::adopt_lock);
 
+#ifndef SOB_NO_LATENCY_STATS
+         if( t_picked )
+             t_locked = detail::latency_clock::now();
+#endif
          ret = _execute_external_order( ee );
+#ifndef SOB_NO_LATENCY_STATS
+         if( t_picked )
+             t_executed = detail::latency_clock::now();
+#endif
 
          if( detail::promise_helper<T>::is_synchronous ){
              copies = _callbacks_sync;
@@ -184,14 +306,62 @@ SOB_CLASS::_dispatch_external_order( const external_order_queue_elem& ee,
          return;
      }
 
-     promise.set_value( detail::promise_helper<T>::build_value(ret, copies) );
+     auto value = detail::promise_helper<T>::build_value(ret, copies);
+
+#ifndef SOB_NO_LATENCY_STATS
+     /*
+      * before the caller can go on (and look), so they're up to date w/ it;
+      * it may have been turned off since
+      */
+     if( t_picked && _latency_on.load(std::memory_order_relaxed) ){
+         uint64_t t_fulfilled = detail::latency_clock::now();
+         _record_latency(latency_stage::queue, ee.t_queued, t_picked);
+         _record_latency(latency_stage::lock, t_picked, t_locked);
+         _record_latency(latency_stage::execute, t_locked, t_executed);
+         _record_latency(latency_stage::fulfil, t_executed, t_fulfilled);
+         _record_latency(latency_stage::total, ee.t_queued, t_fulfilled);
+     }
+#endif
+
+     promise.set_value( std::move(value) );
 }
 
 id_type
 SOB_CLASS::_execute_external_order(const external_order_queue_elem& ee)
+{
+    if( !_deltas )
+        return _do_execute_external_order(ee);
+
+    /* whatever it did to the book gets published, even if it throws */
+    id_type ret;
+    try{
+        ret = _do_execute_external_order(ee);
+    }catch(...){
+        _flush_book_deltas();
+        throw;
+    }
+    _flush_book_deltas();
+    return ret;
+}
+
+
+id_type
+SOB_CLASS::_do_execute_external_order(const external_order_queue_elem& ee)
 {
     id_type ret = 1;
 
+    engine_counters::add(_counters.orders_external);
+    if( _auto_grow_factor > 0 )
+        _auto_grow_for(ee);
+
+    /*
+     * after any growth it needed (journaled by the growth) and before
+     * anything it sets off (a recenter); internal orders aren't journaled,
+     * replaying this re-generates them
+     */
+    _journal_append( detail::journal_record(ee.type, ee.is_buy, ee.limit,
+                                            ee.stop, ee.sz, ee.id, ee.aot) );
+
     if( ee.id ){
         if( ee.type != order_type::null ) { // REPLACE
             order_queue_elem qe(ee, this);
@@ -202,6 +372,9 @@ SOB_CLASS::_execute_external_order(const external_order_queue_elem& ee)
            qe.id = _generate_id();
             _insert_order(qe);
             ret = qe.id; // return new order ID
+        }else if( ee.sz ){ // MODIFY
+            if( !_modify_order(ee.id, ee.sz, ee.limit) )
+                return 0;
         }else{ // PULL
             if( !_pull_order(ee.id, true) )
                 return 0;
@@ -213,19 +386,101 @@ SOB_CLASS::_execute_external_order(const external_order_queue_elem& ee)
         ret = qe.id; // return new order ID
     }
 
-    /* internally generated orders */
-    while( !_internal_order_queue.empty() ){
-        order_queue_elem& ie = _internal_order_queue.front();
-        if( !ie.id )
-           ie.id = _generate_id();
-        _insert_order(ie);
-        _internal_order_queue.pop();
+    /* internally generated orders (re-pegging can generate more) */
+    unsigned long long ninternal = 0;
+    do{
+        while( !_internal_order_queue.empty() ){
+            engine_counters::raise( _counters.internal_queue_hwm,
+                                    _internal_order_queue.size() );
+            order_queue_elem& ie = _internal_order_queue.front();
+            if( !ie.id )
+               ie.id = _generate_id();
+            _insert_order(ie);
+            _internal_order_queue.pop();
+            ++ninternal;
+        }
+        _adjust_pegged_orders();
+    }while( !_internal_order_queue.empty() );
+
+    if( ninternal ){
+        engine_counters::add(_counters.orders_internal, ninternal);
+        engine_counters::add(_counters.cascades);
+        engine_counters::raise(_counters.cascade_max, ninternal);
     }
 
+    if( _recenter_margin )
+        _auto_recenter();
+
     return ret;
 }
 
 
+void
+SOB_CLASS::_auto_grow_for(const external_order_queue_elem& e)
+{
+    /*
+     * PART OF THE ENCLOSING CRITICAL SECTION
+     *
+     * nothing is built (no plevels are held) yet so the book can move
+     */
+    auto grow_for = [this](double price){
+        if( price && !_is_valid_price(price) )
+            _auto_grow(price);
+    };
+
+    grow_for(e.limit);
+    grow_for(e.stop);
+    for( const OrderParamaters *op : {e.aot.order1(), e.aot.order2()} ){
+        if( op && op->is_by_price() ){
+            grow_for(op->limit_price());
+            grow_for(op->stop_price());
+        }
+    }
+}
+
+
+void
+SOB_CLASS::_auto_recenter()
+{
+    /* PART OF THE ENCLOSING CRITICAL SECTION */
+    if( _recenter_backoff ){
+        --_recenter_backoff;
+        return;
+    }
+
+    /* outermost (cached) order levels and the last trade */
+    plevel lo = _end;
+    plevel hi = _beg - 1;
+    for( plevel p : { _last, _bid, _ask, _low_buy_limit, _high_sell_limit,
+                      _low_buy_stop, _high_buy_stop, _low_sell_stop,
+                      _high_sell_stop, _low_buy_aon, _high_buy_aon,
+                      _low_sell_aon, _high_sell_aon } )
+    {
+        if( p && p >= _beg && p < _end ){
+            lo = std::min(lo, p);
+            hi = std::max(hi, p);
+        }
+    }
+    if( lo > hi ) // nothing to center on
+        return;
+
+    long m = static_cast<long>(_recenter_margin);
+    long below = lo - _beg;
+    long above = (_end - 1) - hi;
+    if( below <= 2 * m && above <= 2 * m )
+        return;
+
+    plevel new_beg = (below > m) ? lo - m : _beg;
+    plevel new_end = (above > m) ? hi + m + 1 : _end;
+    if( new_end - new_beg < 3 )
+        return;
+
+    /* advanced orders w/ prices out there; try again later */
+    if( !_shrink_book(new_beg, new_end) )
+        _recenter_backoff = RECENTER_BACKOFF;
+}
+
+
 void
 SOB_CLASS::_insert_order(order_queue_elem& e)
 {
@@ -271,6 +526,10 @@ SOB_CLASS::_route_basic_order(const order_queue_elem& e, bool pass_conditions)
     case order_type::stop_limit:
         _insert_stop_order<IsBuy>(e, pass_conditions);
         return 0;
+    case order_type::fill_or_kill:
+        return _insert_immediate_order<IsBuy>(e, false);
+    case order_type::immediate_or_cancel:
+        return _insert_immediate_order<IsBuy>(e, true);
     default:
         throw std::runtime_error("invalid order type in order_queue");
     }
@@ -315,11 +574,13 @@ SOB_CLASS::_trade( plevel plev,
     plevel low_last = _last;
     plevel p = CORE::begin(this);
     plevel end = CORE::end(this); // ALL orders must go thru queue
+    unsigned long long nlevels = 0;
 
     while( size
            && CORE::inside_of(p, plev)
            && CORE::inside_of(p, end) )
     {
+        ++nlevels;
         if( AON::in_window(this, p) ){
             /* first, match against the AON chain */
             aon_chain_type *ac = p->aon_chain<BidSide>().get();
@@ -357,6 +618,10 @@ SOB_CLASS::_trade( plevel plev,
         p = CORE::next_or_jump(this, p);
     }
 
+    engine_counters::add(_counters.trades);
+    engine_counters::add(_counters.levels_scanned, nlevels);
+    engine_counters::raise(_counters.levels_scanned_max, nlevels);
+
     /*
      * dont need to check that old != 0; in order to have an active
      * trailing_stop we must have had an initial trade
@@ -378,6 +643,12 @@ SOB_CLASS::_trade( plevel plev,
     return size; /* what we couldn't fill */
 }
 
+template size_t
+SOB_CLASS::_trade<true>(plevel, id_type, size_t, const order_exec_cb_bndl&);
+
+template size_t
+SOB_CLASS::_trade<false>(plevel, id_type, size_t, const order_exec_cb_bndl&);
+
 
 /*
  *  handles all trades against the limit chain at a particular plevel; a
@@ -398,13 +669,17 @@ SOB_CLASS::_hit_chain( limit_chain_type *lchain,
     auto pos = lchain->begin();
     assert( order::is_limit(*pos) );
 
-    for( ; pos != lchain->end() && size > 0; ++pos )
+    /* (what's resting here, for book deltas) */
+    bool is_buy = _is_buy_order(plev, *pos);
+
+    while( pos != lchain->end() && size > 0 )
     {
         /* if AON need to make sure enough size  */
         if( order::is_AON(*pos) ){
             if( size < pos->sz ){ /* if not, move to aon chain */
                 chain<limit_chain_type>::copy_bndl_to_aon_chain(this, plev, pos);
-                pos->sz = 0; // signal erase if last
+                pos->sz = 0; // signal erase
+                ++pos;
                 continue;
             }
         }
@@ -430,16 +705,39 @@ SOB_CLASS::_hit_chain( limit_chain_type *lchain,
         }
 
         /* remaining (adjust after we handle advanced conditions) */
+        _book_delta(book_delta::type::order_execute, plev, is_buy, *pos, amount);
         pos->sz -= amount;
 
-        /* remove from cache if none left */
-        if( pos->sz == 0 )
+        if( pos->sz == 0 ){
+            if( order::is_iceberg(*pos) && pos->iceberg.reserve ){
+                /*
+                 * replenish in place and re-queue at the back of the level;
+                 * splice keeps the node (and the iterator in _id_cache) valid
+                 */
+                size_t n = std::min(pos->iceberg.display, pos->iceberg.reserve);
+                pos->iceberg.reserve -= n;
+                pos->sz = n;
+                _book_delta(book_delta::type::order_add, plev, is_buy, *pos, n);
+                auto next = std::next(pos);
+                if( next != lchain->end() ){
+                    lchain->splice(lchain->end(), *lchain, pos);
+                    pos = next;
+                }
+                continue;
+            }
+            /* remove from cache if none left */
             _id_cache.erase(pos->id);
+        }
+        ++pos;
     }
 
-    /* backup to see if last order was completely filled, if so re-incr */
-    --pos;
-    auto r = lchain->erase( lchain->begin(), (pos->sz ? pos : ++pos) );
+    /*
+     * everything filled (or moved to the aon chain) is at the front;
+     * replenished icebergs were moved behind anything we hadn't reached
+     */
+    for( pos = lchain->begin(); pos != lchain->end() && pos->sz == 0; ++pos )
+    {}
+    auto r = lchain->erase( lchain->begin(), pos );
     return std::make_pair(size, r == lchain->end());
 }
 
@@ -490,11 +788,12 @@ SOB_CLASS::_trade_has_occured( plevel plev,
     _push_exec_callback(callback_msg::fill, cbbuy, idbuy, idbuy, p, size);
     _push_exec_callback(callback_msg::fill, cbsell, idsell, idsell, p, size);
 
-    _timesales.push_back( std::make_tuple(clock_type::now(), p, size) );
+    _timesales->push(clock_type::now(), p, size);
     _last = plev;
     _total_volume += size;
     _last_size = size;
     _need_check_for_stops = true;
+    engine_counters::add(_counters.matches);
 }
 
 
@@ -680,6 +979,30 @@ SOB_CLASS::_insert_market_order(const order_queue_elem& e)
 }
 
 
+/*
+ * FOK/IOC: check the aggregate depth up front, match what we can and kill
+ * the rest; these NEVER rest on the book so there is no need for AON
+ * overlap checks, the cache or an advanced ticket.
+ */
+template<bool BuyLimit>
+size_t
+SOB_CLASS::_insert_immediate_order(const order_queue_elem& e, bool allow_partial)
+{
+    assert( detail::order::is_immediate(e) );
+    plevel p = _ptoi(e.limit);
+
+    size_t rmndr = e.sz;
+    if( _limit_is_fillable<BuyLimit>(p, e.sz, allow_partial).first )
+        rmndr = _trade<!BuyLimit>(p, e.id, e.sz, e.cb);
+
+    assert( allow_partial || rmndr == 0 || rmndr == e.sz );
+    if( rmndr )
+        _push_exec_callback(callback_msg::kill, e.cb, e.id, e.id, e.limit, rmndr);
+
+    return e.sz - rmndr;
+}
+
+
 template<bool BuyStop>
 void
 SOB_CLASS::_insert_stop_order(const order_queue_elem& e, bool pass_conditions)
@@ -726,11 +1049,29 @@ template<typename... Args>
 void
 SOB_CLASS::_push_async_callback(Args&&... args)
 {
+    bool schedule = false;
+#ifndef SOB_NO_LATENCY_STATS
+    uint64_t t_pushed = _latency_now();
+#endif
     {
         std::lock_guard<std::mutex> lock(_async_callback_mtx);
         _callbacks_async.emplace_back( std::forward<Args>(args)... );
+#ifndef SOB_NO_LATENCY_STATS
+        _callbacks_async.back().t_pushed = t_pushed;
+#endif
+        engine_counters::raise( _counters.async_callback_hwm,
+                                _callbacks_async.size() );
+        /* get in line w/ the pool, if we aren't already */
+        if( _callback_pool && !_async_cb_scheduled ){
+            _async_cb_scheduled = schedule = true;
+        }
+    }
+
+    if( schedule ){
+        _callback_pool->schedule(&_async_cb_client);
+    }else if( !_callback_pool ){
+        _async_callback_cond.notify_one();
     }
-    _async_callback_cond.notify_one();
 }
 
 
@@ -738,13 +1079,22 @@ SOB_CLASS::_push_async_callback(Args&&... args)
 SOB_CLASS::AsyncCallbackThreadGuard::AsyncCallbackThreadGuard(SOB_CLASS *sob)
     :
         _sob(sob),
-        _t( [=](){ sob->_threaded_async_callback_executor(); } )
+        _t()
     {
+        if( !sob->_callback_pool )
+            _t = std::thread( [=](){ sob->_threaded_async_callback_executor(); } );
     }
 
 // called by dispatcher thread
 SOB_CLASS::AsyncCallbackThreadGuard::~AsyncCallbackThreadGuard()
     {
+        if( _sob->_callback_pool ){
+            // run what's left (as the thread would), then get out of line
+            _sob->wait_for_async_callbacks();
+            _sob->_callback_pool->detach(&_sob->_async_cb_client);
+            return;
+        }
+
         // send NULL signal to async callback thread and wait
         _sob->_push_async_callback();
 
@@ -778,12 +1128,70 @@ SOB_CLASS::_threaded_async_callback_executor()
                 _notify_async_callbacks_done();
                 return;
             }
+#ifndef SOB_NO_LATENCY_STATS
+            if( b->t_pushed ){
+                _record_latency( latency_stage::callback, b->t_pushed,
+                                 detail::latency_clock::now() );
+            }
+#endif
             b->exec_cb( b->msg, b->id1, b->id2, b->price, b->sz );
         }
         _notify_async_callbacks_done();
     }
 }
 
+/*
+ * called by a callback pool thread (once we've been scheduled) to run
+ * queued callbacks, up to 'max' at a time; if we return true we're still
+ * in line
+ */
+bool
+SOB_CLASS::_run_async_callbacks(size_t max)
+{
+    callback_queue_type copies;
+    {
+        std::lock_guard<std::mutex> lock(_async_callback_mtx);
+        if( _callbacks_async.empty() ){
+            _async_cb_scheduled = false;
+            return false;
+        }
+        _async_callbacks_done = false;
+        auto e = _callbacks_async.begin()
+               + std::min(max, _callbacks_async.size());
+        copies.assign( std::make_move_iterator(_callbacks_async.begin()),
+                       std::make_move_iterator(e) );
+        _callbacks_async.erase(_callbacks_async.begin(), e);
+    }
+
+    for( const auto& c : copies ){
+        assert( c.exec_cb );
+#ifndef SOB_NO_LATENCY_STATS
+        if( c.t_pushed ){
+            _record_latency( latency_stage::callback, c.t_pushed,
+                             detail::latency_clock::now() );
+        }
+#endif
+        c.exec_cb( c.msg, c.id1, c.id2, c.price, c.sz );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_async_callback_mtx);
+        if( !_callbacks_async.empty() )
+            return true;
+        /* (done before another pool thread can pick us up again) */
+        _async_cb_scheduled = false;
+        _async_callbacks_done = true;
+    }
+    _async_callback_done_cond.notify_one();
+    return false;
+}
+
+
+bool
+SOB_CLASS::AsyncCallbackClient::run_queued(size_t max)
+{ return _sob->_run_async_callbacks(max); }
+
+
 void
 SOB_CLASS::_notify_async_callbacks_done()
 {
@@ -797,6 +1205,29 @@ SOB_CLASS::_notify_async_callbacks_done()
 void
 SOB_CLASS::wait_for_async_callbacks()
 {
+    if( _inline ){
+        /* no callback thread; the caller runs them */
+        for( ; ; ){
+            callback_queue_type copies;
+            {
+                std::lock_guard<std::mutex> lock(_async_callback_mtx);
+                if( _callbacks_async.empty() )
+                    return;
+                copies.swap(_callbacks_async);
+            }
+            for( const auto& c : copies ){
+                assert( c.exec_cb );
+#ifndef SOB_NO_LATENCY_STATS
+                if( c.t_pushed ){
+                    _record_latency( latency_stage::callback, c.t_pushed,
+                                     detail::latency_clock::now() );
+                }
+#endif
+                c.exec_cb( c.msg, c.id1, c.id2, c.price, c.sz );
+            }
+        }
+    }
+
     std::unique_lock<std::mutex> lock(_async_callback_mtx);
     if( !_async_callbacks_done || !_callbacks_async.empty() ){
         _async_callback_done_cond.wait(
@@ -806,6 +1237,97 @@ SOB_CLASS::wait_for_async_callbacks()
     }
 }
 
+void
+SOB_CLASS::set_auto_grow(double factor,
+                         size_t max_ticks,
+                         book_growth_cb_type growth_cb)
+{
+    if( factor < 0 )
+        throw std::invalid_argument("factor < 0");
+
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    _auto_grow_factor = factor;
+    _auto_grow_max_ticks = max_ticks;
+    _growth_cb = growth_cb;
+    /* --- CRITICAL SECTION --- */
+}
+
+void
+SOB_CLASS::set_auto_recenter(size_t margin)
+{
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    _recenter_margin = margin;
+    _recenter_backoff = 0;
+    /* --- CRITICAL SECTION --- */
+}
+
+void
+SOB_CLASS::start_journal(const std::string& path, unsigned commit_ms)
+{
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    if( _journal )
+        throw std::logic_error("journal already running");
+
+    detail::journal_header header{ tick_size(), _itop(_beg), _itop(_end - 1) };
+    _journal = std::make_shared<detail::journal_writer>(
+        path, header, std::chrono::milliseconds(commit_ms)
+        );
+    /* --- CRITICAL SECTION --- */
+}
+
+void
+SOB_CLASS::stop_journal()
+{
+    std::shared_ptr<detail::journal_writer> j;
+    {
+        std::lock_guard<std::mutex> lock(_master_mtx);
+        /* --- CRITICAL SECTION --- */
+        j.swap(_journal);
+        /* --- CRITICAL SECTION --- */
+    }
+    /* (outside the lock) writes what's left and joins the writer */
+    if( j )
+        j->sync();
+}
+
+void
+SOB_CLASS::sync_journal()
+{
+    std::shared_ptr<detail::journal_writer> j;
+    {
+        std::lock_guard<std::mutex> lock(_master_mtx);
+        /* --- CRITICAL SECTION --- */
+        j = _journal;
+        /* --- CRITICAL SECTION --- */
+    }
+    if( j )
+        j->sync();
+}
+
+void
+SOB_CLASS::set_time_and_sales(size_t capacity, const std::string& mmap_path)
+{
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    std::vector<timesale_entry_type> ts;
+    _timesales->read_since(0, ts);
+
+    size_t keep = std::min( ts.size(),
+                            detail::timesales_ring::rounded_capacity(capacity) );
+    auto ring = std::make_shared<detail::timesales_ring>(
+        capacity, mmap_path, _timesales->head() - keep
+        );
+    for( auto iter = ts.cend() - keep; iter != ts.cend(); ++iter )
+        ring->push( std::get<0>(*iter), std::get<1>(*iter), std::get<2>(*iter) );
+
+    /* readers still holding the old one finish w/ it */
+    std::atomic_store(&_timesales, ring);
+    /* --- CRITICAL SECTION --- */
+}
+
 /*
  *  CURRENTLY working under the constraint that stop priority goes:
  *     low price to high for buys
@@ -895,7 +1417,7 @@ SOB_CLASS::_handle_triggered_stop_chain(plevel plev)
             assert( e.contingent_nticks_order->params.is_by_nticks() );
             _push_internal_order( ot, e.is_buy, limit, 0, sz, cb, e.condition,
                                  e.trigger,
-                                 e.contingent_nticks_order->params.copy_new(),
+                                 e.contingent_nticks_order->params,
                                  nullptr, id_new, id );
         }
         else if( detail::order::is_trailing_bracket(e) )
@@ -904,8 +1426,8 @@ SOB_CLASS::_handle_triggered_stop_chain(plevel plev)
             assert( e.nticks_bracket_orders->second.is_by_nticks() );
             _push_internal_order( ot, e.is_buy, limit, 0, sz, cb, e.condition,
                                  e.trigger,
-                                 e.nticks_bracket_orders->first.copy_new(),
-                                 e.nticks_bracket_orders->second.copy_new(),
+                                 e.nticks_bracket_orders->first,
+                                 e.nticks_bracket_orders->second,
                                  id_new, id );
         }
         else
@@ -951,6 +1473,10 @@ SOB_CLASS::_push_external_order( order_type oty,
 {
     std::promise<T> p;
     std::future<T> f(p.get_future());
+    bool schedule = false;
+#ifndef SOB_NO_LATENCY_STATS
+    uint64_t t_queued = _latency_now();
+#endif
     {
         std::lock_guard<std::mutex> lock(_external_order_queue_mtx);
         /* --- CRITICAL SECTION --- */
@@ -958,13 +1484,64 @@ SOB_CLASS::_push_external_order( order_type oty,
             oty, buy, limit, stop, size,
             order_exec_cb_bndl{exec_cb, detail::promise_helper<T>::callback_type},
             id, aot, std::move(p) );
+#ifndef SOB_NO_LATENCY_STATS
+        _external_order_queue.back().t_queued = t_queued;
+#endif
+        engine_counters::raise( _counters.external_queue_hwm,
+                                _external_order_queue.size() );
+        /* get in line w/ our shard, if we aren't already */
+        if( _shard && !_shard_scheduled ){
+            _shard_scheduled = schedule = true;
+        }
         /* --- CRITICAL SECTION --- */
     }
-    _external_order_queue_cond.notify_one();
+
+    if( schedule ){
+        _shard->schedule(this);
+    }else if( !_shard ){
+        _external_order_queue_cond.notify_one();
+    }
 
     return f;
 }
 
+/*
+ * inline books: do what the dispatcher thread would, in the caller's thread,
+ * w/o the queue or a promise; (sync) callbacks from the window are left in
+ * _callbacks_sync for the caller
+ */
+id_type
+SOB_CLASS::_execute_inline( order_type oty,
+                            bool buy,
+                            double limit,
+                            double stop,
+                            size_t size,
+                            const order_exec_cb_bndl& cb,
+                            const AdvancedOrderTicket& aot,
+                            id_type id )
+{
+    const external_order_queue_elem e(oty, buy, limit, stop, size, cb, id, aot);
+    try{
+#ifndef SOB_NO_LATENCY_STATS
+        uint64_t t_start = _latency_now();
+#endif
+        id_type ret = _execute_external_order(e);
+#ifndef SOB_NO_LATENCY_STATS
+        /* no queue/lock/promise; we're still under the lock */
+        if( t_start ){
+            _record_latency( latency_stage::execute, t_start,
+                             detail::latency_clock::now() );
+        }
+#endif
+        _assert_internal_pointers();
+        return ret;
+    }catch(...){
+        while( !_internal_order_queue.empty() )
+             _internal_order_queue.pop();
+        throw;
+    }
+}
+
 /*
  * This can be called from multiple threads and will block until
  * the order is inserted (and contingent actions/insertions happen)
@@ -974,7 +1551,7 @@ SOB_CLASS::_push_external_order( order_type oty,
  * caller.
  *
  * inserts - return order ID
- * pulls - return success(failure) as 1(0)
+ * pulls, modifies - return success(failure) as 1(0)
  * replaces - return order ID on success, 0 on (pull) failure
  */
 id_type
@@ -989,6 +1566,26 @@ SOB_CLASS::_push_external_order_sync( order_type oty,
 {
     using T = std::pair<id_type,callback_queue_type>;
 
+    if( _inline ){
+        T p;
+        {
+            /* --- CRITICAL SECTION --- */
+            _lock_master_for_order();
+            std::lock_guard<std::mutex> lock(_master_mtx, std::adopt_lock);
+            p.first = _execute_inline(
+                oty, buy, limit, stop, size,
+                order_exec_cb_bndl{exec_cb, order_exec_cb_bndl::type::synchronous},
+                aot, id );
+            p.second.swap(_callbacks_sync);
+            /* --- CRITICAL SECTION --- */
+        }
+        for( const auto & e : p.second ){
+            assert( e.exec_cb );
+            e.exec_cb( e.msg, e.id1, e.id2, e.price, e.sz );
+        }
+        return p.first;
+    }
+
     std::future<T> f = _push_external_order<T>(
         oty, buy, limit, stop, size, exec_cb, aot, id
         );
@@ -1013,7 +1610,7 @@ SOB_CLASS::_push_external_order_sync( order_type oty,
  * IMMEDIATELY a seperate callback execution thread.
  *
  * inserts - return order ID
- * pulls - return success(failure) as 1(0)
+ * pulls, modifies - return success(failure) as 1(0)
  * replaces - return order ID on success, 0 on (pull) failure
  */
 std::future<id_type>
@@ -1026,6 +1623,24 @@ SOB_CLASS::_push_external_order_async( order_type oty,
                                        const AdvancedOrderTicket& aot,
                                        id_type id )
 {
+    if( _inline ){
+        /* (async) callbacks wait for wait_for_async_callbacks() */
+        std::promise<id_type> p;
+        try{
+            /* --- CRITICAL SECTION --- */
+            _lock_master_for_order();
+            std::lock_guard<std::mutex> lock(_master_mtx, std::adopt_lock);
+            p.set_value( _execute_inline(
+                oty, buy, limit, stop, size,
+                order_exec_cb_bndl{exec_cb, order_exec_cb_bndl::type::asynchronous},
+                aot, id ) );
+            /* --- CRITICAL SECTION --- */
+        }catch(...){
+            p.set_exception( std::current_exception() );
+        }
+        return p.get_future();
+    }
+
     return _push_external_order<id_type>(
         oty, buy, limit, stop, size, exec_cb, aot, id
         );
@@ -1041,14 +1656,13 @@ SOB_CLASS::_push_internal_order( order_type oty,
                                  const order_exec_cb_bndl& cb,
                                  order_condition cond,
                                  condition_trigger cond_trigger,
-                                 std::unique_ptr<OrderParamaters>&& cparams1,
-                                 std::unique_ptr<OrderParamaters>&& cparams2,
+                                 const OrderParamatersStorage& cparams1,
+                                 const OrderParamatersStorage& cparams2,
                                  id_type id,
                                  id_type parent_id)
 {
     _internal_order_queue.emplace(oty, buy, limit, stop, size, cb, id, cond,
-                                  cond_trigger, std::move(cparams1),
-                                  std::move(cparams2), parent_id);
+                                  cond_trigger, cparams1, cparams2, parent_id);
 }
 
 
@@ -1100,7 +1714,7 @@ SOB_CLASS::_limit_is_fillable( plevel p, size_t sz, bool allow_partial )
             auto *lc = chain<limit_chain_type>::get(b);
             if( lc) {
                 for( auto& elem : *lc ) {
-                    if( check_elem( elem.sz, order::is_AON(elem)) )
+                    if( check_elem( order::total_size(elem), order::is_AON(elem)) )
                         return {true, tot};
                 }
             }
@@ -1177,6 +1791,8 @@ SOB_CLASS::_pull_order(id_type id, bool pull_linked)
         /* remove trailing stops (no need to check if is trailing stop) */
         if( chain<ChainTy>::is_stop )
             _trailing_stop_erase(id, order::is_buy_stop(bndl));
+        else if( order::is_pegged(bndl) )
+            _pegged_orders.erase(id);
 
     }catch( OrderNotInCache& e ){
         return false;
@@ -1188,6 +1804,94 @@ template bool SOB_CLASS::_pull_order<SOB_CLASS::limit_chain_type>(id_type,  bool
 template bool SOB_CLASS::_pull_order<SOB_CLASS::stop_chain_type>(id_type, bool);
 
 
+bool
+SOB_CLASS::_modify_order(id_type id, size_t sz, double price)
+{
+    /* caller needs to hold lock on _master_mtx or race w/ callback queue */
+
+    using namespace detail;
+
+    if( !_in_cache(id) )
+        return false;
+
+    chain_iter_wrap& iwrap = _from_cache(id);
+    if( !iwrap.is_limit() || order::is_AON(*iwrap) )
+        return false;
+
+    limit_bndl& bndl = *iwrap.l_iter;
+    plevel p = iwrap.p;
+    plevel p_new = price ? _ptoi( _tick_price_or_throw(price, "invalid price") )
+                         : p;
+    bool is_buy = _is_buy_order(p, bndl);
+    bool is_pegged = order::is_pegged(bndl);
+
+    /* a new price that can trade goes through the limit path (same id) */
+    if( p_new != p && !is_pegged
+        && (is_buy ? exec::core<false>::is_tradable(this, p_new)
+                   : exec::core<true>::is_tradable(this, p_new)) )
+    {
+        if( order::is_advanced(bndl) )
+            throw advanced_order_error("advanced order can't be modified to a "
+                                       "price that trades; use replace");
+        limit_bndl b = chain<limit_chain_type>::pop(this, id);
+        _push_exec_callback(callback_msg::modify, b.cb, id, id, _itop(p_new), sz);
+        _route_basic_order<>( order_queue_elem(order_type::limit, is_buy,
+                                               _itop(p_new), 0, sz, b.cb, id) );
+        return true;
+    }
+
+    _push_exec_callback(callback_msg::modify, bndl.cb, id, id,
+                        _itop(is_pegged ? p : p_new), sz);
+
+    /* decreasing size keeps priority; iceberg changes come out of reserve */
+    bool to_back = (p_new != p) && !is_pegged;
+    size_t old_sz = bndl.sz;
+    if( order::is_iceberg(bndl) ){
+        if( sz > bndl.sz ){
+            bndl.iceberg.reserve = sz - bndl.sz;
+        }else{
+            bndl.iceberg.reserve = 0;
+            iwrap.decr_size(bndl.sz - sz);
+        }
+    }else if( sz < bndl.sz ){
+        iwrap.decr_size(bndl.sz - sz);
+    }else if( sz > bndl.sz ){
+        iwrap.incr_size(sz - bndl.sz);
+        to_back = true;
+    }
+    if( bndl.sz != old_sz )
+        _book_delta_resize(iwrap);
+
+    /* a peg never goes to the new price (its cap); it re-queues in place */
+    if( to_back ){
+        plevel p_to = is_pegged ? iwrap.p : p_new;
+        is_buy ? chain<limit_chain_type>::move<true>(this, id, p_to)
+               : chain<limit_chain_type>::move<false>(this, id, p_to);
+    }
+
+    /* a new price for a peg is its new cap */
+    if( is_pegged && p_new != p ){
+        bndl.pegged.limit = _itop(p_new);
+        plevel p_adj = _peg_plevel( is_buy, bndl.condition, bndl.pegged.nticks,
+                                    bndl.pegged.limit, _peg_reference<true>(),
+                                    _peg_reference<false>() );
+        if( p_adj != iwrap.p )
+            _reprice_pegged_order(id, is_buy, p_adj);
+    }
+
+    /* resting somewhere new (or bigger); it could fill an AON it couldn't */
+    if( to_back && _in_cache(id) ){
+        chain_iter_wrap& iw = _from_cache(id);
+        const order_queue_elem e( order_type::limit, is_buy, _itop(iw.p), 0,
+                                  iw->sz, iw->cb, id );
+        is_buy ? _match_aon_orders_POST_trade<true>(e, iw.p)
+               : _match_aon_orders_POST_trade<false>(e, iw.p);
+    }
+
+    return true;
+}
+
+
 template<typename ChainTy>
 void
 SOB_CLASS::_pull_linked_order(typename ChainTy::value_type& bndl)
@@ -1261,8 +1965,88 @@ SOB_CLASS::_reset_internal_pointers( plevel old_beg,
     reset_high(&_low_sell_aon);
 
     /* adjust the cache elems (BUG FIX Apr 25 2019) */
-    for( auto& elem : _id_cache )
-        elem.second.p = bytes_add(elem.second.p, offset);
+    if( offset != 0 ){ // nothing moved if we grew in place
+        for( auto& elem : _id_cache )
+            elem.second.p = bytes_add(elem.second.p, offset);
+    }
+}
+
+
+bool
+SOB_CLASS::_release_levels(plevel new_beg, plevel new_end)
+{
+    /*** PROTECTED BY _master_mtx ***/
+    assert( new_beg >= _beg );
+    assert( new_end <= _end );
+    assert( new_end - new_beg >= 3 );
+
+    if( _last && (_last < new_beg || _last >= new_end) )
+        return false;
+
+    double lo = _itop(new_beg);
+    double hi = _itop(new_end - 1);
+    auto outside = [&](double price){
+        return price && ( _ticks_in_range(lo, price) < 0
+                          || _ticks_in_range(price, hi) < 0 );
+    };
+
+    for( const auto& elem : _id_cache ){
+        if( elem.second.p < new_beg || elem.second.p >= new_end )
+            return false;
+        /* anything contingent still has to be able to get in later */
+        order_info oi = detail::order::as_order_info(this, elem.first);
+        if( outside(oi.limit) || outside(oi.stop) )
+            return false;
+        /* a peg can be re-priced up to its cap (its params are by nticks) */
+        if( elem.second.is_limit()
+            && detail::order::is_pegged(*elem.second.l_iter)
+            && outside(elem.second.l_iter->pegged.limit) ){
+            return false;
+        }
+        for( const OrderParamaters *op : { oi.advanced.order1(),
+                                           oi.advanced.order2() } ){
+            if( op && op->is_by_price()
+                && (outside(op->limit_price()) || outside(op->stop_price())) )
+                return false;
+        }
+    }
+
+    /*
+     * no orders out there so any (cached) bound that is, is loose: low
+     * bounds (_end if none) and high bounds (_beg - 1 if none) are pulled in
+     */
+    auto reset_low = [=](plevel *ptr){
+        if( *ptr >= new_end )
+            *ptr = new_end;
+        else if( *ptr < new_beg )
+            *ptr = new_beg;
+    };
+    reset_low(&_ask);
+    reset_low(&_low_buy_limit);
+    reset_low(&_low_buy_stop);
+    reset_low(&_low_sell_stop);
+    reset_low(&_low_buy_aon);
+    reset_low(&_low_sell_aon);
+
+    auto reset_high = [=](plevel *ptr){
+        if( *ptr < new_beg )
+            *ptr = new_beg - 1;
+        else if( *ptr >= new_end )
+            *ptr = new_end - 1;
+    };
+    reset_high(&_bid);
+    reset_high(&_high_sell_limit);
+    reset_high(&_high_buy_stop);
+    reset_high(&_high_sell_stop);
+    reset_high(&_high_buy_aon);
+    reset_high(&_high_sell_aon);
+
+    /* nothing moves; the outer levels go back to the (reserved) headroom */
+    _book.shrink_front( static_cast<size_t>(new_beg - _beg) );
+    _book.shrink_back( static_cast<size_t>(_end - new_end) );
+    _beg = new_beg;
+    _end = new_end;
+    return true;
 }
 
 
@@ -1270,8 +2054,8 @@ void
 SOB_CLASS::_assert_plevel(plevel p) const
 {
 #ifndef NDEBUG
-    const level *b = &(*_book.cbegin());
-    const level *e = &(*_book.cend());
+    const level *b = _book.begin();
+    const level *e = _book.end();
     assert( (labs(bytes_offset(p, b)) % sizeof(level)) == 0 );
     assert( (labs(bytes_offset(p, e)) % sizeof(level)) == 0 );
     assert( p >= b );
@@ -1287,8 +2071,8 @@ SOB_CLASS::_assert_internal_pointers() const
     if( _last )
         _assert_plevel(_last);
     
-    assert( _beg == &(*_book.begin()) + 1 );
-    assert( _end == &(*_book.end()) );
+    assert( _beg == _book.begin() + 1 );
+    assert( _end == _book.end() );
     _assert_plevel(_bid);
     _assert_plevel(_ask);
     _assert_plevel(_low_buy_limit);
@@ -0,0 +1,296 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "../../include/dispatcher_shard.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sob{
+
+namespace detail{
+
+client_runner::client_runner(size_t nthreads, size_t batch)
+    :
+        _mtx(),
+        _ready_cond(),
+        _idle_cond(),
+        _ready(),
+        _running(nthreads, nullptr),
+        _nclients(0),
+        _stop(false),
+        _batch(batch),
+        _threads()
+    {
+        for( size_t i = 0; i < nthreads; ++i ){
+            _threads.emplace_back( [=](){ this->_run(i); } );
+        }
+    }
+
+
+client_runner::~client_runner()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _stop = true;
+        }
+        _ready_cond.notify_all();
+        for( auto& t : _threads ){
+            if( t.joinable() )
+                t.join();
+        }
+    }
+
+
+void
+client_runner::_run(size_t i)
+{
+    for( ; ; ){
+        shard_client *client;
+        {
+            std::unique_lock<std::mutex> lock(_mtx);
+            _ready_cond.wait(
+                lock,
+                [this]{ return _stop || !_ready.empty(); }
+            );
+            if( _stop )
+                break;
+
+            client = _ready.front();
+            _ready.pop_front();
+            _running[i] = client;
+        }
+
+        bool more = client->run_queued(_batch);
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            /* back of the line */
+            if( more ){
+                _ready.push_back(client);
+                _ready_cond.notify_one();
+            }
+            _running[i] = nullptr;
+        }
+        _idle_cond.notify_all();
+    }
+}
+
+
+void
+client_runner::attach()
+{
+    std::lock_guard<std::mutex> lock(_mtx);
+    ++_nclients;
+}
+
+
+void
+client_runner::detach(shard_client *client)
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    _idle_cond.wait(
+        lock,
+        [=]{ return std::find(_running.begin(), _running.end(), client)
+                    == _running.end(); }
+    );
+    /* it may have been put back in line by the run we waited on */
+    _ready.erase( std::remove(_ready.begin(), _ready.end(), client),
+                  _ready.end() );
+    --_nclients;
+}
+
+
+void
+client_runner::schedule(shard_client *client)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _ready.push_back(client);
+    }
+    _ready_cond.notify_one();
+}
+
+
+size_t
+client_runner::nclients()
+{
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _nclients;
+}
+
+
+dispatcher_shard::dispatcher_shard(int core)
+    :
+        client_runner(1, BATCH),
+        _core(core),
+        _pinned(false)
+    {
+        if( core >= 0 )
+            _pinned = pin_thread(_threads.front(), core);
+    }
+
+
+bool
+pin_thread(std::thread& t, int core)
+{
+    if( core < 0 )
+        return false;
+#ifdef _WIN32
+    if( core >= static_cast<int>(sizeof(DWORD_PTR) * 8) )
+        return false;
+    return SetThreadAffinityMask( t.native_handle(),
+                                  static_cast<DWORD_PTR>(1) << core ) != 0;
+#elif defined(__linux__)
+    if( core >= CPU_SETSIZE )
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(t.native_handle(), sizeof(set), &set) == 0;
+#else
+    /* (e.g. macOS) no hard affinity; let the scheduler decide */
+    return false;
+#endif
+}
+
+
+namespace shards{
+
+namespace {
+
+std::mutex mtx;
+std::vector<std::unique_ptr<dispatcher_shard>> pool;
+
+};
+
+
+void
+start(size_t nshards, bool pin)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if( !pool.empty() )
+        throw std::logic_error("shards already started");
+
+    size_t ncores = std::max(std::thread::hardware_concurrency(), 1u);
+    if( nshards == 0 )
+        nshards = ncores;
+
+    for( size_t i = 0; i < nshards; ++i ){
+        int core = pin ? static_cast<int>(i % ncores) : -1;
+        pool.emplace_back( new dispatcher_shard(core) );
+    }
+}
+
+
+void
+stop()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    for( auto& s : pool ){
+        if( s->nclients() )
+            throw std::logic_error("books still exist on shard(s)");
+    }
+    pool.clear();
+}
+
+
+size_t
+count()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return pool.size();
+}
+
+
+dispatcher_shard*
+get(size_t i)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if( i >= pool.size() )
+        throw std::out_of_range("no shard #" + std::to_string(i));
+    return pool[i].get();
+}
+
+}; /* shards */
+
+
+namespace callback_pool{
+
+namespace {
+
+std::mutex mtx;
+std::unique_ptr<client_runner> pool;
+
+};
+
+
+void
+start(size_t nthreads)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if( pool )
+        throw std::logic_error("callback pool already started");
+
+    if( nthreads == 0 )
+        nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+    pool.reset( new client_runner(nthreads, BATCH) );
+}
+
+
+void
+stop()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if( pool && pool->nclients() )
+        throw std::logic_error("books still use the callback pool");
+    pool.reset();
+}
+
+
+size_t
+nthreads()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return pool ? pool->nthreads() : 0;
+}
+
+
+client_runner*
+get()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return pool.get();
+}
+
+}; /* callback_pool */
+
+}; /* detail */
+
+}; /* sob */
@@ -30,7 +30,10 @@ along with this program. If not, see http://www.gnu.org/licenses.
 namespace sob{
 
 SOB_TEMPLATE
-SOB_CLASS::SimpleOrderbookImpl(TickPrice<TickRatio> min, size_t incr)
+SOB_CLASS::SimpleOrderbookImpl( TickPrice<TickRatio> min,
+                                size_t incr,
+                                detail::dispatcher_shard *shard,
+                                bool inline_exec )
     :
         SimpleOrderbookBase(
             incr,
@@ -45,8 +48,16 @@ SOB_CLASS::SimpleOrderbookImpl(TickPrice<TickRatio> min, size_t incr)
             },
             [this](double price) -> bool{
                 return this->_is_valid_price(price);
-            }
-            
+            },
+            [this](double price) -> bool{
+                return this->_auto_grow(price);
+            },
+            [this](SimpleOrderbookImpl::plevel b,
+                   SimpleOrderbookImpl::plevel e) -> bool{
+                return this->_shrink_book(b, e);
+            },
+            shard,
+            inline_exec
             ),
         _base(min)
     {
@@ -55,7 +66,10 @@ SOB_CLASS::SimpleOrderbookImpl(TickPrice<TickRatio> min, size_t incr)
 
 SOB_TEMPLATE
 FullInterface*
-SOB_CLASS::create(TickPrice<TickRatio> min, TickPrice<TickRatio> max)
+SOB_CLASS::create( TickPrice<TickRatio> min,
+                   TickPrice<TickRatio> max,
+                   detail::dispatcher_shard *shard,
+                   bool inline_exec )
 {
     if (min < 0 || min > max) {
         throw std::invalid_argument("min < 0 || min > max");
@@ -70,7 +84,7 @@ SOB_CLASS::create(TickPrice<TickRatio> min, TickPrice<TickRatio> max)
         throw std::invalid_argument("need at least 3 ticks");
     }
 
-    FullInterface *tmp = new SimpleOrderbookImpl(min, incr);
+    FullInterface *tmp = new SimpleOrderbookImpl(min, incr, shard, inline_exec);
     if (tmp) {
         if (!rmanager.add(tmp, master_rmanager)) {
             delete tmp;
@@ -128,6 +142,53 @@ SOB_CLASS::grow_book_below(double new_min)
 }
 
 
+SOB_TEMPLATE
+bool
+SOB_CLASS::shrink_book(double new_min, double new_max)
+{
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+
+    TickPrice<TickRatio> lo(new_min);
+    TickPrice<TickRatio> hi(new_max);
+    if( lo > hi ){
+        throw std::invalid_argument("new_min > new_max");
+    }
+    /* only ever shrinks */
+    if( lo < _base ){
+        lo = _base;
+    }
+    if( hi > _itop(_end - 1) ){
+        hi = _itop(_end - 1);
+    }
+    if( (hi - lo).as_ticks() < 2 ){
+        throw std::invalid_argument("need at least 3 ticks");
+    }
+
+    return _shrink_book(_ptoi(lo), _ptoi(hi) + 1);
+    /* --- CRITICAL SECTION --- */
+}
+
+
+SOB_TEMPLATE
+bool
+SOB_CLASS::_shrink_book(plevel new_beg, plevel new_end)
+{
+    /* PROTECTED by '_master_mtx' */
+
+    long offset = new_beg - _beg;
+    if( !_release_levels(new_beg, new_end) ){
+        return false;
+    }
+    _base = _base + offset;
+
+    _journal_append( detail::journal_record(detail::journal_record::kind::shrink,
+                                            _itop(_beg), _itop(_end - 1)) );
+    _assert_internal_pointers();
+    return true;
+}
+
+
 SOB_TEMPLATE
 void
 SOB_CLASS::_grow_book(TickPrice<TickRatio> min, size_t incr, bool at_beg)
@@ -144,15 +205,22 @@ SOB_CLASS::_grow_book(TickPrice<TickRatio> min, size_t incr, bool at_beg)
     size_t old_sz = _book.size();
 #endif
     
-    decltype(_book) tmp( _book.size() + incr );    
-    std::move( _book.begin(), _book.end(), tmp.begin() + (at_beg ? incr : 0) );
-    _book = std::move(tmp);
+    /* 
+     * grow into the reserved headroom if we can (nothing moves); if not
+     * reserve a bigger range and move (only) the levels w/ something in them 
+     */
+    if( !(at_beg ? _book.grow_front(incr) : _book.grow_back(incr)) ){
+        size_t sz = _book.size() + incr;
+        decltype(_book) tmp( sz, decltype(_book)::default_headroom(sz) );
+        tmp.move_from( _book, at_beg ? incr : 0 );
+        _book = std::move(tmp);
+    }
     
     /* book is now in an INVALID state */
 
     _base = min;
-    _beg = &(*_book.begin()) + 1;
-    _end = &(*_book.end());
+    _beg = _book.begin() + 1;
+    _end = _book.end();
 
     long long offset = at_beg ? bytes_offset(_end, old_end)
                               : bytes_offset(_beg, old_beg);
@@ -165,15 +233,205 @@ SOB_CLASS::_grow_book(TickPrice<TickRatio> min, size_t incr, bool at_beg)
         static_cast<long long>((_book.size() - 1) * sizeof(*_beg))
     ) );
 
-    // even 0 offset needs to be handled 
+    // even 0 offset (grown in place) needs to be handled - sentinels move
     _reset_internal_pointers(old_beg, _beg, old_end, _end, offset);
 
     /* book is now in a VALID state */
 
+    _journal_append( at_beg
+        ? detail::journal_record(detail::journal_record::kind::grow_below,
+                                 _itop(_beg))
+        : detail::journal_record(detail::journal_record::kind::grow_above,
+                                 _itop(_end - 1)) );
     _assert_internal_pointers();
 }
 
 
+SOB_TEMPLATE
+size_t
+SOB_CLASS::replay_journal(const std::string& path)
+{
+    using detail::journal_record;
+
+    detail::journal_reader reader(path);
+
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    if( _last_id || _journal ){
+        throw std::logic_error("can only replay into a new book w/o a journal");
+    }
+    const detail::journal_header& h = reader.header();
+    if( h.tick_size != tick_size_()
+        || TickPrice<TickRatio>(h.min_price) != _itop(_beg)
+        || TickPrice<TickRatio>(h.max_price) != _itop(_end - 1) ){
+        throw std::invalid_argument("journal is for a different book");
+    }
+
+    /* growth/recenters were journaled as they happened; don't redo them */
+    double grow_factor = _auto_grow_factor;
+    size_t recenter_margin = _recenter_margin;
+    _auto_grow_factor = 0;
+    _recenter_margin = 0;
+
+    size_t n = 0;
+    journal_record rec;
+    try{
+        while( reader.next(rec) ){
+            switch( rec.k ){
+            case journal_record::kind::order:
+            {
+                /* no callbacks; it failed the same way the first time */
+                const external_order_queue_elem e(
+                    rec.type, rec.is_buy, rec.limit, rec.stop, rec.sz,
+                    order_exec_cb_bndl{nullptr,
+                                       order_exec_cb_bndl::type::synchronous},
+                    rec.id, rec.aot );
+                try{
+                    _execute_external_order(e);
+                }catch(...){
+                    while( !_internal_order_queue.empty() )
+                        _internal_order_queue.pop();
+                }
+                break;
+            }
+            case journal_record::kind::grow_above:
+            {
+                auto diff = TickPrice<TickRatio>(rec.limit) - _itop(_end - 1);
+                if( diff > 0 ){
+                    _grow_book(_base, static_cast<size_t>(diff.as_ticks()),
+                               false);
+                }
+                break;
+            }
+            case journal_record::kind::grow_below:
+            {
+                TickPrice<TickRatio> new_base(rec.limit);
+                auto diff = _base - new_base;
+                if( diff > 0 ){
+                    _grow_book(new_base, static_cast<size_t>(diff.as_ticks()),
+                               true);
+                }
+                break;
+            }
+            case journal_record::kind::shrink:
+                if( !_shrink_book(_ptoi(TickPrice<TickRatio>(rec.limit)),
+                                  _ptoi(TickPrice<TickRatio>(rec.stop)) + 1) ){
+                    throw std::runtime_error("journal replay diverged");
+                }
+                break;
+            default:
+                throw std::runtime_error("bad journal record");
+            }
+            _assert_internal_pointers();
+            ++n;
+        }
+    }catch(...){
+        _auto_grow_factor = grow_factor;
+        _recenter_margin = recenter_margin;
+        throw;
+    }
+
+    _auto_grow_factor = grow_factor;
+    _recenter_margin = recenter_margin;
+    return n;
+    /* --- CRITICAL SECTION --- */
+}
+
+
+SOB_TEMPLATE
+size_t
+SOB_CLASS::restore(std::istream& in)
+{
+    detail::binary_istream bin(in);
+    detail::snapshot_header h = detail::read_snapshot_header(bin);
+
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    if( _last_id || !_id_cache.empty() || _journal ){
+        throw std::logic_error("can only restore into a new book w/o a journal");
+    }
+    if( h.tick_size != tick_size_() ){
+        throw std::invalid_argument("snapshot is for a different tick size");
+    }
+
+    /* take on the snapshot's range (levels are stored as offsets from it) */
+    TickPrice<TickRatio> lo(h.min_price);
+    TickPrice<TickRatio> hi(h.max_price);
+    if( lo < _base ){
+        _grow_book(lo, static_cast<size_t>((_base - lo).as_ticks()), true);
+    }
+    if( hi > _itop(_end - 1) ){
+        _grow_book(_base, static_cast<size_t>((hi - _itop(_end - 1)).as_ticks()),
+                   false);
+    }
+    if( lo != _base || hi != _itop(_end - 1) ){
+        if( !_shrink_book(_ptoi(lo), _ptoi(hi) + 1) ){
+            throw std::runtime_error("failed to resize book for snapshot");
+        }
+    }
+
+    size_t n = _restore_snapshot(bin);
+    /* it bypasses the book delta/dirty hooks; publish all of it */
+    if( _deltas )
+        _seed_book_deltas();
+    if( _depth_dirty_on )
+        _mark_depth_dirty_all();
+    return n;
+    /* --- CRITICAL SECTION --- */
+}
+
+
+SOB_TEMPLATE
+bool
+SOB_CLASS::_auto_grow(double price)
+{
+    /* PROTECTED by '_master_mtx' */
+
+    TickPrice<TickRatio> p(price);
+    TickPrice<TickRatio> max = _itop(_end - 1);
+    long long cur = (_end - 1) - _beg; // same as ticks_in_range()
+    bool above = p > max;
+
+    long long need;
+    if( above ){
+        need = (p - max).as_ticks();
+    }else if( p >= 1 && p < _base ){
+        need = (_base - p).as_ticks();
+    }else{
+        return false;
+    }
+
+    /* geometric (but at least what this order needs), capped */
+    long long incr = std::max( need,
+        static_cast<long long>(std::ceil(cur * _auto_grow_factor)) );
+    if( _auto_grow_max_ticks ){
+        long long room = static_cast<long long>(_auto_grow_max_ticks) - cur;
+        if( need > room ){
+            return false;
+        }
+        incr = std::min(incr, room);
+    }
+    if( !above ){ // can't go below 1 tick
+        incr = std::min(incr, (_base - 1).as_ticks());
+    }
+
+    auto start = clock_type::now();
+    if( above ){
+        _grow_book(_base, static_cast<size_t>(incr), false);
+    }else{
+        _grow_book(_base - static_cast<long>(incr), static_cast<size_t>(incr),
+                   true);
+    }
+    auto pause = clock_type::now() - start;
+
+    if( _growth_cb ){
+        _growth_cb( {_itop(_beg), _itop(_end - 1), static_cast<size_t>(incr),
+                     above, pause} );
+    }
+    return true;
+}
+
+
 SOB_TEMPLATE
 bool
 SOB_CLASS::_is_valid_price(double price) const
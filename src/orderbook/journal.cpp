@@ -0,0 +1,596 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../../include/journal.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace sob{
+
+namespace detail{
+
+namespace {
+
+const char MAGIC[4] = {'S','O','B','J'};
+const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint32_t) + 3 * sizeof(double);
+/* u32 length | u32 crc32 (of what follows) */
+const size_t FRAME_SIZE = 2 * sizeof(uint32_t);
+/* (an order w/ two by-nticks OrderParamaters is < 100) */
+const size_t MAX_RECORD_SIZE = 1 << 10;
+
+/* CRC-32 (IEEE 802.3, reflected) */
+uint32_t
+crc32(const char *data, size_t n)
+{
+    static const std::vector<uint32_t> table = [](){
+        std::vector<uint32_t> t(256);
+        for( uint32_t i = 0; i < 256; ++i ){
+            uint32_t c = i;
+            for( int k = 0; k < 8; ++k )
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t c = 0xFFFFFFFF;
+    for( size_t i = 0; i < n; ++i )
+        c = table[(c ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFF;
+}
+
+/* what's left to decode in a record (or the header) */
+struct in_buf{
+    const char *data;
+    size_t size;
+    size_t pos;
+};
+
+template<typename T>
+inline void
+put(std::vector<char>& buf, T v)
+{
+    const char *p = reinterpret_cast<const char*>(&v);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+template<typename T>
+inline bool
+get(in_buf& in, T& v)
+{
+    if( in.pos + sizeof(T) > in.size )
+        return false;
+    std::memcpy(&v, in.data + in.pos, sizeof(T));
+    in.pos += sizeof(T);
+    return true;
+}
+
+enum : uint8_t {
+    PARAMS_NONE = 0,
+    PARAMS_BY_PRICE,
+    PARAMS_BY_NTICKS
+};
+
+void
+put_params(std::vector<char>& buf, const OrderParamaters *op)
+{
+    if( !op ){
+        put<uint8_t>(buf, PARAMS_NONE);
+    }else if( op->is_by_price() ){
+        put<uint8_t>(buf, PARAMS_BY_PRICE);
+        put<uint8_t>(buf, op->is_buy());
+        put<uint64_t>(buf, op->size());
+        put<double>(buf, op->limit_price());
+        put<double>(buf, op->stop_price());
+    }else{
+        put<uint8_t>(buf, PARAMS_BY_NTICKS);
+        put<uint8_t>(buf, op->is_buy());
+        put<uint64_t>(buf, op->size());
+        put<uint64_t>(buf, op->limit_nticks());
+        put<uint64_t>(buf, op->stop_nticks());
+    }
+}
+
+/* 'which' is 1 or 2 (order1/order2) */
+bool
+get_params(in_buf& in, AdvancedOrderTicket& aot, int which)
+{
+    uint8_t tag, is_buy;
+    uint64_t sz;
+    if( !get(in, tag) )
+        return false;
+    if( tag == PARAMS_NONE )
+        return true;
+    if( !get(in, is_buy) || !get(in, sz) )
+        return false;
+
+    if( tag == PARAMS_BY_PRICE ){
+        double limit, stop;
+        if( !get(in, limit) || !get(in, stop) )
+            return false;
+        OrderParamatersByPrice op(is_buy, sz, limit, stop);
+        which == 1 ? aot.change_order1(op) : aot.change_order2(op);
+    }else if( tag == PARAMS_BY_NTICKS ){
+        uint64_t limit, stop;
+        if( !get(in, limit) || !get(in, stop) )
+            return false;
+        OrderParamatersByNTicks op(is_buy, sz, limit, stop);
+        which == 1 ? aot.change_order1(op) : aot.change_order2(op);
+    }else{
+        return false;
+    }
+    return true;
+}
+
+/* (unframed) */
+void
+encode(std::vector<char>& buf, const journal_record& rec)
+{
+    put<uint8_t>(buf, static_cast<uint8_t>(rec.k));
+    if( rec.k != journal_record::kind::order ){
+        put<double>(buf, rec.limit);
+        put<double>(buf, rec.stop);
+        return;
+    }
+    put<uint8_t>(buf, static_cast<uint8_t>(rec.type));
+    put<uint8_t>(buf, rec.is_buy);
+    put<double>(buf, rec.limit);
+    put<double>(buf, rec.stop);
+    put<uint64_t>(buf, rec.sz);
+    put<uint64_t>(buf, rec.id);
+    put<uint8_t>(buf, static_cast<uint8_t>(rec.aot.condition()));
+    if( rec.aot.condition() != order_condition::none ){
+        put<uint8_t>(buf, static_cast<uint8_t>(rec.aot.trigger()));
+        put_params(buf, rec.aot.order1());
+        put_params(buf, rec.aot.order2());
+    }
+}
+
+/* encode() w/ the frame in front */
+void
+encode_framed(std::vector<char>& buf, const journal_record& rec)
+{
+    size_t beg = buf.size();
+    buf.resize(beg + FRAME_SIZE);
+    encode(buf, rec);
+    uint32_t len = static_cast<uint32_t>(buf.size() - beg - FRAME_SIZE);
+    uint32_t crc = crc32(&buf[beg + FRAME_SIZE], len);
+    std::memcpy(&buf[beg], &len, sizeof(len));
+    std::memcpy(&buf[beg + sizeof(len)], &crc, sizeof(crc));
+}
+
+/* the whole of 'in' has to be one record */
+bool
+decode(in_buf& in, journal_record& rec)
+{
+    uint8_t k;
+    if( !get(in, k) )
+        return false;
+    rec = journal_record();
+    rec.k = static_cast<journal_record::kind>(k);
+    if( rec.k != journal_record::kind::order ){
+        return get(in, rec.limit) && get(in, rec.stop)
+               && in.pos == in.size;
+    }
+
+    uint8_t type, is_buy, cond, trigger;
+    uint64_t sz, id;
+    if( !get(in, type) || !get(in, is_buy)
+        || !get(in, rec.limit) || !get(in, rec.stop)
+        || !get(in, sz) || !get(in, id)
+        || !get(in, cond) ){
+        return false;
+    }
+    rec.type = static_cast<order_type>(type);
+    rec.is_buy = is_buy;
+    rec.sz = static_cast<size_t>(sz);
+    rec.id = static_cast<id_type>(id);
+    if( cond != static_cast<uint8_t>(order_condition::none) ){
+        if( !get(in, trigger) )
+            return false;
+        rec.aot.change_condition( static_cast<order_condition>(cond) );
+        rec.aot.change_trigger( static_cast<condition_trigger>(trigger) );
+        if( !get_params(in, rec.aot, 1) || !get_params(in, rec.aot, 2) )
+            return false;
+    }
+    return in.pos == in.size;
+}
+
+bool
+decode_header(in_buf in, journal_header& header)
+{
+    uint32_t version;
+    if( in.size < HEADER_SIZE
+        || std::memcmp(in.data, MAGIC, sizeof(MAGIC)) != 0 ){
+        return false;
+    }
+    in.pos = sizeof(MAGIC);
+    return get(in, version)
+           && version == journal_header::VERSION
+           && get(in, header.tick_size)
+           && get(in, header.min_price)
+           && get(in, header.max_price);
+}
+
+/* cut 'path' off at 'size' */
+bool
+truncate_file(const std::string& path, unsigned long long size)
+{
+#ifdef _WIN32
+    std::FILE *f = std::fopen(path.c_str(), "r+b");
+    if( !f )
+        return false;
+    bool ok = _chsize_s(_fileno(f), static_cast<__int64>(size)) == 0;
+    std::fclose(f);
+    return ok;
+#else
+    return truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+}
+
+bool
+sync_file(std::FILE *f)
+{
+    if( std::fflush(f) != 0 )
+        return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+};
+
+
+journal_record::journal_record()
+    :
+        k(kind::order),
+        type(order_type::null),
+        is_buy(false),
+        limit(0),
+        stop(0),
+        sz(0),
+        id(0),
+        aot()
+    {
+    }
+
+journal_record::journal_record( order_type type,
+                                bool is_buy,
+                                double limit,
+                                double stop,
+                                size_t sz,
+                                id_type id,
+                                const AdvancedOrderTicket& aot )
+    :
+        k(kind::order),
+        type(type),
+        is_buy(is_buy),
+        limit(limit),
+        stop(stop),
+        sz(sz),
+        id(id),
+        aot(aot)
+    {
+    }
+
+journal_record::journal_record(kind k, double a, double b)
+    :
+        k(k),
+        type(order_type::null),
+        is_buy(false),
+        limit(a),
+        stop(b),
+        sz(0),
+        id(0),
+        aot()
+    {
+    }
+
+
+journal_writer::journal_writer( const std::string& path,
+                                const journal_header& header,
+                                std::chrono::milliseconds commit_interval )
+    :
+        _file( nullptr ),
+        _buf(),
+        _nappended(0),
+        _nsynced(0),
+        _nwaiting(0),
+        _stop(false),
+        _failed(false),
+        _mtx(),
+        _cond(),
+        _synced_cond(),
+        _commit_interval(commit_interval),
+        _thread()
+    {
+        bool exists = false;
+        std::FILE *f = std::fopen(path.c_str(), "rb");
+        if( f ){
+            exists = std::fgetc(f) != EOF;
+            std::fclose(f);
+        }
+
+        if( exists ){
+            /*
+             * appending to an existing journal; it has to be for the same
+             * tick and we pick up after its last complete record (a crash
+             * could have left part of one)
+             */
+            unsigned long long valid, size;
+            {
+                journal_reader reader(path);
+                if( reader.header().tick_size != header.tick_size )
+                    throw std::invalid_argument("journal tick size mismatch");
+                journal_record rec;
+                while( reader.next(rec) )
+                    ;
+                valid = reader.valid_size();
+                size = reader.size();
+            }
+            if( valid < size && !truncate_file(path, valid) )
+                throw std::runtime_error("failed to truncate journal: " + path);
+        }
+
+        _file = std::fopen(path.c_str(), "ab");
+        if( !_file )
+            throw std::runtime_error("failed to open journal: " + path);
+
+        if( !exists ){
+            std::vector<char> buf(MAGIC, MAGIC + sizeof(MAGIC));
+            put<uint32_t>(buf, journal_header::VERSION);
+            put<double>(buf, header.tick_size);
+            put<double>(buf, header.min_price);
+            put<double>(buf, header.max_price);
+            if( std::fwrite(buf.data(), 1, buf.size(), _file) != buf.size()
+                || !sync_file(_file) ){
+                std::fclose(_file);
+                throw std::runtime_error("failed to write journal: " + path);
+            }
+        }
+
+        _thread = std::thread( [this](){ this->_run(); } );
+    }
+
+
+journal_writer::~journal_writer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _stop = true;
+        }
+        _cond.notify_one();
+        if( _thread.joinable() )
+            _thread.join();
+        if( _file )
+            std::fclose(_file);
+    }
+
+
+void
+journal_writer::_run()
+{
+    std::vector<char> out;
+    for( ; ; ){
+        unsigned long long target;
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock(_mtx);
+            _cond.wait_for(
+                lock,
+                _commit_interval,
+                [this]{ return _stop || _buf.size() >= EAGER_BYTES
+                               || (_nwaiting && _nsynced < _nappended); }
+            );
+            out.swap(_buf);
+            target = _nappended;
+            stop = _stop;
+        }
+
+        /* one write + fsync for everything that's built up (group commit) */
+        bool ok = true;
+        if( !out.empty() ){
+            ok = std::fwrite(out.data(), 1, out.size(), _file) == out.size()
+                 && sync_file(_file);
+            out.clear();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if( ok )
+                _nsynced = target;
+            else
+                _failed = true;
+        }
+        _synced_cond.notify_all();
+
+        if( stop )
+            break;
+    }
+}
+
+
+
+void
+journal_writer::append(const journal_record& rec)
+{
+    bool eager;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        size_t before = _buf.size();
+        encode_framed(_buf, rec);
+        _nappended += _buf.size() - before;
+        eager = _buf.size() >= EAGER_BYTES;
+    }
+    if( eager )
+        _cond.notify_one();
+}
+
+
+void
+journal_writer::sync()
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    unsigned long long target = _nappended;
+    ++_nwaiting;
+    _cond.notify_one();
+    _synced_cond.wait(
+        lock,
+        [=]{ return _nsynced >= target || _failed; }
+    );
+    --_nwaiting;
+    if( _failed )
+        throw std::runtime_error("journal write failed");
+}
+
+
+const size_t journal_reader::CHUNK_BYTES;
+
+journal_reader::journal_reader(const std::string& path)
+    :
+        _file( std::fopen(path.c_str(), "rb") ),
+        _buf(),
+        _pos(0),
+        _offset(0),
+        _valid(HEADER_SIZE),
+        _eof(false),
+        _done(false),
+        _header()
+    {
+        if( !_file )
+            throw std::runtime_error("failed to open journal: " + path);
+        bool ok = false;
+        try{
+            ok = _fill(HEADER_SIZE)
+                 && decode_header(in_buf{&_buf[_pos], HEADER_SIZE, 0}, _header);
+        }catch(...){
+            std::fclose(_file);
+            throw;
+        }
+        if( !ok ){
+            std::fclose(_file);
+            throw std::runtime_error("not a journal: " + path);
+        }
+        _pos += HEADER_SIZE;
+    }
+
+
+journal_reader::~journal_reader()
+    {
+        std::fclose(_file);
+    }
+
+
+bool
+journal_reader::_fill(size_t n)
+{
+    if( _buf.size() - _pos >= n )
+        return true;
+    if( _eof )
+        return false;
+
+    /* drop what's been decoded, then read (at least) a chunk */
+    _buf.erase(_buf.begin(), _buf.begin() + _pos);
+    _offset += _pos;
+    _pos = 0;
+    while( _buf.size() < n && !_eof ){
+        size_t have = _buf.size();
+        size_t want = std::max(n - have, CHUNK_BYTES);
+        _buf.resize(have + want);
+        size_t nread = std::fread(&_buf[have], 1, want, _file);
+        _buf.resize(have + nread);
+        if( nread < want ){
+            if( std::ferror(_file) )
+                throw std::runtime_error("failed to read journal");
+            _eof = true;
+        }
+    }
+    return _buf.size() >= n;
+}
+
+
+bool
+journal_reader::_rest_is_zero()
+{
+    do{
+        for( size_t i = _pos; i < _buf.size(); ++i ){
+            if( _buf[i] )
+                return false;
+        }
+        _pos = _buf.size();
+    }while( _fill(1) );
+    return true;
+}
+
+
+bool
+journal_reader::next(journal_record& rec)
+{
+    if( _done )
+        return false;
+
+    uint32_t len = 0, crc = 0;
+    if( !_fill(FRAME_SIZE) ){ // the end, or a torn frame
+        _done = true;
+        return false;
+    }
+    std::memcpy(&len, &_buf[_pos], sizeof(len));
+    std::memcpy(&crc, &_buf[_pos + sizeof(len)], sizeof(crc));
+
+    bool good = len && len <= MAX_RECORD_SIZE;
+    if( good && !_fill(FRAME_SIZE + len) ){ // a torn record
+        _done = true;
+        return false;
+    }
+    if( good ){
+        const char *data = &_buf[_pos + FRAME_SIZE];
+        in_buf in{data, len, 0};
+        good = crc32(data, len) == crc && decode(in, rec);
+    }
+    if( good ){
+        _pos += FRAME_SIZE + len;
+        _valid = _offset + _pos;
+        return true;
+    }
+
+    /*
+     * a bad record is only OK as the (torn) last one: it ends right at
+     * the end of the file or it's followed by nothing but zero bytes
+     */
+    _done = true;
+    unsigned long long at = _valid;
+    if( len && len <= MAX_RECORD_SIZE && !_fill(FRAME_SIZE + len + 1) )
+        return false;
+    if( _rest_is_zero() )
+        return false;
+    throw std::runtime_error("corrupt journal record at byte "
+                             + std::to_string(at));
+}
+
+}; /* detail */
+
+}; /* sob */
@@ -0,0 +1,200 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+#include "../../include/simpleorderbook.hpp"
+
+#define SOB_CLASS SimpleOrderbook::SimpleOrderbookBase
+
+namespace sob{
+
+namespace detail{
+
+double
+latency_clock::ns_per_tick()
+{
+#ifdef SOB_LATENCY_RDTSC
+    using namespace std::chrono;
+    /* the longer it's been since the first call the better the estimate */
+    static const steady_clock::time_point t0 = steady_clock::now();
+    static const uint64_t c0 = now();
+
+    steady_clock::time_point t1 = steady_clock::now();
+    if( t1 - t0 < milliseconds(5) ){
+        std::this_thread::sleep_for( milliseconds(5) - (t1 - t0) );
+        t1 = steady_clock::now();
+    }
+    uint64_t c1 = now();
+    return duration<double, std::nano>(t1 - t0).count()
+           / static_cast<double>(c1 - c0);
+#else
+    using P = std::chrono::steady_clock::period;
+    return 1e9 * static_cast<double>(P::num) / static_cast<double>(P::den);
+#endif
+}
+
+
+latency_histogram::latency_histogram()
+    {
+        reset();
+    }
+
+
+void
+latency_histogram::reset()
+{
+    for( auto& b : _buckets )
+        b.store(0, std::memory_order_relaxed);
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+
+double
+latency_histogram::bucket_high(size_t b)
+{
+    if( b < 8 )
+        return static_cast<double>(b);
+    int e = static_cast<int>(b / 8) + 2;
+    return std::ldexp(static_cast<double>(8 + b % 8 + 1), e - 3) - 1;
+}
+
+
+latency_summary
+latency_histogram::summary(double ns_per_tick) const
+{
+    latency_summary s = latency_summary();
+
+    uint64_t counts[NBUCKETS];
+    uint64_t n = 0;
+    for( size_t i = 0; i < NBUCKETS; ++i ){
+        counts[i] = _buckets[i].load(std::memory_order_relaxed);
+        n += counts[i];
+    }
+    if( !n )
+        return s;
+
+    s.count = n;
+    s.min = _min.load(std::memory_order_relaxed) * ns_per_tick;
+    s.max = _max.load(std::memory_order_relaxed) * ns_per_tick;
+    s.mean = static_cast<double>(_sum.load(std::memory_order_relaxed))
+             / n * ns_per_tick;
+
+    /* each percentile is the high end of the bucket it falls in */
+    const double q[] = {.50, .90, .99, .999};
+    double *p[] = {&s.p50, &s.p90, &s.p99, &s.p999};
+    uint64_t cum = 0;
+    size_t qi = 0;
+    for( size_t i = 0; i < NBUCKETS && qi < 4; ++i ){
+        cum += counts[i];
+        while( qi < 4 && cum >= static_cast<uint64_t>(std::ceil(q[qi] * n)) ){
+            double v = bucket_high(i) * ns_per_tick;
+            *p[qi++] = std::max(s.min, std::min(v, s.max));
+        }
+    }
+    return s;
+}
+
+}; /* detail */
+
+
+void
+SOB_CLASS::set_latency_stats(bool on)
+{
+#ifndef SOB_NO_LATENCY_STATS
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    if( !on ){
+        _latency_on.store(false, std::memory_order_relaxed);
+        return;
+    }
+    /* never freed (until we are); a stage can be mid-record */
+    if( !_latency ){
+        detail::latency_clock::ns_per_tick(); // start calibrating
+        _latency.reset( new detail::latency_histogram[NLATENCY_STAGES] );
+    }else{
+        for( size_t i = 0; i < NLATENCY_STAGES; ++i )
+            _latency[i].reset();
+    }
+    _latency_on.store(true, std::memory_order_release);
+    /* --- CRITICAL SECTION --- */
+#endif
+}
+
+
+std::map<latency_stage, latency_summary>
+SOB_CLASS::latency_stats() const
+{
+    std::map<latency_stage, latency_summary> stats;
+#ifndef SOB_NO_LATENCY_STATS
+    {
+        std::lock_guard<std::mutex> lock(_master_mtx);
+        /* --- CRITICAL SECTION --- */
+        if( !_latency )
+            return stats;
+        /* --- CRITICAL SECTION --- */
+    }
+    double npt = detail::latency_clock::ns_per_tick();
+    for( size_t i = 0; i < NLATENCY_STAGES; ++i ){
+        stats.emplace( static_cast<latency_stage>(i),
+                       _latency[i].summary(npt) );
+    }
+#endif
+    return stats;
+}
+
+
+void
+SOB_CLASS::dump_latency_stats(std::ostream& out) const
+{
+    std::ios sstate(nullptr);
+    sstate.copyfmt(out);
+    out<< "*** LATENCY STATS (ns) ***" << std::endl;
+#ifdef SOB_NO_LATENCY_STATS
+    out<< "(compiled out - SOB_NO_LATENCY_STATS)" << std::endl;
+#else
+    auto stats = latency_stats();
+    if( stats.empty() ){
+        out<< "(off - set_latency_stats(true))" << std::endl;
+        return;
+    }
+    out<< std::left << std::setw(10) << "stage" << std::right
+       << std::setw(12) << "count" << std::setw(12) << "min"
+       << std::setw(12) << "mean" << std::setw(12) << "p50"
+       << std::setw(12) << "p90" << std::setw(12) << "p99"
+       << std::setw(12) << "p99.9" << std::setw(12) << "max" << std::endl;
+    out<< std::fixed << std::setprecision(0);
+    for( const auto& s : stats ){
+        out<< std::left << std::setw(10) << to_string(s.first) << std::right
+           << std::setw(12) << s.second.count
+           << std::setw(12) << s.second.min << std::setw(12) << s.second.mean
+           << std::setw(12) << s.second.p50 << std::setw(12) << s.second.p90
+           << std::setw(12) << s.second.p99 << std::setw(12) << s.second.p999
+           << std::setw(12) << s.second.max << std::endl;
+    }
+#endif
+    out.copyfmt(sstate);
+}
+
+}; /* sob */
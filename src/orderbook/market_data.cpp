@@ -0,0 +1,456 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <algorithm>
+#include <tuple>
+
+#include "../../include/simpleorderbook.hpp"
+#include "../../include/order_util.hpp"
+#include "specials.tpp"
+
+#define SOB_CLASS SimpleOrderbook::SimpleOrderbookBase
+
+namespace sob{
+
+namespace detail{
+
+book_delta_ring::book_delta_ring(size_t capacity)
+    :
+        _slots( timesales_ring::rounded_capacity(std::max<size_t>(capacity, 1)) ),
+        _mask( _slots.size() - 1 ),
+        _claimed(0),
+        _head(0)
+    {
+    }
+
+
+void
+book_delta_ring::push_batch(std::vector<book_delta>& batch)
+{
+    if( batch.empty() )
+        return;
+
+    /* (a batch bigger than the ring only keeps its tail) */
+    uint64_t h = _head.load(std::memory_order_relaxed);
+    uint64_t n = batch.size();
+    _claimed.store(h + n, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    batch.back().end_of_batch = true;
+    uint64_t skip = n > _mask + 1 ? n - (_mask + 1) : 0;
+    for( uint64_t i = skip; i < n; ++i ){
+        book_delta& d = batch[static_cast<size_t>(i)];
+        d.seq = h + i;
+        _slots[static_cast<size_t>((h + i) & _mask)] = d;
+    }
+    _head.store(h + n, std::memory_order_release);
+}
+
+
+uint64_t
+book_delta_ring::read_since(uint64_t seq, std::vector<book_delta>& buf) const
+{
+    const uint64_t cap = _mask + 1;
+    uint64_t h = _head.load(std::memory_order_acquire);
+    uint64_t from = (h > cap) ? std::max(seq, h - cap) : seq;
+    if( from >= h )
+        return h;
+
+    size_t n0 = buf.size();
+    buf.reserve( n0 + static_cast<size_t>(h - from) );
+    for( uint64_t s = from; s < h; ++s )
+        buf.push_back( _slots[static_cast<size_t>(s & _mask)] );
+
+    /* anything the writer has started on since is suspect */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t c = _claimed.load(std::memory_order_relaxed);
+    if( c > cap && c - cap > from ){
+        size_t ndrop = static_cast<size_t>( std::min(c - cap - from, h - from) );
+        buf.erase( buf.begin() + n0, buf.begin() + n0 + ndrop );
+    }
+    return h;
+}
+
+}; /* detail */
+
+
+void
+SOB_CLASS::_push_book_delta(book_delta::type t,
+                            plevel p,
+                            bool is_buy,
+                            const _order_bndl& bndl,
+                            size_t sz)
+{
+    /* PART OF THE ENCLOSING CRITICAL SECTION */
+    if( detail::order::is_AON(bndl) )
+        return;
+
+    double price = _itop(p);
+    _pending_deltas.push_back(
+        book_delta{0, _delta_batch, bndl.id, price, sz, t, is_buy, false}
+        );
+    _touched_levels.emplace_back(price, is_buy);
+}
+
+
+void
+SOB_CLASS::_book_delta_resize(const chain_iter_wrap& iwrap)
+{
+    if( !iwrap.is_limit() )
+        return;
+
+    const limit_bndl& bndl = *iwrap.l_iter;
+    _book_delta( book_delta::type::order_modify, iwrap.p,
+                 _is_buy_order(iwrap.p, bndl), bndl, bndl.sz );
+}
+
+
+void
+SOB_CLASS::_flush_book_deltas()
+{
+    /* PART OF THE ENCLOSING CRITICAL SECTION */
+    using namespace detail;
+
+    std::sort( _touched_levels.begin(), _touched_levels.end() );
+    auto last = std::unique( _touched_levels.begin(), _touched_levels.end() );
+
+    /*
+     * what's at each level the order touched now vs. what readers were
+     * last sent (rather than summing the L3 deltas, so L2 can't drift);
+     * a level that changed sides shows up as a delete on one, add on the
+     * other
+     */
+    for( auto iter = _touched_levels.begin(); iter != last; ++iter ){
+        double price = iter->first;
+        bool is_buy = iter->second;
+
+        size_t sz = 0;
+        if( _is_valid_price(price) ){ // (could have been shrunk away)
+            plevel p = _ptoi(price);
+            if( !p->limits.empty() && (p < _ask) == is_buy )
+                sz = chain<limit_chain_type>::size_if(p, order::is_not_AON);
+        }
+
+        auto& published = is_buy ? _published_bids : _published_asks;
+        auto piter = published.find(price);
+        size_t prev = (piter == published.end()) ? 0 : piter->second;
+        if( sz == prev )
+            continue;
+
+        book_delta::type t = book_delta::type::level_modify;
+        if( !sz ){
+            t = book_delta::type::level_delete;
+            published.erase(piter);
+        }else if( !prev ){
+            t = book_delta::type::level_add;
+            published.emplace(price, sz);
+        }else
+            piter->second = sz;
+
+        _pending_deltas.push_back(
+            book_delta{0, _delta_batch, 0, price, sz, t, is_buy, false}
+            );
+    }
+    _touched_levels.clear();
+
+    if( _pending_deltas.empty() )
+        return;
+
+    _deltas->push_batch(_pending_deltas);
+    _pending_deltas.clear();
+    ++_delta_batch;
+}
+
+
+void
+SOB_CLASS::_seed_book_deltas()
+{
+    /* PART OF THE ENCLOSING CRITICAL SECTION */
+    using namespace detail;
+
+    plevel l, h;
+    std::tie(l,h) = range<>::template get<limit_chain_type>(this);
+    for( ; l <= h; ++l ){
+        if( l->limits.empty() )
+            continue;
+        bool is_buy = (l < _ask);
+        for( const limit_bndl& bndl : *(l->limits.get()) )
+            _book_delta(book_delta::type::order_add, l, is_buy, bndl, bndl.sz);
+    }
+    _flush_book_deltas();
+}
+
+
+void
+SOB_CLASS::start_book_deltas(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    if( _deltas )
+        throw std::logic_error("book deltas already running");
+
+    _pending_deltas.clear();
+    _touched_levels.clear();
+    _published_bids.clear();
+    _published_asks.clear();
+    _delta_batch = 0;
+
+    auto ring = std::make_shared<detail::book_delta_ring>(capacity);
+    std::atomic_store(&_deltas, ring);
+    _seed_book_deltas();
+    /* --- CRITICAL SECTION --- */
+}
+
+
+void
+SOB_CLASS::stop_book_deltas()
+{
+    std::lock_guard<std::mutex> lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    std::atomic_store(&_deltas, std::shared_ptr<detail::book_delta_ring>());
+    _pending_deltas.clear();
+    _touched_levels.clear();
+    _published_bids.clear();
+    _published_asks.clear();
+    /* --- CRITICAL SECTION --- */
+}
+
+
+unsigned long long
+SOB_CLASS::read_book_deltas( unsigned long long seq,
+                             std::vector<book_delta>& buf ) const
+{
+    auto ring = std::atomic_load(&_deltas);
+    return ring ? ring->read_since(seq, buf) : seq;
+}
+
+
+void
+SOB_CLASS::_mark_depth_dirty_all()
+{
+    /* PART OF THE ENCLOSING CRITICAL SECTION */
+    using namespace detail;
+
+    plevel l, h;
+    std::tie(l,h) = range<>::template get<limit_chain_type>(this);
+    for( ; l <= h; ++l ){
+        if( !l->limits.empty() )
+            _mark_depth_dirty(l);
+    }
+}
+
+
+void
+SOB_CLASS::_collect_depth_changes()
+{
+    /* caller holds _master_mtx AND _depth_sub_mtx */
+    using namespace detail;
+
+    depth_update_type changes;
+    for( double price : _dirty_levels ){
+        std::pair<size_t, side_of_market> now(0, side_of_market::both);
+        if( _is_valid_price(price) ){ // (could have been shrunk away)
+            plevel p = _ptoi(price);
+            if( p->dirty ) // (could have been shrunk, then grown, away)
+                p->dirty = false;
+            size_t sz = p->limits.empty()
+                      ? 0
+                      : chain<limit_chain_type>::size_if(p, order::is_not_AON);
+            if( sz ){
+                now = std::make_pair( sz, (p >= _ask) ? side_of_market::ask
+                                                      : side_of_market::bid );
+            }
+        }
+
+        /* only what actually changed */
+        auto iter = _depth_state.find(price);
+        if( iter == _depth_state.end() ){
+            if( !now.first )
+                continue;
+            _depth_state.emplace(price, now);
+        }else if( iter->second == now ){
+            continue;
+        }else if( !now.first ){
+            _depth_state.erase(iter);
+        }else{
+            iter->second = now;
+        }
+        changes[price] = now;
+    }
+    _dirty_levels.clear();
+
+    if( changes.empty() )
+        return;
+
+    for( auto& s : _depth_subs ){
+        for( auto& c : changes )
+            s.second.pending[c.first] = c.second;
+    }
+}
+
+
+void
+SOB_CLASS::_depth_publisher()
+{
+    using clock = std::chrono::steady_clock;
+
+    std::unique_lock<std::mutex> lock(_depth_sub_mtx);
+    while( _depth_publisher_run ){
+        clock::time_point due = clock::time_point::max();
+        for( auto& s : _depth_subs )
+            due = std::min(due, s.second.next);
+
+        if( due == clock::time_point::max() )
+            _depth_sub_cond.wait(lock);
+        else
+            _depth_sub_cond.wait_until(lock, due);
+
+        if( !_depth_publisher_run )
+            break;
+        clock::time_point now = clock::now();
+        if( now < due ) // (woken by a (un)subscribe)
+            continue;
+
+        /* master first; what we collect goes to subscribers atomically */
+        lock.unlock();
+        {
+            std::unique_lock<std::mutex> master_lock(_master_mtx);
+            /* --- CRITICAL SECTION --- */
+            lock.lock();
+            _collect_depth_changes();
+            /* --- CRITICAL SECTION --- */
+        }
+
+        /* everyone that's due gets the latest state of what changed */
+        std::vector<std::tuple<unsigned long long, depth_cb_type,
+                               depth_update_type>> due_updates;
+        now = clock::now();
+        for( auto& s : _depth_subs ){
+            depth_subscriber& sub = s.second;
+            if( now < sub.next )
+                continue;
+            if( !sub.pending.empty() ){
+                due_updates.emplace_back(s.first, sub.cb, depth_update_type());
+                std::get<2>(due_updates.back()).swap(sub.pending);
+            }
+            sub.next += sub.interval;
+            if( sub.next < now ) // fell behind; don't catch up in a burst
+                sub.next = now + sub.interval;
+        }
+
+        /* call back w/o the lock; skip anyone that unsubscribed since */
+        for( auto& u : due_updates ){
+            if( !_depth_subs.count(std::get<0>(u)) )
+                continue;
+            _depth_in_cb = std::get<0>(u);
+            lock.unlock();
+            std::get<1>(u)(std::get<2>(u));
+            lock.lock();
+            _depth_in_cb = 0;
+            _depth_cb_done_cond.notify_all();
+        }
+    }
+}
+
+
+void
+SOB_CLASS::_stop_depth_publisher()
+{
+    std::thread t;
+    {
+        std::lock_guard<std::mutex> lock(_depth_sub_mtx);
+        _depth_publisher_run = false;
+        t.swap(_depth_publisher_thread);
+    }
+    _depth_sub_cond.notify_one();
+    if( t.joinable() )
+        t.join();
+}
+
+
+unsigned long long
+SOB_CLASS::subscribe_depth(depth_cb_type cb, unsigned interval_ms)
+{
+    if( !cb )
+        throw std::invalid_argument("null depth callback");
+
+    std::lock_guard<std::mutex> master_lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    std::lock_guard<std::mutex> lock(_depth_sub_mtx);
+
+    if( !_depth_dirty_on ){
+        /* the first subscriber; start tracking from the book as it is */
+        _dirty_levels.clear();
+        _depth_state.clear();
+        _depth_dirty_on = true;
+        _mark_depth_dirty_all();
+    }
+    _collect_depth_changes();
+
+    auto interval = std::chrono::milliseconds( std::max(interval_ms, 1u) );
+    depth_subscriber sub{ cb, interval, std::chrono::steady_clock::now(),
+                          _depth_state };
+    unsigned long long id = ++_last_depth_sub_id;
+    _depth_subs.emplace(id, std::move(sub));
+
+    if( !_depth_publisher_thread.joinable() ){
+        _depth_publisher_run = true;
+        _depth_publisher_thread = std::thread(
+            [this](){ this->_depth_publisher(); }
+            );
+    }else{
+        _depth_sub_cond.notify_one();
+    }
+    return id;
+    /* --- CRITICAL SECTION --- */
+}
+
+
+bool
+SOB_CLASS::unsubscribe_depth(unsigned long long id)
+{
+    std::unique_lock<std::mutex> master_lock(_master_mtx);
+    /* --- CRITICAL SECTION --- */
+    std::unique_lock<std::mutex> lock(_depth_sub_mtx);
+    if( !_depth_subs.erase(id) )
+        return false;
+
+    if( _depth_subs.empty() ){
+        /* stop marking (and clear what's marked); the publisher idles */
+        for( double price : _dirty_levels ){
+            if( _is_valid_price(price) && _ptoi(price)->dirty )
+                _ptoi(price)->dirty = false;
+        }
+        _dirty_levels.clear();
+        _depth_state.clear();
+        _depth_dirty_on = false;
+    }
+    master_lock.unlock();
+    /* --- CRITICAL SECTION --- */
+
+    /*
+     * it won't be called again but it could be being called now; wait
+     * (w/o _master_mtx, it might be querying the book) unless that's us
+     */
+    if( std::this_thread::get_id() != _depth_publisher_thread.get_id() ){
+        _depth_cb_done_cond.wait( lock,
+                                  [this, id](){ return _depth_in_cb != id; } );
+    }
+    return true;
+}
+
+}; /* sob */
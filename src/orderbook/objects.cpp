@@ -45,7 +45,7 @@ SOB_CLASS::_order_bndl::_order_bndl( id_type id,
         cb(cb),
         condition(condition),
         trigger(trigger),
-        nticks(0)
+        iceberg{0, 0}
     {
     }
 
@@ -61,39 +61,46 @@ SOB_CLASS::_order_bndl::_order_bndl(const _order_bndl& bndl)
     {
         switch(condition){
         case order_condition::_bracket_active: /* no break */
+        case order_condition::_trailing_bracket_active: /* no break */
         case order_condition::one_cancels_other:
             linked_order = bndl.linked_order
-                 ? new order_link(*bndl.linked_order)
+                 ? order_link_pool_type::clone(bndl.linked_order)
                  : nullptr;
             break;
         case order_condition::trailing_stop:
             contingent_nticks_order = bndl.contingent_nticks_order
-                ? new contingent_nticks_order_type(*bndl.contingent_nticks_order)
+                ? contingent_nticks_order_type::pool_type::clone(
+                      bndl.contingent_nticks_order)
                 : nullptr;
             break;
         case order_condition::one_triggers_other:
             contingent_price_order = bndl.contingent_price_order
-                 ? new contingent_price_order_type(*bndl.contingent_price_order)
+                 ? contingent_price_order_type::pool_type::clone(
+                       bndl.contingent_price_order)
                  : nullptr;
             break;
         case order_condition::trailing_bracket:
             nticks_bracket_orders = bndl.nticks_bracket_orders
-                  ? new nticks_bracket_type(*bndl.nticks_bracket_orders)
+                  ? nticks_bracket_type::pool_type::clone(
+                        bndl.nticks_bracket_orders)
                   : nullptr;
             break;
         case order_condition::bracket:
             price_bracket_orders = bndl.price_bracket_orders
-                  ? new price_bracket_type(*bndl.price_bracket_orders)
+                  ? price_bracket_type::pool_type::clone(
+                        bndl.price_bracket_orders)
                   : nullptr;
             break;
         case order_condition::_trailing_stop_active:
             nticks = bndl.nticks;
             break;
-        case order_condition::_trailing_bracket_active:
-            linked_order = bndl.linked_order
-                   ? new trailing_order_link(
-                       *dynamic_cast<trailing_order_link*>(bndl.linked_order) )
-                   : nullptr;
+        case order_condition::iceberg:
+            iceberg = bndl.iceberg;
+            break;
+        case order_condition::primary_peg: /* no break */
+        case order_condition::market_peg: /* no break */
+        case order_condition::mid_peg:
+            pegged = bndl.pegged;
             break;
         case order_condition::all_or_none: /* no break */
         case order_condition::fill_or_kill: /* no break */
@@ -140,6 +147,14 @@ SOB_CLASS::_order_bndl::_order_bndl(_order_bndl&& bndl)
         case order_condition::_trailing_stop_active:
             nticks = bndl.nticks;
             break;
+        case order_condition::iceberg:
+            iceberg = bndl.iceberg;
+            break;
+        case order_condition::primary_peg: /* no break */
+        case order_condition::market_peg: /* no break */
+        case order_condition::mid_peg:
+            pegged = bndl.pegged;
+            break;
         case order_condition::all_or_none: /* no break */
         case order_condition::fill_or_kill: /* no break */
         case order_condition::none:
@@ -157,25 +172,31 @@ SOB_CLASS::_order_bndl::~_order_bndl()
        case order_condition::_trailing_bracket_active: /* no break */
        case order_condition::one_cancels_other:
            if( linked_order )
-               delete linked_order;
+               order_link_pool_type::release(linked_order);
            break;
        case order_condition::trailing_stop:
            if( contingent_nticks_order )
-               delete contingent_nticks_order;
+               contingent_nticks_order_type::pool_type::release(
+                   contingent_nticks_order);
            break;
        case order_condition::one_triggers_other:
            if( contingent_price_order )
-               delete contingent_price_order;
+               contingent_price_order_type::pool_type::release(
+                   contingent_price_order);
            break;
        case order_condition::trailing_bracket:
            if( nticks_bracket_orders )
-               delete nticks_bracket_orders;
+               nticks_bracket_type::pool_type::release(nticks_bracket_orders);
            break;
        case order_condition::bracket:
            if( price_bracket_orders )
-               delete price_bracket_orders;
+               price_bracket_type::pool_type::release(price_bracket_orders);
            break;
        case order_condition::_trailing_stop_active: /* no break */
+       case order_condition::iceberg: /* no break */
+       case order_condition::primary_peg: /* no break */
+       case order_condition::market_peg: /* no break */
+       case order_condition::mid_peg: /* no break */
        case order_condition::all_or_none: /* no break */
        case order_condition::fill_or_kill: /* no break */
        case order_condition::none:
@@ -337,6 +358,25 @@ SOB_CLASS::chain_manager<SOB_CLASS::aon_chain_type>
     ::erase( typename SOB_CLASS::aon_chain_type::iterator);
 
 
+template<typename T>
+void
+SOB_CLASS::chain_manager<T>::splice( chain_manager& from,
+                                     typename T::iterator iter )
+{
+    /* node (and iterators to it) stay valid; nothing is reallocated */
+    assert( !from.empty() );
+    if( empty() )
+        _chain.reset( new T() );
+    _chain->splice( _chain->end(), *from._chain, iter );
+    if( from._chain->empty() )
+        from.free();
+}
+template void
+SOB_CLASS::chain_manager<SOB_CLASS::limit_chain_type>
+    ::splice( chain_manager<SOB_CLASS::limit_chain_type>&,
+              typename SOB_CLASS::limit_chain_type::iterator);
+
+
 SOB_CLASS::OrderNotInCache::OrderNotInCache(id_type id)
     :
         std::logic_error("order #" + std::to_string(id)
@@ -384,7 +424,8 @@ SOB_CLASS::external_order_queue_elem::external_order_queue_elem(
     :
         order_queue_elem_base_(ot, is_buy, limit, stop, sz, cb, id),
         aot(aot),
-        promise_async( std::move(promise) )
+        promise_async( std::move(promise) ),
+        has_promise(true)
     {
         assert( cb.cb_type == order_exec_cb_bndl::type::asynchronous );
     }
@@ -403,16 +444,34 @@ SOB_CLASS::external_order_queue_elem::external_order_queue_elem(
     :
         order_queue_elem_base_(ot, is_buy, limit, stop, sz, cb, id),
         aot(aot),
-        promise_sync( std::move(promise) )
+        promise_sync( std::move(promise) ),
+        has_promise(true)
     {
         assert( cb.cb_type == order_exec_cb_bndl::type::synchronous );
     }
 
+SOB_CLASS::external_order_queue_elem::external_order_queue_elem(
+        order_type ot,
+        bool is_buy,
+        double limit,
+        double stop,
+        size_t sz,
+        order_exec_cb_bndl cb,
+        id_type id,
+        const AdvancedOrderTicket &aot )
+    :
+        order_queue_elem_base_(ot, is_buy, limit, stop, sz, cb, id),
+        aot(aot),
+        has_promise(false)
+    {
+    }
+
 SOB_CLASS::external_order_queue_elem::external_order_queue_elem()
     :
         order_queue_elem_base_(),
         aot(),
-        promise_sync()
+        promise_sync(),
+        has_promise(true)
     {}
 
 
@@ -421,32 +480,42 @@ SOB_CLASS::external_order_queue_elem::operator=(
     external_order_queue_elem&& elem
     )
 {
-    if( cb.is_asynchronous() )
-        promise_async.~promise();
-    else
-        promise_sync.~promise();
-
-    switch( elem.cb.cb_type ){ // from type
-    case order_exec_cb_bndl::type::synchronous:
-        new (&promise_sync)
-            std::promise<std::pair<id_type, callback_queue_type>>(
-                std::move(elem.promise_sync)
-            );
-        break;
-    case order_exec_cb_bndl::type::asynchronous:
-        new (&promise_async)
-            std::promise<id_type>(std::move(elem.promise_async));
-        break;
-    };
+    if( has_promise ){
+        if( cb.is_asynchronous() )
+            promise_async.~promise();
+        else
+            promise_sync.~promise();
+    }
+
+    has_promise = elem.has_promise;
+    if( has_promise ){
+        switch( elem.cb.cb_type ){ // from type
+        case order_exec_cb_bndl::type::synchronous:
+            new (&promise_sync)
+                std::promise<std::pair<id_type, callback_queue_type>>(
+                    std::move(elem.promise_sync)
+                );
+            break;
+        case order_exec_cb_bndl::type::asynchronous:
+            new (&promise_async)
+                std::promise<id_type>(std::move(elem.promise_async));
+            break;
+        };
+    }
 
     order_queue_elem_base_::operator=( std::move(elem) );
     aot = std::move(elem.aot);
+#ifndef SOB_NO_LATENCY_STATS
+    t_queued = elem.t_queued;
+#endif
     return *this;
 }
 
 
 SOB_CLASS::external_order_queue_elem::~external_order_queue_elem()
     {
+        if( !has_promise )
+            return;
         switch( cb.cb_type ){
         case order_exec_cb_bndl::type::synchronous:
             promise_sync.~promise();
@@ -468,16 +537,16 @@ SOB_CLASS::order_queue_elem::order_queue_elem(
         id_type id,
         order_condition condition,
         condition_trigger trigger,
-        std::unique_ptr<OrderParamaters>&& cparams1,
-        std::unique_ptr<OrderParamaters>&& cparams2,
+        const OrderParamatersStorage& cparams1,
+        const OrderParamatersStorage& cparams2,
         id_type parent_id
         )
     :
         order_queue_elem_base_(ot, is_buy, limit, stop, sz, cb, id),
         condition(condition),
         trigger(trigger),
-        cparams1( std::move(cparams1) ),
-        cparams2( std::move(cparams2) ),
+        cparams1( cparams1 ),
+        cparams2( cparams2 ),
         parent_id( parent_id )
     {}
 
@@ -488,15 +557,15 @@ SOB_CLASS::order_queue_elem::order_queue_elem(
          id_type id,
          order_condition condition,
          condition_trigger trigger,
-         std::unique_ptr<OrderParamaters>&& cparams1,
-         std::unique_ptr<OrderParamaters>&& cparams2,
+         const OrderParamatersStorage& cparams1,
+         const OrderParamatersStorage& cparams2,
          id_type parent_id
          )
     :
         order_queue_elem(cparams.get_order_type(), cparams.is_buy(),
                          cparams.limit_price(), cparams.stop_price(),
                          cparams.size(), cb, id, condition, trigger,
-                         std::move(cparams1), std::move(cparams2), parent_id )
+                         cparams1, cparams2, parent_id )
     {}
 
 
@@ -542,6 +611,12 @@ SOB_CLASS::order_queue_elem::order_queue_elem(
             }
             break;
 
+        case order_type::fill_or_kill: /* no break */
+        case order_type::immediate_or_cancel:
+            /* never rest on the book so no advanced conditions to build */
+            limit = sob->_tick_price_or_throw(limit, "invalid limit price");
+            break;
+
         case order_type::stop_limit:
             limit = sob->_tick_price_or_throw(limit, "invalid limit price");
             /* no break */
@@ -575,6 +650,27 @@ SOB_CLASS::order_queue_elem::order_queue_elem(
     }
 
 
+SOB_CLASS::engine_counters::engine_counters()
+    :
+        external_queue_hwm(0),
+        async_callback_hwm(0),
+        orders_external(0),
+        orders_internal(0),
+        cascades(0),
+        cascade_max(0),
+        internal_queue_hwm(0),
+        trades(0),
+        matches(0),
+        levels_scanned(0),
+        levels_scanned_max(0),
+        lock_acquisitions(0),
+        lock_contended(0),
+        lock_wait_ns(0),
+        lock_wait_max_ns(0)
+    {
+    }
+
+
 };
 
 
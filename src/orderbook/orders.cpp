@@ -64,6 +64,12 @@ check_market_order_params(const AdvancedOrderTicket& advanced, Args... args)
             throw advanced_order_error("FOK invalid for market order");
         case order_condition::all_or_none:
             throw advanced_order_error("AON invalid for market order");
+        case order_condition::iceberg:
+            throw advanced_order_error("ICEBERG invalid for market order");
+        case order_condition::primary_peg: /* no break */
+        case order_condition::market_peg: /* no break */
+        case order_condition::mid_peg:
+            throw advanced_order_error("PEG invalid for market order");
         default: break;
        };
     }
@@ -81,6 +87,12 @@ check_stop_order_params(const AdvancedOrderTicket& advanced, Args... args)
             throw advanced_order_error("FOK invalid for stop order");
         case order_condition::all_or_none:
             throw advanced_order_error("AON invalid for stop order");
+        case order_condition::iceberg:
+            throw advanced_order_error("ICEBERG invalid for stop order");
+        case order_condition::primary_peg: /* no break */
+        case order_condition::market_peg: /* no break */
+        case order_condition::mid_peg:
+            throw advanced_order_error("PEG invalid for stop order");
         default: break;
         };
     }
@@ -118,6 +130,58 @@ SOB_CLASS::insert_limit_order_async( bool buy,
 }
 
 
+id_type
+SOB_CLASS::insert_fill_or_kill_order( bool buy,
+                                      double limit,
+                                      size_t size,
+                                      order_exec_cb_type exec_cb )
+{
+    check_order_params(size);
+
+    return _push_external_order_sync(order_type::fill_or_kill, buy, limit, 0,
+                                     size, exec_cb, AdvancedOrderTicket::null);
+}
+
+std::future<id_type>
+SOB_CLASS::insert_fill_or_kill_order_async( bool buy,
+                                            double limit,
+                                            size_t size,
+                                            order_exec_cb_type exec_cb )
+{
+    check_order_params(size);
+
+    return _push_external_order_async(order_type::fill_or_kill, buy, limit, 0,
+                                      size, exec_cb, AdvancedOrderTicket::null);
+}
+
+
+id_type
+SOB_CLASS::insert_immediate_or_cancel_order( bool buy,
+                                             double limit,
+                                             size_t size,
+                                             order_exec_cb_type exec_cb )
+{
+    check_order_params(size);
+
+    return _push_external_order_sync(order_type::immediate_or_cancel, buy,
+                                     limit, 0, size, exec_cb,
+                                     AdvancedOrderTicket::null);
+}
+
+std::future<id_type>
+SOB_CLASS::insert_immediate_or_cancel_order_async( bool buy,
+                                                   double limit,
+                                                   size_t size,
+                                                   order_exec_cb_type exec_cb )
+{
+    check_order_params(size);
+
+    return _push_external_order_async(order_type::immediate_or_cancel, buy,
+                                      limit, 0, size, exec_cb,
+                                     AdvancedOrderTicket::null);
+}
+
+
 id_type
 SOB_CLASS::insert_market_order( bool buy,
                                 size_t size,
@@ -195,6 +259,28 @@ SOB_CLASS::pull_order_async(id_type id)
 }
 
 
+/* (null order type w/ a size) */
+bool
+SOB_CLASS::modify_order(id_type id, size_t new_size, double new_price)
+{
+    check_order_params(new_size, id);
+
+    return _push_external_order_sync(order_type::null, false, new_price, 0,
+                                     new_size, nullptr,
+                                     AdvancedOrderTicket::null, id);
+}
+
+std::future<id_type> // 1 = true, 0 = false
+SOB_CLASS::modify_order_async(id_type id, size_t new_size, double new_price)
+{
+    check_order_params(new_size, id);
+
+    return _push_external_order_async(order_type::null, false, new_price, 0,
+                                      new_size, nullptr,
+                                      AdvancedOrderTicket::null, id);
+}
+
+
 id_type
 SOB_CLASS::replace_with_limit_order( id_type id,
                                      bool buy,
@@ -0,0 +1,216 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <new>
+#include <cstdint>
+#include <stdexcept>
+
+#include "../../include/paged_ladder.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace sob{
+
+namespace detail{
+
+namespace vmem{
+
+namespace {
+
+/* the whole pages inside [addr, addr + bytes) */
+bool
+whole_pages(void *addr, size_t bytes, void **first, size_t *len)
+{
+    uintptr_t pg = page_size();
+    uintptr_t b = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t e = b + bytes;
+    b = (b + pg - 1) / pg * pg;
+    e = e / pg * pg;
+    if( e <= b )
+        return false;
+    *first = reinterpret_cast<void*>(b);
+    *len = static_cast<size_t>(e - b);
+    return true;
+}
+
+};
+
+#ifdef _WIN32
+
+size_t
+page_size()
+{
+    static const size_t sz = [](){
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        return static_cast<size_t>(si.dwPageSize);
+    }();
+    return sz;
+}
+
+void*
+reserve(size_t bytes)
+{
+    if( bytes == 0 )
+        return nullptr;
+    void *addr = VirtualAlloc(NULL, bytes, MEM_RESERVE, PAGE_NOACCESS);
+    if( !addr )
+        throw std::bad_alloc();
+    return addr;
+}
+
+/* committed pages are still zero-filled lazily (but count against commit) */
+void
+commit(void *addr, size_t bytes)
+{
+    if( bytes && !VirtualAlloc(addr, bytes, MEM_COMMIT, PAGE_READWRITE) )
+        throw std::bad_alloc();
+}
+
+void
+release(void *addr, size_t bytes)
+{
+    if( addr )
+        VirtualFree(addr, 0, MEM_RELEASE);
+}
+
+void
+decommit(void *addr, size_t bytes)
+{
+    void *first;
+    size_t len;
+    if( whole_pages(addr, bytes, &first, &len) )
+        VirtualFree(first, len, MEM_DECOMMIT);
+}
+
+void*
+map_file(const std::string& path, size_t bytes)
+{
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if( f == INVALID_HANDLE_VALUE )
+        throw std::runtime_error("failed to open: " + path);
+
+    unsigned long long sz = bytes;
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READWRITE,
+                                  static_cast<DWORD>(sz >> 32),
+                                  static_cast<DWORD>(sz & 0xFFFFFFFF), NULL);
+    void *addr = m ? MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, bytes)
+                   : NULL;
+    /* the view keeps the mapping (and file) alive */
+    if( m )
+        CloseHandle(m);
+    CloseHandle(f);
+    if( !addr )
+        throw std::runtime_error("failed to map: " + path);
+    return addr;
+}
+
+void
+unmap_file(void *addr, size_t bytes)
+{
+    if( addr )
+        UnmapViewOfFile(addr);
+}
+
+#else
+
+size_t
+page_size()
+{
+    static const size_t sz = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return sz;
+}
+
+void*
+reserve(size_t bytes)
+{
+    if( bytes == 0 )
+        return nullptr;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void *addr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if( addr == MAP_FAILED )
+        throw std::bad_alloc();
+    return addr;
+}
+
+/* MAP_NORESERVE: already usable, backed on first write */
+void
+commit(void *addr, size_t bytes)
+{}
+
+void
+release(void *addr, size_t bytes)
+{
+    if( addr )
+        munmap(addr, bytes);
+}
+
+/* private anonymous pages read back as zero after MADV_DONTNEED */
+void
+decommit(void *addr, size_t bytes)
+{
+    void *first;
+    size_t len;
+    if( whole_pages(addr, bytes, &first, &len) )
+        madvise(first, len, MADV_DONTNEED);
+}
+
+void*
+map_file(const std::string& path, size_t bytes)
+{
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if( fd < 0 )
+        throw std::runtime_error("failed to open: " + path);
+
+    /* (truncated first so all of it reads as zero) */
+    void *addr = MAP_FAILED;
+    if( ftruncate(fd, static_cast<off_t>(bytes)) == 0 ){
+        addr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if( addr == MAP_FAILED )
+        throw std::runtime_error("failed to map: " + path);
+    return addr;
+}
+
+void
+unmap_file(void *addr, size_t bytes)
+{
+    if( addr )
+        munmap(addr, bytes);
+}
+
+#endif /* _WIN32 */
+
+}; /* vmem */
+
+}; /* detail */
+
+}; /* sob */
@@ -157,13 +157,36 @@ SOB_CLASS::last_id() const
 }
 
 
-const std::vector<timesale_entry_type>&
+std::vector<timesale_entry_type>
 SOB_CLASS::time_and_sales() const
 {
-    std::lock_guard<std::mutex> lock(_master_mtx);
-    /* --- CRITICAL SECTION --- */
-    return _timesales;
-    /* --- CRITICAL SECTION --- */
+    std::vector<timesale_entry_type> ts;
+    std::atomic_load(&_timesales)->read_since(0, ts);
+    return ts;
+}
+
+
+unsigned long long
+SOB_CLASS::read_trades_since( unsigned long long seq,
+                              std::vector<timesale_entry_type>& buf ) const
+{
+    /* no lock; the ring is safe to read while it's being written */
+    return std::atomic_load(&_timesales)->read_since(seq, buf);
+}
+
+
+double
+SOB_CLASS::vwap(clock_type::time_point from, clock_type::time_point to) const
+{
+    return std::atomic_load(&_timesales)->vwap(from, to);
+}
+
+
+std::map<double, unsigned long long>
+SOB_CLASS::volume_profile( clock_type::time_point from,
+                           clock_type::time_point to ) const
+{
+    return std::atomic_load(&_timesales)->volume_profile(from, to);
 }
 
 
@@ -178,9 +201,9 @@ SOB_CLASS::dump_internal_pointers(std::ostream& out) const
             if( p ){
                 _assert_plevel(p);
                 double d;
-                if( p == &(*_book.end()) )
+                if( p == _book.end() )
                     d = _itop(p-1) + tick;
-                else if( p == &(*_book.begin()) )
+                else if( p == _book.begin() )
                     d = _itop(p+1) - tick;
                 else
                     d = _itop(p);
@@ -223,6 +246,41 @@ SOB_CLASS::dump_internal_pointers(std::ostream& out) const
 }
 
 
+engine_stats
+SOB_CLASS::stats() const
+{
+    auto get = [](const engine_counters::counter& c){
+        return c.load(std::memory_order_relaxed);
+    };
+
+    engine_stats s;
+    {
+        std::lock_guard<std::mutex> lock(_external_order_queue_mtx);
+        s.external_queue_depth = _external_order_queue.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_async_callback_mtx);
+        s.async_callback_backlog = _callbacks_async.size();
+    }
+    s.orders_external = get(_counters.orders_external);
+    s.orders_internal = get(_counters.orders_internal);
+    s.external_queue_hwm = get(_counters.external_queue_hwm);
+    s.async_callback_hwm = get(_counters.async_callback_hwm);
+    s.cascades = get(_counters.cascades);
+    s.cascade_max = get(_counters.cascade_max);
+    s.internal_queue_hwm = get(_counters.internal_queue_hwm);
+    s.trades = get(_counters.trades);
+    s.matches = get(_counters.matches);
+    s.levels_scanned = get(_counters.levels_scanned);
+    s.levels_scanned_max = get(_counters.levels_scanned_max);
+    s.lock_acquisitions = get(_counters.lock_acquisitions);
+    s.lock_contended = get(_counters.lock_contended);
+    s.lock_wait_ns = get(_counters.lock_wait_ns);
+    s.lock_wait_max_ns = get(_counters.lock_wait_max_ns);
+    return s;
+}
+
+
 /* orderbook depth of non-AON limit orders */
 template<side_of_market Side>
 std::map<double, typename std::conditional<Side == side_of_market::both,
@@ -0,0 +1,469 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <set>
+#include <limits>
+#include <utility>
+
+#include "../../include/simpleorderbook.hpp"
+
+#define SOB_CLASS SimpleOrderbook::SimpleOrderbookBase
+
+namespace sob{
+
+namespace detail{
+
+namespace {
+
+const char MAGIC[4] = {'S','O','B','S'};
+
+};
+
+
+void
+write_snapshot_header(binary_ostream& out, const snapshot_header& header)
+{
+    for( char c : MAGIC )
+        out.put<char>(c);
+    out.put<uint32_t>(snapshot_header::VERSION);
+    out.put<double>(header.tick_size);
+    out.put<double>(header.min_price);
+    out.put<double>(header.max_price);
+}
+
+
+snapshot_header
+read_snapshot_header(binary_istream& in)
+{
+    for( char c : MAGIC ){
+        if( in.get<char>() != c )
+            throw std::runtime_error("not a snapshot");
+    }
+    if( in.get<uint32_t>() != snapshot_header::VERSION )
+        throw std::runtime_error("bad snapshot version");
+
+    snapshot_header header;
+    header.tick_size = in.get<double>();
+    header.min_price = in.get<double>();
+    header.max_price = in.get<double>();
+    return header;
+}
+
+}; /* detail */
+
+
+namespace {
+
+/* (offset of) a null cached pointer / the end of the levels */
+const int64_t NULL_OFFSET = std::numeric_limits<int64_t>::min();
+
+template<typename P>
+void
+put_params(detail::binary_ostream& out, const P& p)
+{
+    out.put<uint8_t>(p.is_buy());
+    out.put<uint64_t>(p.size());
+    out.put(p.limit());
+    out.put(p.stop());
+}
+
+template<typename P>
+P
+get_params(detail::binary_istream& in)
+{
+    using T = decltype( std::declval<P>().limit() );
+    bool is_buy = in.get<uint8_t>();
+    size_t sz = static_cast<size_t>(in.get<uint64_t>());
+    T limit = in.get<T>();
+    T stop = in.get<T>();
+    return P(is_buy, sz, limit, stop);
+}
+
+template<typename T>
+bool
+put_present(detail::binary_ostream& out, const T *obj)
+{
+    out.put<uint8_t>(obj != nullptr);
+    return obj != nullptr;
+}
+
+};
+
+
+/*
+ * id | sz | condition | trigger | (the union member the condition uses)
+ *
+ * callbacks aren't written; restored orders don't have one
+ */
+void
+SOB_CLASS::_write_bndl(detail::binary_ostream& out, const _order_bndl& bndl) const
+{
+    out.put<uint64_t>(bndl.id);
+    out.put<uint64_t>(bndl.sz);
+    out.put<uint8_t>(static_cast<uint8_t>(bndl.condition));
+    out.put<uint8_t>(static_cast<uint8_t>(bndl.trigger));
+
+    switch( bndl.condition ){
+    case order_condition::_bracket_active: /* no break */
+    case order_condition::_trailing_bracket_active: /* no break */
+    case order_condition::one_cancels_other:
+        if( put_present(out, bndl.linked_order) ){
+            out.put<uint64_t>(bndl.linked_order->id);
+            out.put<uint8_t>(bndl.linked_order->is_primary);
+            out.put<uint8_t>(bndl.linked_order->is_trailing());
+            out.put<uint64_t>(bndl.linked_order->nticks);
+        }
+        break;
+    case order_condition::trailing_stop:
+        if( put_present(out, bndl.contingent_nticks_order) ){
+            put_params(out, bndl.contingent_nticks_order->params);
+            out.put<uint64_t>(bndl.contingent_nticks_order->active);
+        }
+        break;
+    case order_condition::one_triggers_other:
+        if( put_present(out, bndl.contingent_price_order) ){
+            put_params(out, bndl.contingent_price_order->params);
+            out.put<uint64_t>(bndl.contingent_price_order->active);
+        }
+        break;
+    case order_condition::trailing_bracket:
+        if( put_present(out, bndl.nticks_bracket_orders) ){
+            put_params(out, bndl.nticks_bracket_orders->first);
+            put_params(out, bndl.nticks_bracket_orders->second);
+            out.put<uint64_t>(bndl.nticks_bracket_orders->active1);
+            out.put<uint64_t>(bndl.nticks_bracket_orders->active2);
+        }
+        break;
+    case order_condition::bracket:
+        if( put_present(out, bndl.price_bracket_orders) ){
+            put_params(out, bndl.price_bracket_orders->first);
+            put_params(out, bndl.price_bracket_orders->second);
+            out.put<uint64_t>(bndl.price_bracket_orders->active1);
+            out.put<uint64_t>(bndl.price_bracket_orders->active2);
+        }
+        break;
+    case order_condition::_trailing_stop_active:
+        out.put<uint64_t>(bndl.nticks);
+        break;
+    case order_condition::iceberg:
+        out.put<uint64_t>(bndl.iceberg.display);
+        out.put<uint64_t>(bndl.iceberg.reserve);
+        break;
+    case order_condition::primary_peg: /* no break */
+    case order_condition::market_peg: /* no break */
+    case order_condition::mid_peg:
+        out.put<uint64_t>(bndl.pegged.nticks);
+        out.put<double>(bndl.pegged.limit);
+        break;
+    default:
+        break;
+    }
+}
+
+
+void
+SOB_CLASS::_read_bndl(detail::binary_istream& in, _order_bndl& bndl)
+{
+    /* PROTECTED by _master_mtx ('bndl' is new; nothing in the union yet) */
+    bndl.id = static_cast<id_type>(in.get<uint64_t>());
+    bndl.sz = static_cast<size_t>(in.get<uint64_t>());
+    bndl.condition = static_cast<order_condition>(in.get<uint8_t>());
+    bndl.trigger = static_cast<condition_trigger>(in.get<uint8_t>());
+
+    switch( bndl.condition ){
+    case order_condition::_bracket_active: /* no break */
+    case order_condition::_trailing_bracket_active: /* no break */
+    case order_condition::one_cancels_other:
+        bndl.linked_order = nullptr;
+        if( in.get<uint8_t>() ){
+            id_type id = static_cast<id_type>(in.get<uint64_t>());
+            bool is_primary = in.get<uint8_t>();
+            bool is_trailing = in.get<uint8_t>();
+            size_t nticks = static_cast<size_t>(in.get<uint64_t>());
+            bndl.linked_order = is_trailing
+                ? _link_pool.acquire(id, is_primary, nticks)
+                : _link_pool.acquire(id, is_primary);
+        }
+        break;
+    case order_condition::trailing_stop:
+        bndl.contingent_nticks_order = nullptr;
+        if( in.get<uint8_t>() ){
+            auto *c = contingent_nticks_order_type::New(
+                _contingent_nticks_pool,
+                get_params<OrderParamatersByNTicks>(in) );
+            c->active = static_cast<id_type>(in.get<uint64_t>());
+            bndl.contingent_nticks_order = c;
+        }
+        break;
+    case order_condition::one_triggers_other:
+        bndl.contingent_price_order = nullptr;
+        if( in.get<uint8_t>() ){
+            auto *c = contingent_price_order_type::New(
+                _contingent_price_pool,
+                get_params<OrderParamatersByPrice>(in) );
+            c->active = static_cast<id_type>(in.get<uint64_t>());
+            bndl.contingent_price_order = c;
+        }
+        break;
+    case order_condition::trailing_bracket:
+        bndl.nticks_bracket_orders = nullptr;
+        if( in.get<uint8_t>() ){
+            auto p1 = get_params<OrderParamatersByNTicks>(in);
+            auto p2 = get_params<OrderParamatersByNTicks>(in);
+            auto *b = nticks_bracket_type::New(_nticks_bracket_pool, p1, p2);
+            b->active1 = static_cast<id_type>(in.get<uint64_t>());
+            b->active2 = static_cast<id_type>(in.get<uint64_t>());
+            bndl.nticks_bracket_orders = b;
+        }
+        break;
+    case order_condition::bracket:
+        bndl.price_bracket_orders = nullptr;
+        if( in.get<uint8_t>() ){
+            auto p1 = get_params<OrderParamatersByPrice>(in);
+            auto p2 = get_params<OrderParamatersByPrice>(in);
+            auto *b = price_bracket_type::New(_price_bracket_pool, p1, p2);
+            b->active1 = static_cast<id_type>(in.get<uint64_t>());
+            b->active2 = static_cast<id_type>(in.get<uint64_t>());
+            bndl.price_bracket_orders = b;
+        }
+        break;
+    case order_condition::_trailing_stop_active:
+        bndl.nticks = static_cast<size_t>(in.get<uint64_t>());
+        break;
+    case order_condition::iceberg:
+        bndl.iceberg.display = static_cast<size_t>(in.get<uint64_t>());
+        bndl.iceberg.reserve = static_cast<size_t>(in.get<uint64_t>());
+        break;
+    case order_condition::primary_peg: /* no break */
+    case order_condition::market_peg: /* no break */
+    case order_condition::mid_peg:
+        bndl.pegged.nticks = static_cast<size_t>(in.get<uint64_t>());
+        bndl.pegged.limit = in.get<double>();
+        break;
+    case order_condition::none: /* no break */
+    case order_condition::fill_or_kill: /* no break */
+    case order_condition::all_or_none:
+        break;
+    default:
+        /* (leave it w/ a condition its dtor knows) */
+        bndl.condition = order_condition::none;
+        throw std::runtime_error("bad order condition in snapshot");
+    }
+}
+
+
+size_t
+SOB_CLASS::snapshot(std::ostream& out) const
+{
+    detail::binary_ostream bout(out);
+    size_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(_master_mtx);
+        /* --- CRITICAL SECTION --- */
+        detail::write_snapshot_header(
+            bout, {tick_size(), _itop(_beg), _itop(_end - 1)}
+            );
+
+        bout.put<uint64_t>(_last_id);
+        bout.put<uint64_t>(_total_volume);
+        bout.put<uint64_t>(_last_size);
+
+        /* (same order as _restore_snapshot) */
+        for( plevel p : { _last, _bid, _ask, _low_buy_limit, _high_sell_limit,
+                          _low_buy_stop, _high_buy_stop, _low_sell_stop,
+                          _high_sell_stop, _low_buy_aon, _high_buy_aon,
+                          _low_sell_aon, _high_sell_aon } )
+        {
+            bout.put<int64_t>( p ? static_cast<int64_t>(p - _beg) : NULL_OFFSET );
+        }
+
+        bout.put<double>( std::get<0>(_peg_inside) );
+        bout.put<double>( std::get<1>(_peg_inside) );
+        bout.put<double>( std::get<2>(_peg_inside) );
+        bout.put<double>( std::get<3>(_peg_inside) );
+
+        for( const std::set<id_type> *ids : { &_trailing_sell_stops,
+                                              &_trailing_buy_stops,
+                                              &_pegged_orders } )
+        {
+            bout.put<uint64_t>( ids->size() );
+            for( id_type id : *ids )
+                bout.put<uint64_t>(id);
+        }
+
+        /* only what's between the outermost (cached) order levels */
+        plevel lo = std::min({ _low_buy_limit, _ask, _low_buy_stop,
+                               _low_sell_stop, _low_buy_aon, _low_sell_aon });
+        plevel hi = std::max({ _bid, _high_sell_limit, _high_buy_stop,
+                               _high_sell_stop, _high_buy_aon, _high_sell_aon });
+        lo = std::max(lo, _beg);
+        hi = std::min(hi, _end - 1);
+
+        for( plevel p = lo; p <= hi; ++p ){
+            const limit_chain_type *lc = p->limits.get();
+            const stop_chain_type *sc = p->stops.get();
+            const aon_chain_type *abc = p->aon_buys.get();
+            const aon_chain_type *asc = p->aon_sells.get();
+            if( (!lc || lc->empty()) && (!sc || sc->empty())
+                && (!abc || abc->empty()) && (!asc || asc->empty()) ){
+                continue;
+            }
+
+            bout.put<int64_t>(p - _beg);
+
+            bout.put<uint64_t>( lc ? lc->size() : 0 );
+            if( lc ){
+                for( const limit_bndl& b : *lc )
+                    _write_bndl(bout, b);
+                n += lc->size();
+            }
+
+            bout.put<uint64_t>( sc ? sc->size() : 0 );
+            if( sc ){
+                for( const stop_bndl& b : *sc ){
+                    bout.put<uint8_t>(b.is_buy);
+                    bout.put<double>(b.limit);
+                    _write_bndl(bout, b);
+                }
+                n += sc->size();
+            }
+
+            for( const aon_chain_type *ac : {abc, asc} ){
+                bout.put<uint64_t>( ac ? ac->size() : 0 );
+                if( ac ){
+                    for( const aon_bndl& b : *ac )
+                        _write_bndl(bout, b);
+                    n += ac->size();
+                }
+            }
+        }
+        bout.put<int64_t>(NULL_OFFSET);
+        bout.put<uint64_t>(n);
+        /* --- CRITICAL SECTION --- */
+    }
+
+    bout.flush();
+    if( !out )
+        throw std::runtime_error("failed to write snapshot");
+    return n;
+}
+
+
+size_t
+SOB_CLASS::_restore_snapshot(detail::binary_istream& in)
+{
+    /*
+     * PROTECTED by _master_mtx
+     *
+     * the book is new and (already) has the snapshot's range so offsets
+     * from _beg mean the same thing they did; if this throws the book is
+     * only partially loaded and should be destroyed
+     */
+    const int64_t nlevels = _end - _beg;
+    auto to_plevel = [=](int64_t offset) -> plevel {
+        if( offset == NULL_OFFSET )
+            return nullptr;
+        if( offset < -1 || offset > nlevels )
+            throw std::runtime_error("bad level in snapshot");
+        return _beg + offset;
+    };
+
+    _last_id = static_cast<id_type>(in.get<uint64_t>());
+    _total_volume = in.get<uint64_t>();
+    _last_size = static_cast<size_t>(in.get<uint64_t>());
+
+    /* (same order as snapshot) */
+    for( plevel *p : { &_last, &_bid, &_ask, &_low_buy_limit, &_high_sell_limit,
+                       &_low_buy_stop, &_high_buy_stop, &_low_sell_stop,
+                       &_high_sell_stop, &_low_buy_aon, &_high_buy_aon,
+                       &_low_sell_aon, &_high_sell_aon } )
+    {
+        *p = to_plevel( in.get<int64_t>() );
+    }
+
+    std::get<0>(_peg_inside) = in.get<double>();
+    std::get<1>(_peg_inside) = in.get<double>();
+    std::get<2>(_peg_inside) = in.get<double>();
+    std::get<3>(_peg_inside) = in.get<double>();
+
+    for( std::set<id_type> *ids : { &_trailing_sell_stops,
+                                    &_trailing_buy_stops,
+                                    &_pegged_orders } )
+    {
+        for( uint64_t i = in.get<uint64_t>(); i > 0; --i )
+            ids->insert( ids->end(), static_cast<id_type>(in.get<uint64_t>()) );
+    }
+
+    /* bulk load; (FIFO) chain order is the order they were written in */
+    size_t n = 0;
+    for( int64_t off = in.get<int64_t>(); off != NULL_OFFSET;
+         off = in.get<int64_t>() )
+    {
+        if( off < 0 || off >= nlevels )
+            throw std::runtime_error("bad level in snapshot");
+        plevel p = _beg + off;
+        _touch(p);
+
+        for( uint64_t i = in.get<uint64_t>(); i > 0; --i, ++n ){
+            limit_bndl b;
+            _read_bndl(in, b);
+            id_type id = b.id;
+            auto iter = p->limits.push( std::move(b) );
+            if( !_id_cache.emplace( std::piecewise_construct,
+                                    std::forward_as_tuple(id),
+                                    std::forward_as_tuple(iter, p) ).second )
+                throw std::runtime_error("duplicate id in snapshot");
+        }
+
+        for( uint64_t i = in.get<uint64_t>(); i > 0; --i, ++n ){
+            stop_bndl b;
+            b.is_buy = in.get<uint8_t>();
+            b.limit = in.get<double>();
+            _read_bndl(in, b);
+            id_type id = b.id;
+            auto iter = p->stops.push( std::move(b) );
+            if( !_id_cache.emplace( std::piecewise_construct,
+                                    std::forward_as_tuple(id),
+                                    std::forward_as_tuple(iter, p) ).second )
+                throw std::runtime_error("duplicate id in snapshot");
+        }
+
+        for( bool is_buy : {true, false} ){
+            auto& cm = is_buy ? p->aon_buys : p->aon_sells;
+            for( uint64_t i = in.get<uint64_t>(); i > 0; --i, ++n ){
+                aon_bndl b;
+                _read_bndl(in, b);
+                id_type id = b.id;
+                auto iter = cm.push( std::move(b) );
+                if( !_id_cache.emplace( std::piecewise_construct,
+                                        std::forward_as_tuple(id),
+                                        std::forward_as_tuple(iter, p, is_buy) ).second )
+                    throw std::runtime_error("duplicate id in snapshot");
+            }
+        }
+    }
+
+    if( in.get<uint64_t>() != n )
+        throw std::runtime_error("bad snapshot (order count)");
+
+    _assert_internal_pointers();
+    return n;
+}
+
+}; /* sob */
+
+#undef SOB_CLASS
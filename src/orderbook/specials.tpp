@@ -554,7 +554,8 @@ protected:
          *  (WE DONT REMOVE IT FROM THE LIMIT CHAIN)
          */        
         auto& iwrap = sob->_from_cache(iter->id);
-        auto aiter = p->aon_buys.push( aon_bndl(*iter) );
+        sob->_touch(p);
+        auto aiter = p->aon_chain<BuyLimit>().push( aon_bndl(*iter) );
         iwrap.switch_iter<BuyLimit>( aiter );
         exec::aon<BuyLimit>::adjust_state_after_insert(sob, p);        
     }
@@ -572,10 +573,51 @@ public:
     static void
     push(sob_class *sob, plevel p, limit_bndl&& bndl)
     {       
+        sob->_book_delta(book_delta::type::order_add, p, BuyLimit, bndl,
+                         bndl.sz);
+        sob->_touch(p);
         base_type::push(sob, p->limits, std::move(bndl), p);
         exec::limit<BuyLimit>::adjust_state_after_insert(sob, p);
     }
 
+    /* move (splice) order to the back of the chain at 'to'; loses priority */
+    template<bool BuyLimit>
+    static void
+    move(sob_class *sob, sob::id_type id, plevel to)
+    {
+        chain_iter_wrap& iwrap = sob->_from_cache(id);
+        assert( iwrap.is_limit() );
+
+        plevel p = iwrap.p;
+        const limit_bndl& bndl = *iwrap.l_iter;
+        sob->_book_delta(book_delta::type::order_delete, p, BuyLimit, bndl,
+                         bndl.sz);
+        sob->_book_delta(book_delta::type::order_add, to, BuyLimit, bndl,
+                         bndl.sz);
+        sob->_touch(to);
+        to->limits.splice(p->limits, iwrap.l_iter); // iter still valid
+        iwrap.p = to;
+        exec::limit<BuyLimit>::adjust_state_after_insert(sob, to);
+
+        move_aons_off_front(sob, p);
+
+        if( empty(p) )
+            exec::limit<BuyLimit>::adjust_state_after_pull(sob, p);
+    }
+
+    /* if an aon is now at the front we need to move to aon chain */
+    static void
+    move_aons_off_front(sob_class *sob, plevel p)
+    {
+        while( !empty(p) ){
+            auto b = p->limits.get()->begin();
+            if( !order::is_AON( *b ) )
+                break;
+            copy_bndl_to_aon_chain( sob, p, b );
+            p->limits.erase(b);
+        }
+    }
+
     static limit_bndl
     pop(sob_class *sob, sob::id_type id)
     {                   
@@ -585,17 +627,12 @@ public:
         limit_bndl bndl = *(iwrap.l_iter); // copy
         plevel p = iwrap.p;
 
+        sob->_book_delta(book_delta::type::order_delete, p,
+                         sob->_is_buy_order(p, bndl), bndl, bndl.sz);
         erase(p, iwrap.l_iter); // first
         sob->_id_cache.erase(id);  // second
                              
-        /* if an aon is now at the front we need to move to aon chain */
-        while( !empty(p) ){
-            auto b = p->limits.get()->begin();
-            if( !order::is_AON( *b ) )
-                break;
-            copy_bndl_to_aon_chain( sob, p, b );                   
-            p->limits.erase(b);
-        }
+        move_aons_off_front(sob, p);
     
         if( empty(p) ){
             /*
@@ -636,6 +673,7 @@ struct chain<typename sob_types::aon_chain_type, false>
     static void
     push(sob_class *sob, plevel p, aon_bndl&& bndl )
     {
+        sob->_touch(p);
         base_type::push(sob, p->aon_chain<BuyLimit>(), std::move(bndl), p,
                         BuyLimit);
         exec::aon<BuyLimit>::adjust_state_after_insert(sob, p);
@@ -713,6 +751,7 @@ struct chain<typename sob_types::stop_chain_type, false>
     push(sob_class *sob, plevel p, stop_bndl&& bndl)
     {        
         bool is_buy = bndl.is_buy;
+        sob->_touch(p);
         base_type::push(sob,p->stops, std::move(bndl), p);
         is_buy ? exec::stop<true>::adjust_state_after_insert(sob, p)
                : exec::stop<false>::adjust_state_after_insert(sob, p);
@@ -0,0 +1,312 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../../include/timesales.hpp"
+#include "../../include/paged_ladder.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOB_TIMESALES_SSE2
+#endif
+
+namespace sob{
+
+namespace detail{
+
+namespace {
+
+const char MAGIC[4] = {'S','O','B','T'};
+const size_t HEADER_BYTES = 64;
+
+/* sum(price * size) and sum(size) over n trades */
+void
+sum_notional( const double *prices,
+              const uint64_t *sizes,
+              size_t n,
+              double& notional,
+              unsigned long long& volume )
+{
+    size_t i = 0;
+#ifdef SOB_TIMESALES_SSE2
+    /*
+     * 2 trades at a time; no u64 -> f64 in SSE2 so build it from the
+     * halves: (2^84 + hi * 2^32) - (2^84 + 2^52) + (2^52 + lo), exactly
+     */
+    const __m128i lo_mask = _mm_set1_epi64x(0xFFFFFFFFLL);
+    const __m128i lo_magic = _mm_set1_epi64x(0x4330000000000000LL); // 2^52
+    const __m128i hi_magic = _mm_set1_epi64x(0x4530000000000000LL); // 2^84
+    const __m128d both_magic = _mm_set1_pd(19342813118337666422669312.0); // 2^84 + 2^52
+
+    __m128d n0 = _mm_setzero_pd(), n1 = _mm_setzero_pd();
+    __m128i v0 = _mm_setzero_si128(), v1 = _mm_setzero_si128();
+    auto as_pd = [&](__m128i s){
+        __m128d lo = _mm_castsi128_pd( _mm_or_si128(_mm_and_si128(s, lo_mask),
+                                                    lo_magic) );
+        __m128d hi = _mm_castsi128_pd( _mm_or_si128(_mm_srli_epi64(s, 32),
+                                                    hi_magic) );
+        return _mm_add_pd( _mm_sub_pd(hi, both_magic), lo );
+    };
+    for( ; i + 4 <= n; i += 4 ){
+        __m128i s0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(sizes + i) );
+        __m128i s1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(sizes + i + 2) );
+        n0 = _mm_add_pd( n0, _mm_mul_pd(_mm_loadu_pd(prices + i), as_pd(s0)) );
+        n1 = _mm_add_pd( n1, _mm_mul_pd(_mm_loadu_pd(prices + i + 2), as_pd(s1)) );
+        v0 = _mm_add_epi64(v0, s0);
+        v1 = _mm_add_epi64(v1, s1);
+    }
+    double nsum[2];
+    uint64_t vsum[2];
+    _mm_storeu_pd( nsum, _mm_add_pd(n0, n1) );
+    _mm_storeu_si128( reinterpret_cast<__m128i*>(vsum), _mm_add_epi64(v0, v1) );
+    notional += nsum[0] + nsum[1];
+    volume += vsum[0] + vsum[1];
+#else
+    /* independent accumulators so the compiler can pipeline/vectorize */
+    double a[4] = {0, 0, 0, 0};
+    uint64_t v[4] = {0, 0, 0, 0};
+    for( ; i + 4 <= n; i += 4 ){
+        for( size_t j = 0; j < 4; ++j ){
+            a[j] += prices[i + j] * static_cast<double>(sizes[i + j]);
+            v[j] += sizes[i + j];
+        }
+    }
+    notional += (a[0] + a[1]) + (a[2] + a[3]);
+    volume += (v[0] + v[1]) + (v[2] + v[3]);
+#endif
+    for( ; i < n; ++i ){
+        notional += prices[i] * static_cast<double>(sizes[i]);
+        volume += sizes[i];
+    }
+}
+
+};
+
+
+timesales_ring::timesales_ring( size_t capacity,
+                                const std::string& path,
+                                uint64_t seq )
+    :
+        _mem(nullptr),
+        _bytes(0),
+        _mapped(!path.empty()),
+        _hdr(nullptr),
+        _times(nullptr),
+        _prices(nullptr),
+        _sizes(nullptr),
+        _mask(0)
+    {
+        static_assert( sizeof(header) <= HEADER_BYTES,
+                       "time & sales header too big" );
+
+        if( capacity == 0 )
+            throw std::invalid_argument("time & sales capacity == 0");
+        uint64_t cap = rounded_capacity(capacity);
+        _mask = cap - 1;
+        _bytes = HEADER_BYTES + static_cast<size_t>(cap)
+            * (sizeof(int64_t) + sizeof(double) + sizeof(uint64_t));
+
+        if( _mapped ){
+            _mem = vmem::map_file(path, _bytes);
+        }else{
+            _mem = vmem::reserve(_bytes);
+            vmem::commit(_mem, _bytes);
+        }
+
+        char *base = static_cast<char*>(_mem);
+        _hdr = reinterpret_cast<header*>(base);
+        _times = reinterpret_cast<int64_t*>(base + HEADER_BYTES);
+        _prices = reinterpret_cast<double*>(_times + cap);
+        _sizes = reinterpret_cast<uint64_t*>(_prices + cap);
+
+        std::memcpy(_hdr->magic, MAGIC, sizeof(MAGIC));
+        _hdr->version = VERSION;
+        _hdr->capacity = cap;
+        _hdr->first = seq;
+        _hdr->claimed.store(seq, std::memory_order_relaxed);
+        _hdr->head.store(seq, std::memory_order_release);
+    }
+
+
+size_t
+timesales_ring::rounded_capacity(size_t capacity)
+{
+    size_t p = 1;
+    while( p < capacity )
+        p <<= 1;
+    return p;
+}
+
+
+timesales_ring::~timesales_ring()
+    {
+        if( _mapped )
+            vmem::unmap_file(_mem, _bytes);
+        else
+            vmem::release(_mem, _bytes);
+    }
+
+
+uint64_t
+timesales_ring::read_since( uint64_t seq,
+                            std::vector<timesale_entry_type>& buf ) const
+{
+    const uint64_t cap = _mask + 1;
+    uint64_t h = _hdr->head.load(std::memory_order_acquire);
+    uint64_t from = std::max(seq, _hdr->first);
+    if( h - _hdr->first > cap )
+        from = std::max(from, h - cap);
+    if( from >= h )
+        return h;
+
+    size_t n0 = buf.size();
+    buf.reserve( n0 + static_cast<size_t>(h - from) );
+    for( uint64_t s = from; s < h; ++s ){
+        uint64_t i = s & _mask;
+        buf.emplace_back( clock_type::time_point(clock_type::duration(_times[i])),
+                          _prices[i],
+                          static_cast<size_t>(_sizes[i]) );
+    }
+
+    /* anything the writer has started on since is suspect */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t c = _hdr->claimed.load(std::memory_order_relaxed);
+    if( c > cap && c - cap > from ){
+        size_t ndrop = static_cast<size_t>( std::min(c - cap - from, h - from) );
+        buf.erase( buf.begin() + n0, buf.begin() + n0 + ndrop );
+    }
+    return h;
+}
+
+
+template<typename F>
+void
+timesales_ring::_for_window(int64_t from, int64_t to, F& func) const
+{
+    const uint64_t cap = _mask + 1;
+    /* redo at most this many times, leaving the writer more room each time */
+    const unsigned MAX_TRIES = 5;
+    uint64_t c = 0;
+    for( unsigned tries = 0; ; ++tries ){
+        uint64_t h = _hdr->head.load(std::memory_order_acquire);
+        uint64_t lo = _hdr->first;
+        if( h - lo > cap )
+            lo = h - cap;
+        /*
+         * lapped last time: the oldest trades are (about to be) overwritten
+         * so skip them, like read_since drops them; cap/16 ... cap/2 past
+         * what was overwritten
+         */
+        if( tries && c > cap ){
+            uint64_t skip = c - cap + (cap >> (MAX_TRIES - tries));
+            lo = std::min( h, std::max(lo, skip) );
+        }
+
+        /* times only go forward: binary search (by sequence #) for the ends */
+        auto lower = [&](int64_t t, bool inclusive){
+            uint64_t b = lo, e = h;
+            while( b < e ){
+                uint64_t m = b + (e - b) / 2;
+                int64_t tm = _times[m & _mask];
+                if( inclusive ? (tm <= t) : (tm < t) )
+                    b = m + 1;
+                else
+                    e = m;
+            }
+            return b;
+        };
+        uint64_t beg = lower(from, false);
+        uint64_t end = std::max(beg, lower(to, true));
+
+        func.reset();
+        if( beg < end ){
+            uint64_t i = beg & _mask;
+            uint64_t n = end - beg;
+            uint64_t n1 = std::min(n, cap - i);
+            func(static_cast<size_t>(i), static_cast<size_t>(n1));
+            if( n1 < n )
+                func(0, static_cast<size_t>(n - n1));
+        }
+
+        /*
+         * did the writer lap us (overwrite something we read)? only slots
+         * from 'beg' on matter: an overwritten probe holds a later time so
+         * it can only pull 'beg' back into what was overwritten. After
+         * MAX_TRIES take what we have rather than spin behind the writer
+         */
+        std::atomic_thread_fence(std::memory_order_acquire);
+        c = _hdr->claimed.load(std::memory_order_relaxed);
+        if( c <= cap || c - cap <= beg || tries + 1 == MAX_TRIES )
+            return;
+    }
+}
+
+
+double
+timesales_ring::vwap( clock_type::time_point from,
+                      clock_type::time_point to ) const
+{
+    struct {
+        const timesales_ring *ring;
+        double notional;
+        unsigned long long volume;
+        void reset(){ notional = 0; volume = 0; }
+        void operator()(size_t i, size_t n){
+            sum_notional(ring->_prices + i, ring->_sizes + i, n,
+                         notional, volume);
+        }
+    } sum{this, 0, 0};
+
+    _for_window( from.time_since_epoch().count(),
+                 to.time_since_epoch().count(), sum );
+    return sum.volume ? (sum.notional / sum.volume) : 0;
+}
+
+
+std::map<double, unsigned long long>
+timesales_ring::volume_profile( clock_type::time_point from,
+                                clock_type::time_point to ) const
+{
+    struct {
+        const timesales_ring *ring;
+        std::map<double, unsigned long long> profile;
+        void reset(){ profile.clear(); }
+        void operator()(size_t i, size_t n){
+            const double *p = ring->_prices + i;
+            const uint64_t *s = ring->_sizes + i;
+            /* trades cluster at a price; only touch the map per run */
+            for( size_t j = 0; j < n; ){
+                double px = p[j];
+                unsigned long long v = 0;
+                for( ; j < n && p[j] == px; ++j )
+                    v += s[j];
+                profile[px] += v;
+            }
+        }
+    } prof{this, {}};
+
+    _for_window( from.time_since_epoch().count(),
+                 to.time_since_epoch().count(), prof );
+    return std::move(prof.profile);
+}
+
+}; /* detail */
+
+}; /* sob */
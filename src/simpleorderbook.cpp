@@ -90,6 +90,8 @@ to_string(const order_type& ot)
     case order_type::limit: return "limit";
     case order_type::stop: return "stop";
     case order_type::stop_limit: return "stop-limit";
+    case order_type::fill_or_kill: return "fill-or-kill";
+    case order_type::immediate_or_cancel: return "immediate-or-cancel";
     default: THROW_ENUM_TO_STR_EXC("order_type", ot);
     }
 }
@@ -132,6 +134,10 @@ to_string(const callback_msg& cm)
         return "trigger-TRAILING-STOP-close";
     case callback_msg::kill:
         return "kill";
+    case callback_msg::trigger_PEG_adj:
+        return "trigger-PEG-adj";
+    case callback_msg::modify:
+        return "modify";
     default:
         THROW_ENUM_TO_STR_EXC("callback_msg", cm);
     }
@@ -184,6 +190,14 @@ to_string(const order_condition& oc)
         return "trailing-bracket-active";
     case order_condition::all_or_none:
         return "all-or-noting";
+    case order_condition::iceberg:
+        return "iceberg";
+    case order_condition::primary_peg:
+        return "primary-peg";
+    case order_condition::market_peg:
+        return "market-peg";
+    case order_condition::mid_peg:
+        return "mid-peg";
     case order_condition::none:
         return "none";
     default:
@@ -202,6 +216,35 @@ to_string(const condition_trigger& ct)
     }
 }
 
+std::string
+to_string(book_delta::type t)
+{
+    switch(t){
+    case book_delta::type::order_add: return "order-add";
+    case book_delta::type::order_modify: return "order-modify";
+    case book_delta::type::order_execute: return "order-execute";
+    case book_delta::type::order_delete: return "order-delete";
+    case book_delta::type::level_add: return "level-add";
+    case book_delta::type::level_modify: return "level-modify";
+    case book_delta::type::level_delete: return "level-delete";
+    default: THROW_ENUM_TO_STR_EXC("book_delta::type", t);
+    }
+}
+
+std::string
+to_string(latency_stage s)
+{
+    switch(s){
+    case latency_stage::queue: return "queue";
+    case latency_stage::lock: return "lock";
+    case latency_stage::execute: return "execute";
+    case latency_stage::fulfil: return "fulfil";
+    case latency_stage::callback: return "callback";
+    case latency_stage::total: return "total";
+    default: THROW_ENUM_TO_STR_EXC("latency_stage", s);
+    }
+}
+
 #undef THROW_ENUM_TO_STR_EXC
 
 
@@ -278,6 +321,21 @@ to_string(const timesale_entry_type& entry){
     return ss.str();
 }
 
+std::string
+to_string(const book_delta& d)
+{
+    std::stringstream ss;
+    ss << '<' << d.seq << ", " << d.batch << ", " << to_string(d.dtype)
+       << ", " << (d.is_buy ? "buy" : "sell") << ", " << d.price << ", "
+       << d.size;
+    if( !d.is_L2() )
+        ss << ", #" << d.id;
+    if( d.end_of_batch )
+        ss << ", EOB";
+    ss << '>';
+    return ss.str();
+}
+
 std::ostream&
 operator<<(std::ostream& out, const order_type& ot)
 { return ( out << to_string(ot)); }
@@ -321,6 +379,10 @@ std::ostream&
 operator<<(std::ostream& out, const timesale_entry_type& entry)
 { return (out << to_string(entry)); }
 
+std::ostream&
+operator<<(std::ostream& out, const book_delta& d)
+{ return (out << to_string(d)); }
+
 order_info::order_info()
     :
         type(sob::order_type::null),
@@ -23,6 +23,8 @@ along with this program. If not, see http://www.gnu.org/licenses.
 #include <tuple>
 #include <iostream>
 #include <iomanip>
+#include <thread>
+#include <atomic>
 
 namespace {
 
@@ -48,12 +50,28 @@ orderbook_tests = {
       {"TEST_basic_orders_2", TEST_basic_orders_2},
       {"TEST_stop_orders_1", TEST_stop_orders_1},
       {"TEST_basic_orders_ASYNC_1", TEST_basic_orders_ASYNC_1},
+      {"TEST_immediate_orders_1", TEST_immediate_orders_1},
       {"TEST_orders_info_pull_1", TEST_orders_info_pull_1},
       {"TEST_orders_info_pull_ASYNC_1", TEST_orders_info_pull_ASYNC_1},
       {"TEST_replace_order_1", TEST_replace_order_1},
       {"TEST_replace_order_ASYNC_1", TEST_replace_order_ASYNC_1},
+      {"TEST_modify_order_1", TEST_modify_order_1},
+      {"TEST_modify_order_2", TEST_modify_order_2},
       {"TEST_grow_1", TEST_grow_1},
-      {"TEST_grow_2", TEST_grow_2} ,
+      {"TEST_grow_2", TEST_grow_2},
+      {"TEST_grow_3", TEST_grow_3},
+      {"TEST_grow_4", TEST_grow_4},
+      {"TEST_shrink_1", TEST_shrink_1},
+      {"TEST_shrink_2", TEST_shrink_2},
+      {"TEST_shrink_3", TEST_shrink_3},
+      {"TEST_journal_1", TEST_journal_1},
+      {"TEST_snapshot_1", TEST_snapshot_1},
+      {"TEST_timesales_1", TEST_timesales_1},
+      {"TEST_timesales_2", TEST_timesales_2},
+      {"TEST_book_deltas_1", TEST_book_deltas_1},
+      {"TEST_depth_subscription_1", TEST_depth_subscription_1},
+      {"TEST_latency_stats_1", TEST_latency_stats_1},
+      {"TEST_engine_stats_1", TEST_engine_stats_1},
       {"TEST_grow_ASYNC_1", TEST_grow_ASYNC_1},
       {"TEST_advanced_AON_1", TEST_advanced_AON_1},
       {"TEST_advanced_AON_2", TEST_advanced_AON_2},
@@ -68,7 +86,14 @@ orderbook_tests = {
       {"TEST_advanced_AON_11", TEST_advanced_AON_11},
       {"TEST_advanced_AON_12", TEST_advanced_AON_12},
       {"TEST_advanced_AON_13", TEST_advanced_AON_13},
+      {"TEST_advanced_AON_14", TEST_advanced_AON_14},
+      {"TEST_advanced_AON_15", TEST_advanced_AON_15},
       {"TEST_advanced_AON_ASYNC_1", TEST_advanced_AON_ASYNC_1},
+      {"TEST_advanced_ICEBERG_1", TEST_advanced_ICEBERG_1},
+      {"TEST_advanced_ICEBERG_2", TEST_advanced_ICEBERG_2},
+      {"TEST_advanced_PEG_1", TEST_advanced_PEG_1},
+      {"TEST_advanced_PEG_2", TEST_advanced_PEG_2},
+      {"TEST_advanced_PEG_3", TEST_advanced_PEG_3},
       {"TEST_advanced_OCO_1", TEST_advanced_OCO_1},
       {"TEST_advanced_OCO_2", TEST_advanced_OCO_2},
       {"TEST_advanced_OCO_3", TEST_advanced_OCO_3},
@@ -146,12 +171,23 @@ set_ostream(int argc, char* argv[] )
 
 std::mutex callback_mtx;
 
+typedef function<FullInterface*(const DefaultFactoryProxy&, double, double)>
+        create_ty;
+
+int
+run_orderbook_tests_with(const create_ty& create, const string& tag);
+
+const size_t NSHARDS = 2;
+size_t shard_n = 0; /* the shard the current test's book is on */
+
 }; /* namespace */
 
 
 const categories_ty functional_categories = {
         {"TICK_PRICE", run_tick_price_tests},
-        {"ORDERBOOK", run_orderbook_tests}
+        {"ORDERBOOK", run_orderbook_tests},
+        {"ORDERBOOK_SHARDED", run_sharded_orderbook_tests},
+        {"ORDERBOOK_INLINE", run_inline_orderbook_tests}
 };
 
 
@@ -187,11 +223,93 @@ run_tick_price_tests(int argc, char* argv[])
 int
 run_orderbook_tests(int argc, char* argv[])
 {
-    using namespace std;
-    using namespace sob;
+    set_ostream(argc, argv);
+
+    return run_orderbook_tests_with(
+        [](const DefaultFactoryProxy& proxy, double min, double max){
+            return proxy.create(min, max);
+        },
+        ""
+    );
+}
 
+
+/*
+ * the same tests w/ books run by (a couple) shared dispatcher threads, and
+ * their async callbacks run by the shared callback pool; each test book
+ * shares its shard w/ a 'neighbor' book that's kept busy by another thread
+ * for the length of the test
+ */
+int
+run_sharded_orderbook_tests(int argc, char* argv[])
+{
     set_ostream(argc, argv);
 
+    SimpleOrderbook::StartShards(NSHARDS, false);
+    SimpleOrderbook::StartCallbackPool(NSHARDS);
+
+    int err = run_orderbook_tests_with(
+        [](const DefaultFactoryProxy& proxy, double min, double max){
+            return proxy.create_on_shard(min, max, shard_n % NSHARDS);
+        },
+        " - SHARDED"
+    );
+    if( err )
+        return err;
+
+    /* shards/pool can't go away w/ books still on them */
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,4>>();
+    FullInterface *orderbook = proxy.create_on_shard(1, 10, 0);
+    try{
+        SimpleOrderbook::StopShards();
+        return 1;
+    }catch(std::logic_error&){
+    }
+    try{
+        SimpleOrderbook::StopCallbackPool();
+        return 1;
+    }catch(std::logic_error&){
+    }
+    proxy.destroy(orderbook);
+
+    SimpleOrderbook::StopShards();
+    SimpleOrderbook::StopCallbackPool();
+    if( SimpleOrderbook::ShardCount() != 0
+        || SimpleOrderbook::CallbackPoolSize() != 0 )
+        return 2;
+
+    try{
+        proxy.create_on_shard(1, 10, 0);
+        return 3;
+    }catch(std::out_of_range&){
+    }
+    return 0;
+}
+
+
+/* the same tests w/ books that execute in the caller's (this) thread */
+int
+run_inline_orderbook_tests(int argc, char* argv[])
+{
+    set_ostream(argc, argv);
+
+    return run_orderbook_tests_with(
+        [](const DefaultFactoryProxy& proxy, double min, double max){
+            return proxy.create_inline(min, max);
+        },
+        " - INLINE"
+    );
+}
+
+
+namespace {
+
+int
+run_orderbook_tests_with(const create_ty& create, const string& tag)
+{
+    using namespace std;
+    using namespace sob;
+
     for( auto& test : orderbook_tests ){
         for( auto& proxy_info : proxies ){
             auto& proxy = get<1>(proxy_info);
@@ -203,7 +321,7 @@ run_orderbook_tests(int argc, char* argv[])
 
                 stringstream test_head;
                 test_head << test.first << " - 1/" << get<0>(proxy_info)
-                          << " - " << min_price << "-" << max_price;
+                          << " - " << min_price << "-" << max_price << tag;
 
                 if( !out_is_cout ){
                     cout << "** " << test_head.str() << " ** ";
@@ -211,9 +329,33 @@ run_orderbook_tests(int argc, char* argv[])
                 }
                 out.get() << "** BEGIN - " << test_head.str() << " **" << endl;
 
-                FullInterface *orderbook = proxy.create(min_price, max_price);
+                FullInterface *orderbook = create(proxy, min_price, max_price);
+                FullInterface *neighbor = nullptr;
+                std::atomic<bool> busy(true);
+                std::thread noise;
+                if( SimpleOrderbook::ShardCount() > 0 ){
+                    neighbor = proxy.create_on_shard(min_price, max_price,
+                                                     shard_n++ % NSHARDS);
+                    noise = std::thread( [=, &busy](){
+                        double p = neighbor->min_price();
+                        while( busy ){
+                            auto f = neighbor->insert_limit_order_async(
+                                true, p, 1, nullptr);
+                            neighbor->pull_order(f.get());
+                        }
+                    });
+                }
 
                 int err = test.second(orderbook, out.get());
+
+                if( neighbor ){
+                    busy = false;
+                    noise.join();
+                    if( neighbor->total_size() != 0 )
+                        err = -1;
+                    proxy.destroy(neighbor);
+                }
+
                 if( !err ){
                     proxy.destroy(orderbook);
                 }
@@ -235,6 +377,8 @@ run_orderbook_tests(int argc, char* argv[])
     return 0;
 }
 
+}; /* namespace */
+
 
 void callback( sob::callback_msg msg,
                sob::id_type id1,
@@ -341,4 +485,15 @@ create_advanced_callback(std::map<sob::id_type, sob::id_type>& ids)
 }
 
 
+const sob::DefaultFactoryProxy&
+proxy_for(sob::FullInterface *orderbook)
+{
+    for( auto& proxy_info : proxies ){
+        if( get<1>(proxy_info).tick_size() == orderbook->tick_size() )
+            return get<1>(proxy_info);
+    }
+    throw std::invalid_argument("no proxy for tick size");
+}
+
+
 #endif /* RUN_FUNCTIONAL_TESTS */
@@ -32,6 +32,12 @@ run_tick_price_tests(int argc, char* argv[]);
 int
 run_orderbook_tests(int argc, char* argv[]);
 
+int
+run_sharded_orderbook_tests(int argc, char* argv[]);
+
+int
+run_inline_orderbook_tests(int argc, char* argv[]);
+
 extern const categories_ty functional_categories;
 
 #define DECL_TICK_TEST_FUNC(name) \
@@ -44,17 +50,33 @@ int TEST_##name(sob::FullInterface *orderbook, std::ostream& out)
 DECL_TICK_TEST_FUNC(tick_price_1);
 DECL_SOB_TEST_FUNC(grow_1);
 DECL_SOB_TEST_FUNC(grow_2);
+DECL_SOB_TEST_FUNC(grow_3);
+DECL_SOB_TEST_FUNC(grow_4);
+DECL_SOB_TEST_FUNC(shrink_1);
+DECL_SOB_TEST_FUNC(shrink_2);
+DECL_SOB_TEST_FUNC(shrink_3);
+DECL_SOB_TEST_FUNC(journal_1);
+DECL_SOB_TEST_FUNC(snapshot_1);
+DECL_SOB_TEST_FUNC(timesales_1);
+DECL_SOB_TEST_FUNC(timesales_2);
+DECL_SOB_TEST_FUNC(book_deltas_1);
+DECL_SOB_TEST_FUNC(depth_subscription_1);
+DECL_SOB_TEST_FUNC(latency_stats_1);
+DECL_SOB_TEST_FUNC(engine_stats_1);
 DECL_SOB_TEST_FUNC(grow_ASYNC_1);
 /* basic_orders.cpp */
 DECL_SOB_TEST_FUNC(basic_orders_1);
 DECL_SOB_TEST_FUNC(basic_orders_2);
 DECL_SOB_TEST_FUNC(stop_orders_1);
 DECL_SOB_TEST_FUNC(basic_orders_ASYNC_1);
+DECL_SOB_TEST_FUNC(immediate_orders_1);
 /* pull_replace.cpp */
 DECL_SOB_TEST_FUNC(orders_info_pull_1);
 DECL_SOB_TEST_FUNC(orders_info_pull_ASYNC_1);
 DECL_SOB_TEST_FUNC(replace_order_1);
 DECL_SOB_TEST_FUNC(replace_order_ASYNC_1);
+DECL_SOB_TEST_FUNC(modify_order_1);
+DECL_SOB_TEST_FUNC(modify_order_2);
 /* advanced_orders/once_cancels_other.cpp */
 DECL_SOB_TEST_FUNC(advanced_OCO_1);
 DECL_SOB_TEST_FUNC(advanced_OCO_2);
@@ -111,7 +133,16 @@ DECL_SOB_TEST_FUNC(advanced_AON_10);
 DECL_SOB_TEST_FUNC(advanced_AON_11);
 DECL_SOB_TEST_FUNC(advanced_AON_12);
 DECL_SOB_TEST_FUNC(advanced_AON_13);
+DECL_SOB_TEST_FUNC(advanced_AON_14);
+DECL_SOB_TEST_FUNC(advanced_AON_15);
 DECL_SOB_TEST_FUNC(advanced_AON_ASYNC_1);
+/* advanced_orders/iceberg.cpp */
+DECL_SOB_TEST_FUNC(advanced_ICEBERG_1);
+DECL_SOB_TEST_FUNC(advanced_ICEBERG_2);
+/* advanced_orders/pegged.cpp */
+DECL_SOB_TEST_FUNC(advanced_PEG_1);
+DECL_SOB_TEST_FUNC(advanced_PEG_2);
+DECL_SOB_TEST_FUNC(advanced_PEG_3);
 
 void
 callback( sob::callback_msg msg,
@@ -136,6 +167,10 @@ dump_orders(sob::FullInterface *orderbook, std::ostream& out = std::cout);
 sob::order_exec_cb_type
 create_advanced_callback(std::map<sob::id_type, sob::id_type>& ids);
 
+/* the (test) proxy for books w/ the same tick size as 'orderbook' */
+const sob::DefaultFactoryProxy&
+proxy_for(sob::FullInterface *orderbook);
+
 #endif /* RUN_FUNCTIONAL_TESTS */
 
 #endif /* JO_FUNCTIONAL_TEST */
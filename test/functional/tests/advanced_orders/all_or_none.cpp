@@ -1374,6 +1374,122 @@ TEST_advanced_AON_13(FullInterface *orderbook, std::ostream& out)
 
 }
 
+
+int
+TEST_advanced_AON_14(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    auto aot = AdvancedOrderTicketAON::build();
+
+    // aon behind a limit, on both sides
+    id_type id1 = orderbook->insert_limit_order(false, conv(mid+incr), sz, ecb);
+    id_type id2 = orderbook->insert_limit_order(false, conv(mid+incr), 2*sz,
+                                                ecb, aot);
+    id_type id3 = orderbook->insert_limit_order(true, conv(mid), sz, ecb);
+    id_type id4 = orderbook->insert_limit_order(true, conv(mid), 2*sz,
+                                                ecb, aot);
+
+    // mid + 1                  100 <1> 200 aon <2>
+    // mid        100 <3> 200 aon <4>
+
+    if( orderbook->total_aon_bid_size() != 2*sz
+        || orderbook->total_aon_ask_size() != 2*sz )
+    {
+        return 1;
+    }
+
+    // pulling the limit moves the aon (to the aon chain of the same side)
+    if( !orderbook->pull_order(id1) || !orderbook->pull_order(id3) )
+        return 2;
+
+    if( orderbook->total_aon_bid_size() != 2*sz
+        || orderbook->total_aon_ask_size() != 2*sz
+        || orderbook->total_size() != 0 )
+    {
+        return 3;
+    }
+
+    dump_orders(orderbook, out);
+    orderbook->dump_aon_sell_limits(out);
+    orderbook->dump_aon_buy_limits(out);
+    dynamic_cast<ManagementInterface*>(orderbook)->dump_internal_pointers(out);
+
+    if( !orderbook->pull_order(id2) || !orderbook->pull_order(id4) )
+        return 4;
+
+    if( orderbook->total_aon_size() != 0 )
+        return 5;
+
+    return 0;
+}
+
+
+int
+TEST_advanced_AON_15(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    auto aot = AdvancedOrderTicketAON::build();
+
+    // an aon the other side can't fill (yet)
+    orderbook->insert_limit_order(false, conv(mid+incr), 2*sz, ecb, aot);
+    id_type id2 = orderbook->insert_limit_order(true, conv(mid-incr), sz, ecb);
+
+    // mid + 1  200 aon <1>
+    // mid - 1                100 <2>
+
+    // modified up to the aon's price and size: it fills
+    if( !orderbook->modify_order(id2, 2*sz, conv(mid+incr)) )
+        return 1;
+
+    dump_orders(orderbook, out);
+    orderbook->dump_aon_sell_limits(out);
+
+    if( orderbook->total_aon_ask_size() != 0
+        || orderbook->volume() != 2*sz
+        || orderbook->last_price() != conv(mid+incr)
+        || orderbook->get_order_info(id2) )
+    {
+        return 2;
+    }
+
+    // the same w/ a size increase (at the aon's price)
+    orderbook->insert_limit_order(false, conv(mid+incr), 2*sz, ecb, aot);
+    id_type id4 = orderbook->insert_limit_order(true, conv(mid+incr), sz, ecb);
+    if( orderbook->total_aon_ask_size() != 2*sz
+        || orderbook->bid_size() != sz )
+    {
+        return 3;
+    }
+
+    if( !orderbook->modify_order(id4, 2*sz) )
+        return 4;
+
+    dump_orders(orderbook, out);
+    orderbook->dump_aon_sell_limits(out);
+
+    if( orderbook->total_aon_ask_size() != 0
+        || orderbook->volume() != 4*sz
+        || orderbook->get_order_info(id4) )
+    {
+        return 5;
+    }
+
+    return 0;
+}
+
+
 int
 TEST_advanced_AON_ASYNC_1(FullInterface *orderbook, std::ostream& out)
 {
@@ -0,0 +1,197 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../../functional.hpp"
+
+#ifdef RUN_FUNCTIONAL_TESTS
+
+#include <map>
+#include <iostream>
+
+using namespace sob;
+using namespace std;
+
+namespace {
+    map<id_type, id_type> ids;
+    auto ecb = create_advanced_callback(ids);
+    size_t sz = 100;
+}
+
+
+// resting iceberg: replenish, loss of priority, displayed size only
+int
+TEST_advanced_ICEBERG_1(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    size_t as, tas, tv;
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+
+    auto aot = AdvancedOrderTicketICEBERG::build(sz);
+
+    id_type id1 = orderbook->insert_limit_order(false, mid, sz * 3, ecb, aot);
+    id_type id2 = orderbook->insert_limit_order(false, mid, sz, ecb);
+    dump_orders(orderbook,out);
+
+    as = orderbook->ask_size();
+    tas = orderbook->total_ask_size();
+    if( as != sz * 2 || tas != sz * 2 )
+        return 1;
+
+    auto md = orderbook->ask_depth();
+    if( md.size() != 1 || md[mid] != sz * 2 )
+        return 2;
+
+    auto oi = orderbook->get_order_info(id1);
+    out<< "ORDER INFO: " << id1 << " " << oi << endl;
+    if( oi.size != sz * 3 )
+        return 3;
+    if( oi.advanced.condition() != order_condition::iceberg
+        || oi.advanced.order1()->size() != sz )
+        return 4;
+
+    /* fill displayed, replenish behind id2, then hit id2 */
+    orderbook->insert_limit_order(true, mid, sz * 1.5, ecb);
+    dump_orders(orderbook,out);
+
+    as = orderbook->ask_size();
+    if( as != sz * 1.5 )
+        return 5;
+
+    tv = orderbook->volume();
+    if( tv != sz * 1.5 )
+        return 6;
+
+    oi = orderbook->get_order_info(id1);
+    if( oi.size != sz * 2 )
+        return 7;
+
+    /* id2 now has priority */
+    orderbook->insert_limit_order(true, mid, sz / 2, ecb);
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id2) )
+        return 8;
+
+    oi = orderbook->get_order_info(id1);
+    if( oi.size != sz * 2 )
+        return 9;
+
+    as = orderbook->ask_size();
+    if( as != sz )
+        return 10;
+
+    /* take the rest; replenish with nothing else at the level */
+    orderbook->insert_limit_order(true, mid, sz * 2, ecb);
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id1) )
+        return 11;
+
+    as = orderbook->ask_size();
+    tas = orderbook->total_ask_size();
+    if( as != 0 || tas != 0 )
+        return 12;
+
+    tv = orderbook->volume();
+    if( tv != sz * 4 )
+        return 13;
+
+    if( orderbook->market_depth().size() )
+        return 14;
+
+    return 0;
+}
+
+
+// aggressive iceberg, hidden size vs. fill-or-kill, bad tickets
+int
+TEST_advanced_ICEBERG_2(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    size_t bs, tbs, tv;
+    double bp;
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    auto aot = AdvancedOrderTicketICEBERG::build(sz);
+
+    orderbook->insert_limit_order(false, mid, sz, ecb);
+    orderbook->insert_limit_order(false, conv(mid + incr), sz, ecb);
+
+    /* trades its full size on the way in, rests with display only */
+    id_type id = orderbook->insert_limit_order(true, conv(mid + incr*2), sz * 4,
+                                               ecb, aot);
+    dump_orders(orderbook,out);
+
+    tv = orderbook->volume();
+    if( tv != sz * 2 )
+        return 1;
+
+    bp = orderbook->bid_price();
+    bs = orderbook->bid_size();
+    tbs = orderbook->total_bid_size();
+    if( bp != conv(mid + incr*2) || bs != sz || tbs != sz )
+        return 2;
+
+    if( orderbook->get_order_info(id).size != sz * 2 )
+        return 3;
+
+    /* hidden size counts toward fill-or-kill */
+    orderbook->insert_fill_or_kill_order(false, conv(mid + incr*2), sz * 2, ecb);
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id) )
+        return 4;
+
+    bs = orderbook->bid_size();
+    if( bs != 0 )
+        return 5;
+
+    tv = orderbook->volume();
+    if( tv != sz * 4 )
+        return 6;
+
+    try{
+        AdvancedOrderTicketICEBERG::build(0);
+        return 7;
+    }catch(std::invalid_argument&){
+    }
+
+    try{
+        orderbook->insert_market_order(true, sz, ecb, aot);
+        return 8;
+    }catch(advanced_order_error&){
+    }
+
+    try{
+        orderbook->insert_stop_order(true, conv(mid + incr*4), sz, ecb, aot);
+        return 9;
+    }catch(advanced_order_error&){
+    }
+
+    return 0;
+}
+
+#endif /* RUN_FUNCTIONAL_TESTS */
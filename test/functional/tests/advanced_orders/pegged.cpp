@@ -0,0 +1,221 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../../functional.hpp"
+
+#ifdef RUN_FUNCTIONAL_TESTS
+
+#include <map>
+#include <iostream>
+
+using namespace sob;
+using namespace std;
+
+namespace {
+    map<id_type, id_type> ids;
+    auto ecb = create_advanced_callback(ids);
+    size_t sz = 100;
+}
+
+
+// primary peg follows the (non-pegged) bid, respects its cap
+int
+TEST_advanced_PEG_1(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    orderbook->insert_limit_order(false, conv(mid + incr*10), sz, ecb);
+    orderbook->insert_limit_order(true, mid, sz, ecb);
+
+    auto aot = AdvancedOrderTicketPEG::build_primary(1);
+    id_type id = orderbook->insert_limit_order(true, conv(mid + incr*5), sz,
+                                               ecb, aot);
+    dump_orders(orderbook,out);
+
+    auto oi = orderbook->get_order_info(id);
+    out<< "ORDER INFO: " << id << " " << oi << endl;
+    if( oi.limit != conv(mid - incr) )
+        return 1;
+    if( oi.advanced.condition() != order_condition::primary_peg
+        || oi.advanced.order1()->limit_nticks() != 1 )
+        return 2;
+
+    /* bid moves up, peg follows */
+    id_type id2 = orderbook->insert_limit_order(true, conv(mid + incr*2), sz, ecb);
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id).limit != conv(mid + incr) )
+        return 3;
+
+    /* bid moves back down */
+    if( !orderbook->pull_order(id2) )
+        return 4;
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id).limit != conv(mid - incr) )
+        return 5;
+
+    /* never re-priced through the cap */
+    id2 = orderbook->insert_limit_order(true, conv(mid + incr*8), sz, ecb);
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id).limit != conv(mid + incr*5) )
+        return 6;
+
+    if( orderbook->volume() != 0 )
+        return 7;
+
+    if( !orderbook->pull_order(id) )
+        return 8;
+
+    /* pulled pegs stay pulled */
+    orderbook->pull_order(id2);
+    if( orderbook->get_order_info(id) )
+        return 9;
+
+    if( orderbook->bid_price() != mid )
+        return 10;
+
+    return 0;
+}
+
+
+// mid and market pegs, no crossing, fills
+int
+TEST_advanced_PEG_2(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    orderbook->insert_limit_order(false, conv(mid + incr*10), sz, ecb);
+    orderbook->insert_limit_order(true, mid, sz, ecb);
+
+    id_type id1 = orderbook->insert_limit_order(true, end, sz, ecb,
+                                   AdvancedOrderTicketPEG::build_mid());
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id1).limit != conv(mid + incr*5) )
+        return 1;
+
+    /* pegs to bid + 2 but the mid peg is the (real) bid */
+    id_type id2 = orderbook->insert_limit_order(false, beg, sz, ecb,
+                                   AdvancedOrderTicketPEG::build_market(2));
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id2).limit != conv(mid + incr*6) )
+        return 2;
+
+    if( !orderbook->pull_order(id1) )
+        return 3;
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id2).limit != conv(mid + incr*2) )
+        return 4;
+
+    /* pegs to the ask, held one tick inside the (real) ask */
+    id_type id3 = orderbook->insert_limit_order(true, end, sz, ecb,
+                                   AdvancedOrderTicketPEG::build_market());
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id3).limit != conv(mid + incr) )
+        return 5;
+
+    if( orderbook->volume() != 0 )
+        return 6;
+
+    /* still trade like any other limit */
+    orderbook->insert_limit_order(false, conv(mid + incr), sz, ecb);
+    dump_orders(orderbook,out);
+
+    if( orderbook->volume() != sz )
+        return 7;
+
+    if( orderbook->get_order_info(id3) )
+        return 8;
+
+    /* buy side reference is unchanged */
+    if( orderbook->get_order_info(id2).limit != conv(mid + incr*2) )
+        return 9;
+
+    try{
+        orderbook->insert_market_order(true, sz, ecb,
+                                       AdvancedOrderTicketPEG::build_primary());
+        return 10;
+    }catch(advanced_order_error&){
+    }
+
+    return 0;
+}
+
+
+// modify: size up w/ a new cap re-queues the peg where it is
+int
+TEST_advanced_PEG_3(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    orderbook->insert_limit_order(false, conv(mid + incr*2), sz, ecb);
+    orderbook->insert_limit_order(true, mid, sz, ecb);
+
+    id_type id = orderbook->insert_limit_order(true, conv(mid + incr), sz,
+                                   ecb, AdvancedOrderTicketPEG::build_primary());
+    dump_orders(orderbook,out);
+
+    if( orderbook->get_order_info(id).limit != mid )
+        return 1;
+
+    /* a cap through the ask doesn't put it there */
+    if( !orderbook->modify_order(id, sz*2, conv(mid + incr*3)) )
+        return 2;
+    dump_orders(orderbook,out);
+
+    auto oi = orderbook->get_order_info(id);
+    if( oi.limit != mid || oi.size != sz*2 )
+        return 3;
+    if( orderbook->volume() != 0 || orderbook->ask_price() != conv(mid + incr*2)
+        || orderbook->bid_size() != sz*3 )
+        return 4;
+
+    /* a cap below the bid re-prices it to the cap */
+    if( !orderbook->modify_order(id, sz*3, conv(mid - incr)) )
+        return 5;
+    dump_orders(orderbook,out);
+
+    oi = orderbook->get_order_info(id);
+    if( oi.limit != conv(mid - incr) || oi.size != sz*3 )
+        return 6;
+    if( orderbook->bid_price() != mid || orderbook->bid_size() != sz )
+        return 7;
+
+    return 0;
+}
+
+#endif /* RUN_FUNCTIONAL_TESTS */
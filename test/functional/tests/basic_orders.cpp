@@ -19,6 +19,8 @@ along with this program. If not, see http://www.gnu.org/licenses.
 
 #ifdef RUN_FUNCTIONAL_TESTS
 
+#include <map>
+
 using namespace sob;
 using namespace std;
 
@@ -353,4 +355,93 @@ TEST_basic_orders_ASYNC_1(FullInterface *orderbook, std::ostream& out)
     return 0;
 }
 
+int
+TEST_immediate_orders_1(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double b = conv((beg + end) / 2);
+
+    map<id_type, size_t> kills;
+    auto ecb = [&]( callback_msg msg, id_type id1, id_type id2,
+                    double price, size_t size)
+        {
+            if( msg == callback_msg::kill )
+                kills[id1] = size;
+            callback(msg,id1,id2,price,size);
+        };
+
+    orderbook->insert_limit_order(false, conv(b+incr), sz, ecb);
+    orderbook->insert_limit_order(false, conv(b+2*incr), sz*2, ecb);
+    orderbook->dump_limits(out);
+
+    out<< " FOK (buy, no cross) - should kill" << endl;
+    id_type id1 = orderbook->insert_fill_or_kill_order(true, b, sz, ecb);
+
+    out<< " FOK (buy, not enough depth) - should kill" << endl;
+    id_type id2 = orderbook->insert_fill_or_kill_order(true, conv(b+2*incr),
+                                                       sz*3+1, ecb);
+    orderbook->dump_limits(out);
+
+    if( kills.size() != 2 || kills[id1] != sz || kills[id2] != sz*3+1 )
+        return 1;
+    else if( orderbook->volume() != 0 || orderbook->total_ask_size() != sz*3 )
+        return 2;
+    else if( orderbook->total_bid_size() != 0 )
+        return 3;
+
+    out<< " FOK (buy, two levels) - should fill" << endl;
+    orderbook->insert_fill_or_kill_order(true, conv(b+2*incr), sz*2, ecb);
+    orderbook->dump_limits(out);
+
+    if( kills.size() != 2 )
+        return 4;
+    else if( orderbook->volume() != sz*2 || orderbook->ask_size() != sz )
+        return 5;
+    else if( orderbook->ask_price() != conv(b+2*incr) )
+        return 6;
+
+    out<< " IOC (buy, partial) - should fill then kill the rest" << endl;
+    id_type id3 = orderbook->insert_immediate_or_cancel_order(
+        true, conv(b+2*incr), sz*2, ecb);
+    orderbook->dump_limits(out);
+
+    if( kills.size() != 3 || kills[id3] != sz )
+        return 7;
+    else if( orderbook->volume() != sz*3 || orderbook->total_size() != 0 )
+        return 8;
+
+    out<< " IOC (sell, empty book) - should kill" << endl;
+    id_type id4 = orderbook->insert_immediate_or_cancel_order(false, b, sz, ecb);
+
+    if( kills.size() != 4 || kills[id4] != sz || orderbook->total_size() != 0 )
+        return 9;
+
+    orderbook->insert_limit_order(true, b, sz, ecb);
+
+    out<< " IOC (sell, ASYNC) - should fill" << endl;
+    orderbook->insert_immediate_or_cancel_order_async(false, beg, sz/2, ecb)
+              .wait();
+    orderbook->wait_for_async_callbacks();
+    orderbook->dump_limits(out);
+
+    if( kills.size() != 4 )
+        return 10;
+    else if( orderbook->bid_size() != sz/2 || orderbook->volume() != sz*3 + sz/2 )
+        return 11;
+
+    out<< " FOK (sell, ASYNC) - should kill" << endl;
+    id_type id5 = orderbook->insert_fill_or_kill_order_async(false, beg, sz, ecb)
+                            .get();
+    orderbook->wait_for_async_callbacks();
+
+    if( kills.size() != 5 || kills[id5] != sz || orderbook->bid_size() != sz/2 )
+        return 12;
+
+    return 0;
+}
+
 #endif /* RUN_FUNCTIONAL_TESTS */
@@ -23,7 +23,14 @@ along with this program. If not, see http://www.gnu.org/licenses.
 #include <vector>
 #include <tuple>
 #include <random>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
 #include <stdexcept>
 
 #include "../../../include/tick_price.hpp"
@@ -224,6 +231,1254 @@ TEST_grow_2(FullInterface *full_orderbook, std::ostream& out)
 }
 
 
+// huge (sparse) growth: only the levels that get used should cost anything
+int
+TEST_grow_3(FullInterface *full_orderbook, std::ostream& out)
+{
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    size_t nticks = 10000000;
+
+    id_type id1 = orderbook->insert_limit_order(true, beg, sz);
+    id_type id2 = orderbook->insert_limit_order(false, end, sz);
+
+    orderbook->grow_book_above( end + (incr * nticks) );
+    double new_end = orderbook->max_price();
+    if( orderbook->ticks_in_range() < static_cast<long long>(nticks) )
+        return 1;
+
+    id_type id3 = orderbook->insert_limit_order(false, new_end, sz);
+    if( orderbook->get_order_info(id3).limit != new_end )
+        return 2;
+
+    orderbook->grow_book_below( orderbook->tick_size() );
+    orderbook->dump_internal_pointers(out);
+
+    if( orderbook->get_order_info(id1).limit != beg )
+        return 3;
+    if( orderbook->get_order_info(id2).limit != end )
+        return 4;
+    if( orderbook->get_order_info(id3).limit != new_end )
+        return 5;
+
+    /* trade through both old ends */
+    orderbook->insert_market_order(true, sz * 2);
+    orderbook->insert_market_order(false, sz);
+    if( orderbook->volume() != sz * 3 )
+        return 6;
+    if( orderbook->get_order_info(id1) || orderbook->get_order_info(id2)
+        || orderbook->get_order_info(id3) )
+        return 7;
+    if( orderbook->bid_size() != 0 || orderbook->ask_size() != 0 )
+        return 8;
+
+    return 0;
+}
+
+
+// auto-grow: geometric, capped, off by default
+int
+TEST_grow_4(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    long long ticks = orderbook->ticks_in_range();
+
+    vector<book_growth_event> events;
+    auto gcb = [&](const book_growth_event& e){ events.push_back(e); };
+
+    try{
+        orderbook->insert_limit_order(false, conv(end + incr), sz);
+        return 1;
+    }catch(std::invalid_argument&){
+    }
+
+    orderbook->set_auto_grow(1.0, 0, gcb);
+
+    /* (at least) doubles */
+    id_type id1 = orderbook->insert_limit_order(false, conv(end + incr), sz);
+    orderbook->dump_internal_pointers(out);
+    if( orderbook->get_order_info(id1).limit != conv(end + incr) )
+        return 2;
+    if( events.size() != 1 || !events[0].above )
+        return 3;
+    if( orderbook->ticks_in_range() < ticks * 2 )
+        return 4;
+    if( events[0].max_price != orderbook->max_price()
+        || events[0].min_price != beg
+        || events[0].nticks_added < static_cast<size_t>(ticks) )
+        return 5;
+
+    /* bracket target out of range */
+    double target = conv(orderbook->max_price() + incr * 10);
+    auto aot = AdvancedOrderTicketBRACKET::build_sell_stop_limit(
+                   conv(beg + incr), conv(beg + incr), target);
+    id_type id2 = orderbook->insert_limit_order(true, conv(beg + incr * 2),
+                                                sz, nullptr, aot);
+    if( !id2 || events.size() != 2 || orderbook->max_price() < target )
+        return 6;
+
+    /* hard cap */
+    ticks = orderbook->ticks_in_range();
+    orderbook->set_auto_grow(1.0, static_cast<size_t>(ticks) + 10, gcb);
+    try{
+        orderbook->insert_limit_order(false,
+                                      conv(orderbook->max_price() + incr * 11),
+                                      sz);
+        return 7;
+    }catch(std::invalid_argument&){
+    }
+    if( events.size() != 2 )
+        return 8;
+
+    /* ... but only grows as far as the cap */
+    orderbook->insert_limit_order(false,
+                                  conv(orderbook->max_price() + incr * 5), sz);
+    if( events.size() != 3 || orderbook->ticks_in_range() != ticks + 10 )
+        return 9;
+
+    /* off */
+    orderbook->set_auto_grow(0);
+    try{
+        orderbook->insert_limit_order(false,
+                                      conv(orderbook->max_price() + incr), sz);
+        return 10;
+    }catch(std::invalid_argument&){
+    }
+
+    if( !orderbook->pull_order(id1) || !orderbook->pull_order(id2) )
+        return 11;
+
+    return 0;
+}
+
+
+// shrink fails safely if anything is out there
+int
+TEST_shrink_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    id_type id1 = orderbook->insert_limit_order(true, conv(mid - incr*3), sz);
+    id_type id2 = orderbook->insert_limit_order(false, conv(mid + incr*3), sz);
+    orderbook->insert_market_order(true, sz/2);
+
+    if( orderbook->shrink_book(conv(mid - incr*2), end) )
+        return 1;
+    if( orderbook->min_price() != beg || orderbook->max_price() != end )
+        return 2;
+
+    auto aot = AdvancedOrderTicketBRACKET::build_sell_stop_limit(
+                   conv(mid - incr*6), conv(mid - incr*6), conv(mid + incr*6));
+    id_type id3 = orderbook->insert_limit_order(true, conv(mid - incr), sz,
+                                                nullptr, aot);
+    if( orderbook->shrink_book(conv(mid - incr*5), conv(mid + incr*7)) )
+        return 3;
+    if( !orderbook->pull_order(id3) )
+        return 4;
+
+    if( !orderbook->shrink_book(conv(mid - incr*5), conv(mid + incr*5)) )
+        return 5;
+    orderbook->dump_internal_pointers(out);
+    if( orderbook->min_price() != conv(mid - incr*5)
+        || orderbook->max_price() != conv(mid + incr*5) )
+        return 6;
+
+    if( orderbook->get_order_info(id1).limit != conv(mid - incr*3)
+        || orderbook->get_order_info(id2).size != sz - sz/2 )
+        return 7;
+    if( orderbook->bid_price() != conv(mid - incr*3)
+        || orderbook->ask_price() != conv(mid + incr*3) )
+        return 8;
+
+    /* last trade (at mid - 3) has to stay */
+    orderbook->insert_market_order(false, sz);
+    if( orderbook->get_order_info(id1) )
+        return 9;
+    if( orderbook->shrink_book(conv(mid - incr*2), conv(mid + incr*5)) )
+        return 10;
+
+    /* the released range can be grown back into */
+    orderbook->grow_book_above(end);
+    orderbook->grow_book_below(beg);
+    if( orderbook->min_price() != beg || orderbook->max_price() != end )
+        return 11;
+    if( !orderbook->insert_limit_order(false, end, sz)
+        || !orderbook->insert_limit_order(true, beg, sz) )
+        return 12;
+    if( orderbook->ask_price() != conv(mid + incr*3) )
+        return 13;
+
+    try{
+        orderbook->shrink_book(mid, conv(mid + incr));
+        return 14;
+    }catch(std::invalid_argument&){
+    }
+    try{
+        orderbook->shrink_book(end, beg);
+        return 15;
+    }catch(std::invalid_argument&){
+    }
+
+    return 0;
+}
+
+
+// auto recenter
+int
+TEST_shrink_2(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    orderbook->set_auto_recenter(2);
+
+    /* first order, then only if a side gets > 2 x margin from the market */
+    id_type id1 = orderbook->insert_limit_order(true, mid, sz);
+    id_type id2 = orderbook->insert_limit_order(false, conv(mid + incr), sz);
+    orderbook->dump_internal_pointers(out);
+    if( orderbook->min_price() != conv(mid - incr*2)
+        || orderbook->max_price() != conv(mid + incr*2) )
+        return 1;
+
+    /* market moves up (and out) */
+    orderbook->set_auto_grow(0.01);
+    id_type id3 = orderbook->insert_limit_order(false, conv(mid + incr*8), sz);
+    if( orderbook->max_price() != conv(mid + incr*8)
+        || orderbook->min_price() != conv(mid - incr*2) )
+        return 2;
+
+    if( !orderbook->pull_order(id1) )
+        return 3;
+    if( orderbook->min_price() != conv(mid - incr*2) )
+        return 4;
+
+    /* nothing below mid + 8 now */
+    if( !orderbook->pull_order(id2) )
+        return 5;
+    orderbook->dump_internal_pointers(out);
+    if( orderbook->min_price() != conv(mid + incr*6)
+        || orderbook->max_price() != conv(mid + incr*8) )
+        return 6;
+
+    id_type id4 = orderbook->insert_limit_order(true, conv(mid + incr*7), sz);
+
+    if( orderbook->bid_price() != conv(mid + incr*7)
+        || orderbook->ask_price() != conv(mid + incr*8) )
+        return 7;
+
+    orderbook->set_auto_recenter(0);
+    orderbook->set_auto_grow(0);
+    if( !orderbook->pull_order(id3) || !orderbook->pull_order(id4) )
+        return 8;
+
+    return 0;
+}
+
+
+int
+TEST_shrink_3(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    id_type id1 = orderbook->insert_limit_order(true, mid, sz);
+    orderbook->insert_limit_order(false, conv(mid + incr*2), sz);
+
+    /* a peg (resting at the bid) whose cap is outside the new range */
+    id_type id2 = orderbook->insert_limit_order(true, conv(mid + incr*6), sz,
+                                  nullptr, AdvancedOrderTicketPEG::build_primary());
+    if( orderbook->get_order_info(id2).limit != mid )
+        return 1;
+
+    if( orderbook->shrink_book(conv(mid - incr*3), conv(mid + incr*4)) )
+        return 2;
+    if( orderbook->min_price() != beg || orderbook->max_price() != end )
+        return 3;
+
+    /* re-pegs (inside the range) */
+    if( !orderbook->pull_order(id1) )
+        return 4;
+    orderbook->dump_internal_pointers(out);
+
+    /* w/ the cap inside it's fine */
+    if( !orderbook->modify_order(id2, sz, conv(mid + incr*3)) )
+        return 5;
+    if( !orderbook->shrink_book(conv(mid - incr*3), conv(mid + incr*4)) )
+        return 6;
+    orderbook->dump_internal_pointers(out);
+    if( orderbook->min_price() != conv(mid - incr*3)
+        || orderbook->max_price() != conv(mid + incr*4) )
+        return 7;
+
+    return 0;
+}
+
+
+namespace {
+
+int
+compare_books(FullInterface *a, FullInterface *b, bool with_timesales = true)
+{
+    if( a->min_price() != b->min_price() || a->max_price() != b->max_price() )
+        return 1;
+    if( a->bid_price() != b->bid_price() || a->ask_price() != b->ask_price()
+        || a->last_price() != b->last_price() )
+        return 2;
+    if( a->total_size() != b->total_size() || a->volume() != b->volume()
+        || a->last_id() != b->last_id() )
+        return 3;
+    if( a->market_depth(1000) != b->market_depth(1000) )
+        return 4;
+
+    if( with_timesales ){
+        auto ts_a = a->time_and_sales();
+        auto ts_b = b->time_and_sales();
+        if( ts_a.size() != ts_b.size() )
+            return 5;
+        for( size_t i = 0; i < ts_a.size(); ++i ){
+            if( get<1>(ts_a[i]) != get<1>(ts_b[i])
+                || get<2>(ts_a[i]) != get<2>(ts_b[i]) )
+                return 6;
+        }
+    }
+
+    for( id_type id = 1; id <= a->last_id(); ++id ){
+        order_info oi_a = a->get_order_info(id);
+        order_info oi_b = b->get_order_info(id);
+        if( oi_a.type != oi_b.type )
+            return 7;
+        if( oi_a && to_string(oi_a) != to_string(oi_b) )
+            return 8;
+    }
+    return 0;
+}
+
+};
+
+
+int
+TEST_journal_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+    const DefaultFactoryProxy& proxy = proxy_for(full_orderbook);
+
+    const string path = "sob-functional-test.journal";
+    std::remove(path.c_str());
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    orderbook->start_journal(path, 1);
+
+    id_type id1 = orderbook->insert_limit_order(true, mid, sz);
+    orderbook->insert_limit_order(true, conv(mid - incr), sz*2);
+    id_type id3 = orderbook->insert_limit_order(false, conv(mid + incr), sz);
+    orderbook->insert_limit_order(false, conv(mid + incr*2), sz*3);
+    orderbook->insert_stop_order(false, conv(mid - incr), sz);
+    orderbook->insert_limit_order( true, conv(mid - incr*3), sz,
+        nullptr, AdvancedOrderTicketOCO::build_limit(true, conv(mid - incr*4), sz) );
+    orderbook->insert_market_order(false, sz/2);
+    orderbook->replace_with_limit_order(id3, false, conv(mid + incr*3), sz);
+    orderbook->modify_order(id1, sz*4);
+    orderbook->grow_book_above(end + incr*10);
+    orderbook->insert_limit_order(false, conv(end + incr*10), sz);
+    orderbook->insert_market_order(false, sz*2);
+    orderbook->sync_journal();
+    orderbook->stop_journal();
+
+    print_orderbook_state(orderbook, out);
+
+    FullInterface *full_replayed = proxy.create(beg, end);
+    ManagementInterface *replayed =
+            dynamic_cast<ManagementInterface*>(full_replayed);
+
+    int ret = 0;
+    size_t n = replayed->replay_journal(path);
+    out << "replayed " << n << " records" << endl;
+    print_orderbook_state(replayed, out);
+    if( n != 12 ){
+        ret = 1;
+    }else if( int err = compare_books(orderbook, replayed) ){
+        ret = 1 + err;
+    }
+
+    /* only into a new book */
+    if( !ret ){
+        try{
+            replayed->replay_journal(path);
+            ret = 20;
+        }catch(std::logic_error&){
+        }
+    }
+    proxy.destroy(full_replayed);
+
+    /* a torn (last) record is dropped */
+    if( !ret ){
+        {
+            ofstream f(path, ios::binary | ios::app);
+            f.put(0);
+            f.put(static_cast<char>(order_type::limit));
+        }
+        full_replayed = proxy.create(beg, end);
+        replayed = dynamic_cast<ManagementInterface*>(full_replayed);
+        if( replayed->replay_journal(path) != n ){
+            ret = 21;
+        }else if( int err = compare_books(orderbook, replayed) ){
+            ret = 21 + err;
+        }
+        proxy.destroy(full_replayed);
+    }
+
+    /* re-opening it cuts the torn record off before appending */
+    if( !ret ){
+        orderbook->start_journal(path, 1);
+        orderbook->insert_limit_order(true, conv(mid - incr*5), sz);
+        orderbook->sync_journal();
+        orderbook->stop_journal();
+        full_replayed = proxy.create(beg, end);
+        replayed = dynamic_cast<ManagementInterface*>(full_replayed);
+        if( replayed->replay_journal(path) != n + 1 ){
+            ret = 30;
+        }else if( int err = compare_books(orderbook, replayed) ){
+            ret = 30 + err;
+        }
+        proxy.destroy(full_replayed);
+    }
+
+    /* a bad record before the end is an error */
+    if( !ret ){
+        {
+            fstream f(path, ios::binary | ios::in | ios::out);
+            f.seekp(64);
+            f.put(static_cast<char>(0xFF));
+        }
+        full_replayed = proxy.create(beg, end);
+        replayed = dynamic_cast<ManagementInterface*>(full_replayed);
+        try{
+            replayed->replay_journal(path);
+            ret = 40;
+        }catch(std::runtime_error&){
+        }
+        proxy.destroy(full_replayed);
+    }
+
+    std::remove(path.c_str());
+    return ret;
+}
+
+
+int
+TEST_snapshot_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+    const DefaultFactoryProxy& proxy = proxy_for(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    orderbook->insert_limit_order(true, mid, sz);
+    orderbook->insert_limit_order(true, conv(mid - incr), sz*2);
+    id_type id3 = orderbook->insert_limit_order(false, conv(mid + incr), sz);
+    orderbook->insert_limit_order(false, conv(mid + incr*2), sz*3);
+    orderbook->insert_market_order(false, sz/2);
+    orderbook->insert_stop_order(false, conv(mid - incr*3), sz);
+    orderbook->insert_stop_order(true, conv(mid + incr*5), conv(mid + incr*6), sz);
+    orderbook->insert_limit_order( true, conv(mid - incr*4), sz, nullptr,
+        AdvancedOrderTicketOCO::build_limit(true, conv(mid - incr*5), sz) );
+    orderbook->insert_limit_order( true, conv(mid - incr*2), sz, nullptr,
+        AdvancedOrderTicketOTO::build_limit(false, conv(mid + incr*4), sz) );
+    orderbook->insert_limit_order( true, conv(mid - incr*6), sz, nullptr,
+        AdvancedOrderTicketBRACKET::build_sell_stop(conv(mid - incr*8),
+                                                    conv(mid + incr*6)) );
+    orderbook->insert_limit_order( true, conv(mid - incr*7), sz, nullptr,
+        AdvancedOrderTicketTrailingStop::build(5) );
+    orderbook->insert_limit_order( true, conv(mid - incr*7), sz, nullptr,
+        AdvancedOrderTicketTrailingBracket::build(5, 10) );
+    orderbook->insert_market_order( true, sz, nullptr,
+        AdvancedOrderTicketTrailingStop::build(4) );
+    orderbook->insert_market_order( true, sz, nullptr,
+        AdvancedOrderTicketTrailingBracket::build(4, 8) );
+    orderbook->insert_limit_order( false, conv(mid + incr*3), sz*10, nullptr,
+        AdvancedOrderTicketAON::build() );
+    orderbook->insert_limit_order( true, conv(mid - incr*9), sz*5, nullptr,
+        AdvancedOrderTicketAON::build() );
+    orderbook->insert_limit_order( false, conv(mid + incr*7), sz*5, nullptr,
+        AdvancedOrderTicketICEBERG::build(sz) );
+    orderbook->insert_limit_order( true, conv(mid + incr), sz, nullptr,
+        AdvancedOrderTicketPEG::build_primary(1) );
+    orderbook->pull_order(id3);
+
+    print_orderbook_state(orderbook, out);
+
+    std::stringstream ss;
+    size_t n = orderbook->snapshot(ss);
+    out << "snapshot of " << n << " orders" << endl;
+
+    /* restore into a smaller book; it takes on the snapshot's range */
+    FullInterface *full_restored = proxy.create(conv(mid - incr*20),
+                                                conv(mid + incr*20));
+    ManagementInterface *restored =
+            dynamic_cast<ManagementInterface*>(full_restored);
+
+    int ret = 0;
+    if( restored->restore(ss) != n ){
+        ret = 1;
+    }else if( int err = compare_books(orderbook, restored, false) ){
+        ret = 1 + err;
+    }
+    print_orderbook_state(restored, out);
+
+    /* and they behave the same from here on */
+    if( !ret ){
+        for( ManagementInterface *ob : {orderbook, restored} ){
+            ob->insert_limit_order(true, conv(mid + incr*8), sz*12);
+            ob->insert_limit_order(false, conv(mid + incr*8), sz*2);
+            ob->insert_limit_order(false, conv(mid - incr*2), sz*4);
+            ob->insert_limit_order(true, conv(mid - incr), sz*3);
+        }
+        print_orderbook_state(restored, out);
+        if( int err = compare_books(orderbook, restored, false) )
+            ret = 10 + err;
+    }
+
+    /* only into a new book */
+    if( !ret ){
+        std::stringstream ss2;
+        orderbook->snapshot(ss2);
+        try{
+            restored->restore(ss2);
+            ret = 20;
+        }catch(std::logic_error&){
+        }
+    }
+
+    /* not a snapshot */
+    if( !ret ){
+        std::stringstream junk("this isn't a snapshot");
+        FullInterface *full_other = proxy.create(beg, end);
+        try{
+            dynamic_cast<ManagementInterface*>(full_other)->restore(junk);
+            ret = 21;
+        }catch(std::runtime_error&){
+        }
+        proxy.destroy(full_other);
+    }
+
+    proxy.destroy(full_restored);
+    return ret;
+}
+
+
+int
+TEST_timesales_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    auto trade = [&](int n){
+        for( int i = 0; i < n; ++i ){
+            orderbook->insert_limit_order(true, conv(mid - (i % 3) * incr), sz);
+            orderbook->insert_market_order(false, sz);
+        }
+    };
+
+    /* a reader polling (w/o the lock) while trades happen */
+    unsigned long long nread = 0;
+    std::atomic<bool> done(false);
+    std::thread reader( [&](){
+        vector<timesale_entry_type> buf;
+        unsigned long long seq = 0;
+        while( !done.load() ){
+            buf.clear();
+            seq = orderbook->read_trades_since(seq, buf);
+            nread += buf.size();
+        }
+        buf.clear();
+        orderbook->read_trades_since(seq, buf);
+        nread += buf.size();
+    } );
+    trade(20);
+    done.store(true);
+    reader.join();
+    out<< "read " << nread << " trades while trading" << endl;
+    if( nread != 20 )
+        return 1;
+
+    vector<timesale_entry_type> buf;
+    unsigned long long seq = orderbook->read_trades_since(0, buf);
+    if( seq != 20 || buf.size() != 20 || buf != orderbook->time_and_sales() )
+        return 2;
+
+    /* cursor picks up where it left off */
+    trade(3);
+    buf.clear();
+    seq = orderbook->read_trades_since(seq, buf);
+    if( seq != 23 || buf.size() != 3 || get<1>(buf[0]) != mid )
+        return 3;
+
+    /* shrink it; the most recent trades (and their #s) carry over */
+    orderbook->set_time_and_sales(5); // -> 8
+    auto ts = orderbook->time_and_sales();
+    if( ts.size() != 8 )
+        return 4;
+    buf.clear();
+    if( orderbook->read_trades_since(20, buf) != 23 || buf.size() != 3 )
+        return 5;
+
+    /* fall behind and it skips ahead to the oldest one held */
+    trade(10);
+    buf.clear();
+    seq = orderbook->read_trades_since(seq, buf);
+    if( seq != 33 || buf.size() != 8 )
+        return 6;
+
+    /* memory-mapped */
+    const string path = "sob-functional-test.timesales";
+    orderbook->set_time_and_sales(16, path);
+    trade(2);
+    buf.clear();
+    if( orderbook->read_trades_since(0, buf) != 35 || buf.size() != 10 )
+        return 7;
+    {
+        ifstream f(path, ios::binary);
+        char magic[4] = {};
+        f.read(magic, 4);
+        if( string(magic, 4) != "SOBT" )
+            return 8;
+    }
+    orderbook->set_time_and_sales(1 << 20);
+    std::remove(path.c_str());
+
+    buf.clear();
+    if( orderbook->read_trades_since(0, buf) != 35 || buf.size() != 10 )
+        return 9;
+    dump_orders(orderbook, out);
+    return 0;
+}
+
+
+int
+TEST_timesales_2(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    /* small enough that it wraps */
+    orderbook->set_time_and_sales(16);
+
+    for( int i = 0; i < 27; ++i ){
+        orderbook->insert_limit_order(true, conv(mid - (i % 4) * incr),
+                                      sz * (1 + i % 5));
+        orderbook->insert_market_order(false, sz * (1 + i % 5));
+    }
+
+    auto naive = [](const vector<timesale_entry_type>& ts,
+                    clock_type::time_point from, clock_type::time_point to,
+                    std::map<double, unsigned long long>& profile){
+        double n = 0;
+        unsigned long long v = 0;
+        profile.clear();
+        for( auto& t : ts ){
+            if( get<0>(t) < from || get<0>(t) > to )
+                continue;
+            n += get<1>(t) * get<2>(t);
+            v += get<2>(t);
+            profile[get<1>(t)] += get<2>(t);
+        }
+        return v ? n / v : 0;
+    };
+
+    auto ts = orderbook->time_and_sales();
+    if( ts.size() != 16 )
+        return 1;
+
+    std::map<double, unsigned long long> expected;
+    vector<pair<clock_type::time_point, clock_type::time_point>> windows = {
+        {clock_type::time_point::min(), clock_type::time_point::max()},
+        {get<0>(ts[3]), get<0>(ts[12])},
+        {get<0>(ts[0]), get<0>(ts[0])},
+        {get<0>(ts[15]), clock_type::time_point::max()},
+        {get<0>(ts[15]) + std::chrono::hours(1), clock_type::time_point::max()}
+    };
+    int err = 2;
+    for( auto& w : windows ){
+        double v = naive(ts, w.first, w.second, expected);
+        double vw = orderbook->vwap(w.first, w.second);
+        out<< "vwap " << vw << " (expected " << v << ")" << endl;
+        if( std::abs(vw - v) > 1e-9 * std::max(1.0, v) )
+            return err;
+        if( orderbook->volume_profile(w.first, w.second) != expected )
+            return err + 1;
+        err += 2;
+    }
+    if( orderbook->vwap(clock_type::time_point::max(),
+                        clock_type::time_point::min()) != 0 )
+        return 20;
+    return 0;
+}
+
+
+int
+TEST_book_deltas_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    /* already resting; they're the first batch */
+    orderbook->insert_limit_order(true, mid, sz);
+    orderbook->insert_limit_order(true, conv(mid - incr), sz*2);
+    orderbook->insert_limit_order(false, conv(mid + incr), sz*2);
+
+    orderbook->start_book_deltas(1 << 12);
+
+    /* rebuild the book from the stream: L2 and L3 */
+    std::map<std::pair<double, bool>, size_t> levels;
+    std::map<id_type, std::tuple<double, bool, size_t>> orders;
+    unsigned long long seq = 0;
+    vector<book_delta> buf;
+
+    auto apply = [&](const book_delta& d){
+        auto level = std::make_pair(d.price, d.is_buy);
+        switch( d.dtype ){
+        case book_delta::type::order_add:
+            return orders.emplace(d.id, make_tuple(d.price, d.is_buy, d.size))
+                         .second;
+        case book_delta::type::order_modify:
+            if( !orders.count(d.id) )
+                return false;
+            get<2>(orders[d.id]) = d.size;
+            return true;
+        case book_delta::type::order_execute:
+            if( !orders.count(d.id) || get<2>(orders[d.id]) < d.size )
+                return false;
+            if( !(get<2>(orders[d.id]) -= d.size) )
+                orders.erase(d.id);
+            return true;
+        case book_delta::type::order_delete:
+            return orders.erase(d.id) == 1;
+        case book_delta::type::level_add:
+            return levels.emplace(level, d.size).second;
+        case book_delta::type::level_modify:
+            if( !levels.count(level) )
+                return false;
+            levels[level] = d.size;
+            return true;
+        case book_delta::type::level_delete:
+            return levels.erase(level) == 1;
+        }
+        return false;
+    };
+
+    auto check = [&]() -> int {
+        buf.clear();
+        unsigned long long next = orderbook->read_book_deltas(seq, buf);
+        for( const book_delta& d : buf ){
+            out<< d << endl;
+            if( d.seq != seq++ )
+                return 1;
+            if( !apply(d) )
+                return 2;
+        }
+        if( next != seq || (!buf.empty() && !buf.back().end_of_batch) )
+            return 3;
+
+        std::map<double, std::pair<size_t, side_of_market>> l2, l3;
+        for( auto& l : levels ){
+            l2[l.first.first] = { l.second, l.first.second ? side_of_market::bid
+                                                           : side_of_market::ask };
+        }
+        for( auto& o : orders ){
+            auto& l = l3[get<0>(o.second)];
+            l.first += get<2>(o.second);
+            l.second = get<1>(o.second) ? side_of_market::bid
+                                        : side_of_market::ask;
+        }
+        auto md = orderbook->market_depth(1000);
+        if( l2 != md )
+            return 4;
+        if( l3 != md )
+            return 5;
+        return 0;
+    };
+
+    int ret = 0;
+    auto step = [&](int err){
+        if( !ret ){
+            if( int e = check() )
+                ret = err + e;
+        }
+    };
+
+    step(0);
+    if( !ret && seq != 6 ) // 3 order adds, 3 level adds
+        ret = 9;
+
+    id_type id1 = orderbook->insert_limit_order(false, conv(mid + incr*2), sz);
+    id_type id2 = orderbook->insert_limit_order(true, conv(mid - incr*2), sz*3);
+    orderbook->insert_limit_order(true, conv(mid - incr*2), sz);
+    step(10);
+
+    /* through two levels, then rest (the level changes sides) */
+    orderbook->insert_limit_order(false, conv(mid - incr), sz*4);
+    step(20);
+    orderbook->insert_market_order(true, sz);
+    step(30);
+
+    /* smaller (keeps priority), bigger (to the back), new price, trades */
+    orderbook->modify_order(id2, sz);
+    step(40);
+    orderbook->modify_order(id2, sz*2);
+    step(50);
+    orderbook->modify_order(id2, sz*2, conv(mid - incr*3));
+    step(60);
+    orderbook->modify_order(id1, sz, conv(mid - incr*3));
+    step(70);
+
+    orderbook->pull_order(id2);
+    step(80);
+    id_type id3 = orderbook->insert_limit_order(true, conv(mid - incr*4), sz);
+    orderbook->replace_with_limit_order(id3, false, conv(mid + incr*3), sz*2);
+    step(90);
+
+    /* only the display size is visible; it's replenished */
+    orderbook->insert_limit_order( false, conv(mid + incr*5), sz*5, nullptr,
+                                   AdvancedOrderTicketICEBERG::build(sz) );
+    step(100);
+    orderbook->insert_limit_order(true, conv(mid + incr*5), sz*6);
+    step(110);
+
+    /* fills on a bracketed order resize the (active) target */
+    orderbook->insert_limit_order( true, conv(mid - incr*6), sz*2, nullptr,
+        AdvancedOrderTicketBRACKET::build_sell_stop(conv(mid - incr*20),
+                                                    conv(mid + incr*8)) );
+    step(120);
+    while( !ret && orderbook->bid_price() > conv(mid - incr*6) ){
+        orderbook->insert_market_order(false, orderbook->bid_size());
+        step(130);
+    }
+    orderbook->insert_market_order(false, sz);
+    step(140);
+    orderbook->insert_market_order(false, sz);
+    step(150);
+
+    /* AON orders aren't in the book's depth, or the stream */
+    unsigned long long before = seq;
+    id_type id4 = orderbook->insert_limit_order( true, conv(mid - incr*12),
+        sz*5, nullptr, AdvancedOrderTicketAON::build() );
+    orderbook->pull_order(id4);
+    step(160);
+    if( !ret && seq != before )
+        ret = 169;
+
+    print_orderbook_state(orderbook, out);
+
+    /* a reader that falls behind skips ahead */
+    if( !ret ){
+        orderbook->stop_book_deltas();
+        buf.clear();
+        if( orderbook->read_book_deltas(seq, buf) != seq || !buf.empty() )
+            ret = 170;
+    }
+    if( !ret ){
+        orderbook->start_book_deltas(16);
+        for( int i = 0; i < 8; ++i )
+            orderbook->insert_limit_order(true, conv(mid - incr*(8 + i)), sz);
+        buf.clear();
+        unsigned long long next = orderbook->read_book_deltas(0, buf);
+        if( buf.size() != 16 || buf.front().seq != next - 16 )
+            ret = 171;
+        try{
+            orderbook->start_book_deltas();
+            ret = 172;
+        }catch(std::logic_error&){
+        }
+        orderbook->stop_book_deltas();
+    }
+
+    return ret;
+}
+
+
+int
+TEST_depth_subscription_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    orderbook->insert_limit_order(true, mid, sz);
+    orderbook->insert_limit_order(false, conv(mid + incr), sz*2);
+
+    /* a fast and a slow subscriber, each mirroring the book */
+    struct mirror{
+        std::mutex mtx;
+        depth_update_type book;
+        size_t nupdates = 0;
+    } fast, slow;
+
+    auto subscribe = [&](mirror& m, unsigned interval_ms){
+        return orderbook->subscribe_depth(
+            [&m](const depth_update_type& update){
+                std::lock_guard<std::mutex> lock(m.mtx);
+                for( auto& l : update ){
+                    if( l.second.first )
+                        m.book[l.first] = l.second;
+                    else
+                        m.book.erase(l.first);
+                }
+                ++m.nupdates;
+            },
+            interval_ms
+        );
+    };
+
+    /* (updates are async) wait for it to catch up w/ the book */
+    auto in_sync = [&](mirror& m){
+        auto md = orderbook->market_depth(1000);
+        for( int i = 0; i < 1000; ++i ){
+            {
+                std::lock_guard<std::mutex> lock(m.mtx);
+                if( m.book == md )
+                    return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return false;
+    };
+
+    unsigned long long id_fast = subscribe(fast, 1);
+    unsigned long long id_slow = subscribe(slow, 200);
+    if( !in_sync(fast) || !in_sync(slow) )
+        return 1;
+
+    /* lots of changes to a few levels */
+    size_t nslow = slow.nupdates;
+    id_type id = orderbook->insert_limit_order(true, conv(mid - incr), sz);
+    for( int i = 0; i < 50; ++i ){
+        orderbook->modify_order(id, sz * (1 + i % 7));
+        orderbook->insert_limit_order(false, conv(mid + incr*(2 + i % 3)), sz);
+    }
+    orderbook->insert_market_order(true, sz*5);
+    orderbook->insert_limit_order(false, conv(mid - incr), sz*20);
+    orderbook->pull_order(id);
+    print_orderbook_state(orderbook, out);
+
+    if( !in_sync(fast) )
+        return 2;
+    if( !in_sync(slow) )
+        return 3;
+    out<< "updates: fast " << fast.nupdates << ", slow " << slow.nupdates
+       << endl;
+    if( slow.nupdates - nslow > 3 ) // conflated
+        return 4;
+
+    if( !orderbook->unsubscribe_depth(id_fast) )
+        return 5;
+    if( orderbook->unsubscribe_depth(id_fast) )
+        return 6;
+    size_t nfast = fast.nupdates;
+    orderbook->insert_limit_order(true, conv(mid - incr*4), sz);
+    if( !in_sync(slow) )
+        return 7;
+    if( fast.nupdates != nfast )
+        return 8;
+
+    /* last one out, then back in: it starts from the book as it is */
+    orderbook->unsubscribe_depth(id_slow);
+    orderbook->insert_limit_order(true, conv(mid - incr*5), sz);
+    mirror again;
+    id_slow = subscribe(again, 5);
+    if( !in_sync(again) )
+        return 9;
+    orderbook->unsubscribe_depth(id_slow);
+
+    /* a callback can query the book and unsubscribe itself */
+    std::atomic<unsigned long long> id_self(0);
+    std::atomic<int> nself(0);
+    id_self = orderbook->subscribe_depth(
+        [&](const depth_update_type&){
+            orderbook->market_depth(10);
+            ++nself;
+            while( !id_self ) // (could be called before subscribe returns)
+                std::this_thread::yield();
+            orderbook->unsubscribe_depth(id_self);
+        },
+        1
+    );
+    for( int i = 0; i < 1000 && !nself; ++i )
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    orderbook->insert_limit_order(true, conv(mid - incr*6), sz);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    if( nself != 1 )
+        return 10;
+
+    /* unsubscribe waits out a callback in progress */
+    std::atomic<bool> in_cb(false), unsubscribed(false), late(false);
+    id_slow = orderbook->subscribe_depth(
+        [&](const depth_update_type&){
+            in_cb = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if( unsubscribed )
+                late = true;
+        },
+        1
+    );
+    for( int i = 0; i < 1000 && !in_cb; ++i )
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    orderbook->insert_limit_order(true, conv(mid - incr*7), sz);
+    if( !orderbook->unsubscribe_depth(id_slow) )
+        return 11;
+    unsubscribed = true;
+    orderbook->insert_limit_order(true, conv(mid - incr*8), sz);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    if( !in_cb || late )
+        return 12;
+    return 0;
+}
+
+
+int
+TEST_latency_stats_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    if( !orderbook->latency_stats().empty() )
+        return 1;
+    orderbook->set_latency_stats(true);
+
+#ifdef SOB_NO_LATENCY_STATS
+    orderbook->insert_limit_order(true, conv(mid - incr), sz);
+    orderbook->dump_latency_stats(out);
+    return orderbook->latency_stats().empty() ? 0 : 2;
+#else
+    auto stats = orderbook->latency_stats();
+    if( stats.size() != NLATENCY_STAGES )
+        return 2;
+    for( auto& s : stats ){
+        if( s.second.count )
+            return 3;
+    }
+
+    std::atomic<size_t> ncbs(0);
+    auto cb = [&](callback_msg msg, id_type id1, id_type id2, double p, size_t s){
+        if( msg == callback_msg::fill )
+            ++ncbs;
+    };
+
+    unsigned long long norders = 0;
+    for( int i = 0; i < 20; ++i, ++norders ){
+        bool buy = i % 2;
+        double p = buy ? mid - incr * (1 + i % 3) : mid + incr * (1 + i % 3);
+        orderbook->insert_limit_order(buy, conv(p), sz, cb);
+    }
+    std::vector<std::future<id_type>> futs;
+    for( int i = 0; i < 4; ++i, ++norders )
+        futs.push_back( orderbook->insert_market_order_async(i % 2, sz, cb) );
+    for( auto& f : futs )
+        f.get();
+    orderbook->wait_for_async_callbacks();
+    print_orderbook_state(orderbook, out);
+    orderbook->dump_latency_stats(out);
+
+    stats = orderbook->latency_stats();
+    if( stats[latency_stage::execute].count != norders )
+        return 4;
+
+    /* inline books have no queue, lock or promise to time */
+    bool queued = stats[latency_stage::queue].count != 0;
+    for( auto s : {latency_stage::queue, latency_stage::lock,
+                   latency_stage::fulfil, latency_stage::total} ){
+        if( stats[s].count != (queued ? norders : 0) )
+            return 5;
+    }
+
+    /* 'sz' x 4 traded; cb on both sides of each trade */
+    if( ncbs == 0 || stats[latency_stage::callback].count < ncbs )
+        return 6;
+
+    for( auto& s : stats ){
+        const latency_summary& ls = s.second;
+        if( !ls.count )
+            continue;
+        if( ls.min > ls.p50 || ls.p50 > ls.p90 || ls.p90 > ls.p99
+            || ls.p99 > ls.p999 || ls.p999 > ls.max
+            || ls.mean < ls.min || ls.mean > ls.max ){
+            return 7;
+        }
+    }
+    if( queued && stats[latency_stage::total].max
+                  < stats[latency_stage::execute].max ){
+        return 8;
+    }
+
+    /* off leaves them as they are; back on starts over */
+    orderbook->set_latency_stats(false);
+    orderbook->insert_limit_order(true, conv(mid - incr*4), sz);
+    if( orderbook->latency_stats()[latency_stage::execute].count != norders )
+        return 9;
+    orderbook->set_latency_stats(true);
+    orderbook->insert_limit_order(true, conv(mid - incr*4), sz);
+    if( orderbook->latency_stats()[latency_stage::execute].count != 1 )
+        return 10;
+    return 0;
+#endif
+}
+
+
+int
+TEST_engine_stats_1(FullInterface *full_orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return full_orderbook->price_to_tick(d); };
+
+    ManagementInterface *orderbook =
+            dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double incr = orderbook->tick_size();
+    double mid = conv((beg + end) / 2);
+
+    engine_stats before = orderbook->stats();
+
+    /* a buy at mid + 1 sets off 3 buy stops, they take mid + 2 and 3 */
+    unsigned long long norders = 0;
+    for( int i = 1; i <= 3; ++i, ++norders )
+        orderbook->insert_limit_order(false, conv(mid + incr*i), sz);
+    orderbook->insert_limit_order(false, conv(mid + incr*3), sz);
+    orderbook->insert_limit_order(true, conv(mid - incr), sz);
+    norders += 2;
+    for( int i = 0; i < 3; ++i, ++norders )
+        orderbook->insert_stop_order(true, conv(mid + incr), sz);
+
+    std::atomic<size_t> ncbs(0);
+    auto cb = [&](callback_msg msg, id_type id1, id_type id2, double p, size_t s){
+        ++ncbs;
+    };
+    orderbook->insert_market_order_async(true, sz, cb).get();
+    ++norders;
+    orderbook->wait_for_async_callbacks();
+    print_orderbook_state(orderbook, out);
+
+    engine_stats after = orderbook->stats();
+    out<< "orders: " << after.orders_external << " / "
+       << after.orders_internal << ", cascades: " << after.cascades
+       << " (max " << after.cascade_max << ", queued "
+       << after.internal_queue_hwm << "), trades: " << after.trades
+       << " (" << after.matches << " fills, " << after.levels_scanned
+       << " levels, max " << after.levels_scanned_max << "), lock: "
+       << after.lock_acquisitions << " (" << after.lock_contended
+       << " waited " << after.lock_wait_ns << "ns)" << endl;
+
+    if( after.orders_external - before.orders_external != norders )
+        return 1;
+    if( after.lock_acquisitions - before.lock_acquisitions != norders )
+        return 2;
+    if( after.lock_contended > after.lock_acquisitions
+        || after.lock_wait_max_ns > after.lock_wait_ns ){
+        return 3;
+    }
+    if( after.orders_internal - before.orders_internal < 3
+        || after.cascades - before.cascades != 1
+        || after.cascade_max < 3
+        || after.internal_queue_hwm < 1 ){
+        return 4;
+    }
+    /* the market order and the 3 stops (as markets); 1 level each */
+    if( after.trades - before.trades != 4
+        || after.matches - before.matches != 4
+        || after.levels_scanned - before.levels_scanned != 4
+        || after.levels_scanned_max < 1 ){
+        return 5;
+    }
+    if( after.external_queue_depth != 0
+        || after.async_callback_backlog != 0
+        || (ncbs && after.async_callback_hwm < 1) ){
+        return 6;
+    }
+    if( orderbook->volume() != sz * 4 )
+        return 7;
+    return 0;
+}
+
+
 // TODO expand these
 int
 TEST_tick_price_1(std::ostream& out)
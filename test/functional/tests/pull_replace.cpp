@@ -638,6 +638,183 @@ TEST_replace_order_ASYNC_1(FullInterface *orderbook, std::ostream& out)
     return 0;
 }
 
+// size down keeps priority, size up / new price lose it
+int
+TEST_modify_order_1(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    vector<tuple<callback_msg, id_type, double, size_t>> msgs;
+    auto mcb = [&](callback_msg msg, id_type id1, id_type id2, double price,
+                   size_t size){
+        msgs.emplace_back(msg, id1, price, size);
+    };
+
+    id_type id1 = orderbook->insert_limit_order(true, mid, sz, mcb);
+    id_type id2 = orderbook->insert_limit_order(true, mid, sz, mcb);
+    id_type id3 = orderbook->insert_limit_order(true, conv(mid - incr), sz, mcb);
+    dump_orders(orderbook, out);
+
+    /* size down in place */
+    if( !orderbook->modify_order(id1, sz / 2) )
+        return 1;
+    dump_orders(orderbook, out);
+
+    if( msgs.size() != 1
+        || msgs[0] != make_tuple(callback_msg::modify, id1, mid, sz / 2) )
+        return 2;
+
+    if( orderbook->get_order_info(id1).size != sz / 2
+        || orderbook->bid_size() != sz + sz / 2 )
+        return 3;
+
+    /* id1 is still first */
+    orderbook->insert_market_order(false, sz / 2);
+    if( orderbook->get_order_info(id1) || !orderbook->get_order_info(id2) )
+        return 4;
+
+    /* size up goes to the back */
+    id1 = orderbook->insert_limit_order(true, mid, sz, mcb);
+    if( !orderbook->modify_order(id2, sz * 2) )
+        return 5;
+    dump_orders(orderbook, out);
+
+    orderbook->insert_market_order(false, sz);
+    if( orderbook->get_order_info(id1)
+        || orderbook->get_order_info(id2).size != sz * 2 )
+        return 6;
+
+    /* new price (doesn't trade) */
+    msgs.clear();
+    if( !orderbook->modify_order(id3, sz, conv(mid + incr)) )
+        return 7;
+    dump_orders(orderbook, out);
+
+    if( msgs.size() != 1
+        || msgs[0] != make_tuple(callback_msg::modify, id3, conv(mid + incr), sz) )
+        return 8;
+
+    if( orderbook->bid_price() != conv(mid + incr) || orderbook->bid_size() != sz
+        || orderbook->get_order_info(id3).limit != conv(mid + incr) )
+        return 9;
+
+    /* back down behind id2; old level is emptied */
+    if( !orderbook->modify_order(id3, sz / 4, mid) )
+        return 10;
+    dump_orders(orderbook, out);
+
+    if( orderbook->bid_price() != mid || orderbook->bid_size() != sz * 2 + sz / 4
+        || orderbook->bid_depth().size() != 1 )
+        return 11;
+
+    orderbook->insert_market_order(false, sz * 2);
+    if( orderbook->get_order_info(id2)
+        || orderbook->get_order_info(id3).size != sz / 4 )
+        return 12;
+
+    if( orderbook->volume() != sz * 3 + sz / 2 )
+        return 13;
+
+    /* stops/unknown ids don't modify */
+    id_type id4 = orderbook->insert_stop_order(true, end, sz);
+    if( orderbook->modify_order(id4, sz / 2)
+        || orderbook->modify_order(id2, sz / 2) )
+        return 14;
+
+    return 0;
+}
+
+
+// new price that trades, advanced orders, async
+int
+TEST_modify_order_2(FullInterface *orderbook, std::ostream& out)
+{
+    auto conv = [&](double d){ return orderbook->price_to_tick(d); };
+
+    double beg = orderbook->min_price();
+    double end = orderbook->max_price();
+    double mid = conv((beg + end) / 2);
+    double incr = orderbook->tick_size();
+
+    vector<callback_msg> msgs;
+    auto mcb = [&](callback_msg msg, id_type id1, id_type id2, double price,
+                   size_t size){
+        msgs.push_back(msg);
+    };
+
+    orderbook->insert_limit_order(false, conv(mid + incr), sz);
+    id_type id1 = orderbook->insert_limit_order(true, mid, sz * 2, mcb);
+    dump_orders(orderbook, out);
+
+    /* trades through the limit path, rest at the new price w/ same id */
+    if( !orderbook->modify_order(id1, sz * 2, conv(mid + incr)) )
+        return 1;
+    dump_orders(orderbook, out);
+
+    if( msgs.size() != 2 || msgs[0] != callback_msg::modify
+        || msgs[1] != callback_msg::fill )
+        return 2;
+
+    if( orderbook->volume() != sz || orderbook->ask_size() != 0
+        || orderbook->bid_price() != conv(mid + incr) )
+        return 3;
+
+    auto oi = orderbook->get_order_info(id1);
+    if( oi.size != sz || oi.limit != conv(mid + incr) )
+        return 4;
+
+    /* icebergs: total size, changes come out of reserve */
+    id_type id2 = orderbook->insert_limit_order(false, conv(mid + incr*3), sz * 4,
+                                  ecb, AdvancedOrderTicketICEBERG::build(sz));
+    if( !orderbook->modify_order(id2, sz * 2) )
+        return 5;
+    if( orderbook->get_order_info(id2).size != sz * 2 || orderbook->ask_size() != sz )
+        return 6;
+    if( !orderbook->modify_order(id2, sz / 2, conv(mid + incr*2)) )
+        return 7;
+    dump_orders(orderbook, out);
+    if( orderbook->get_order_info(id2).size != sz / 2
+        || orderbook->ask_size() != sz / 2
+        || orderbook->ask_price() != conv(mid + incr*2) )
+        return 8;
+
+    /* advanced orders can't trade on a modify */
+    try{
+        orderbook->modify_order(id2, sz, conv(mid + incr));
+        return 9;
+    }catch(advanced_order_error&){
+    }
+
+    /* new price of a peg is its cap */
+    id_type id3 = orderbook->insert_limit_order(true, conv(mid + incr), sz, ecb,
+                                       AdvancedOrderTicketPEG::build_primary(1));
+    if( orderbook->get_order_info(id3).limit != mid )
+        return 10;
+    if( !orderbook->modify_order(id3, sz, conv(mid - incr)) )
+        return 11;
+    dump_orders(orderbook, out);
+    if( orderbook->get_order_info(id3).limit != conv(mid - incr) )
+        return 12;
+
+    /* async */
+    auto f = orderbook->modify_order_async(id1, sz / 2);
+    if( f.get() != 1 || orderbook->get_order_info(id1).size != sz / 2 )
+        return 13;
+
+    try{
+        orderbook->modify_order(id1, 0);
+        return 14;
+    }catch(std::invalid_argument&){
+    }
+
+    return 0;
+}
+
 #endif /* RUN_FUNCTIONAL_TESTS */
 
 
@@ -0,0 +1,286 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include <chrono>
+#include <queue>
+#include <ratio>
+#include <string>
+#include <vector>
+
+#include "micro.hpp"
+#include "../../include/order_util.hpp"
+#include "../../src/orderbook/specials.tpp"
+
+namespace {
+
+/* results of the read-only primitives go here so they aren't optimized out */
+volatile size_t sink = 0;
+
+}; /* namespace */
+
+namespace sob{
+
+namespace detail{
+
+/*
+ * test friend of SimpleOrderbookBase: builds a book (inline, through the
+ * public interface) then calls ONE internal primitive 'nops' times under
+ * the master lock, exactly as the core would.
+ *
+ * The primitives that consume the book (_trade, _hit_chain, triggering
+ * stops) are given 'nops' identical levels up front and take one per op;
+ * the rest just leave the book as is and get called on the same state.
+ */
+struct core_probe
+        : public sob_types {
+
+    typedef std::ratio<1,100> tick_ratio;
+    static constexpr double TICK = 1. / 100;
+    static constexpr size_t MAX_STATE_TICKS = 2048; // (gaps, depth)
+    static constexpr size_t ORDER_SIZE = 100;
+
+    /* an inline book w/ room for 'nops' levels either side of the mid */
+    class book{
+        SimpleOrderbook::FactoryProxy<> _proxy;
+    public:
+        FullInterface *ob;
+        sob_class *sob;
+        long mid; // ticks
+
+        explicit book(size_t nops)
+            :
+                _proxy( SimpleOrderbook::BuildFactoryProxy<tick_ratio>() ),
+                ob( _proxy.create_inline(0, (2 * (nops + MAX_STATE_TICKS)) * TICK) ),
+                sob( static_cast<sob_class*>(ob) ),
+                mid( static_cast<long>(nops + MAX_STATE_TICKS) )
+            {
+            }
+
+        ~book()
+        {
+            /* triggered stops we never executed */
+            std::queue<order_queue_elem>().swap(sob->_internal_order_queue);
+            _proxy.destroy(ob);
+        }
+
+        book(const book&) = delete;
+        book& operator=(const book&) = delete;
+
+        double
+        price(long ticks_from_mid) const
+        { return ob->price_to_tick((mid + ticks_from_mid) * TICK); }
+
+        plevel
+        level(long ticks_from_mid) const
+        { return sob->_ptoi( price(ticks_from_mid) ); }
+    };
+
+    template<typename F>
+    static micro_result
+    measure( std::string name,
+             std::string state,
+             book& b,
+             cache_miss_counter& counter,
+             size_t nops,
+             F op )
+    {
+        using namespace std::chrono;
+
+        micro_result r;
+        r.name = name;
+        r.state = state;
+        r.nops = nops;
+
+        std::lock_guard<std::mutex> lock(b.sob->_master_mtx);
+        /* --- CRITICAL SECTION --- */
+        counter.start();
+        auto start = steady_clock::now();
+        for( size_t i = 0; i < nops; ++i )
+            op(i);
+        auto end = steady_clock::now();
+        unsigned long long misses = counter.stop();
+        /* --- CRITICAL SECTION --- */
+
+        r.ns_per_op = duration_cast<nanoseconds>(end - start).count()
+                      / static_cast<double>(nops);
+        r.misses_per_op = counter.available()
+                        ? misses / static_cast<double>(nops)
+                        : -1;
+        return r;
+    }
+
+    /* 'depth' sells at each of the 'n' levels above the mid */
+    static void
+    fill_asks(book& b, size_t n, size_t depth)
+    {
+        for( size_t i = 0; i < n; ++i ){
+            for( size_t d = 0; d < depth; ++d )
+                b.ob->insert_limit_order(false, b.price(1 + i), ORDER_SIZE);
+        }
+    }
+
+    /* buy 'depth' orders' worth; takes exactly the best level */
+    static micro_result
+    trade(cache_miss_counter& counter, size_t nops, size_t depth)
+    {
+        book b(nops);
+        fill_asks(b, nops, depth);
+        plevel top = b.sob->_end - 1;
+        order_exec_cb_bndl cb = order_exec_cb_bndl();
+        return measure("_trade", "depth " + std::to_string(depth), b,
+                       counter, nops,
+            [&](size_t){
+                b.sob->_trade<false>(top, 0, depth * ORDER_SIZE, cb);
+            });
+    }
+
+    /* the whole chain at the next level (then free it, as _trade does) */
+    static micro_result
+    hit_chain(cache_miss_counter& counter, size_t nops, size_t depth)
+    {
+        book b(nops);
+        fill_asks(b, nops, depth);
+        order_exec_cb_bndl cb = order_exec_cb_bndl();
+        return measure("_hit_chain", "depth " + std::to_string(depth),
+                       b, counter, nops,
+            [&](size_t i){
+                plevel p = b.level(1 + i);
+                b.sob->_hit_chain(p->limits.get(), p, 0, depth * ORDER_SIZE, cb);
+                p->limits.free();
+            });
+    }
+
+    /* _bid left 'gap' empty levels above the best bid */
+    static micro_result
+    find_new_best_inside(cache_miss_counter& counter, size_t nops, long gap)
+    {
+        book b(nops);
+        b.ob->insert_limit_order(true, b.price(0), ORDER_SIZE);
+        plevel from = b.level(gap);
+        return measure("find_new_best_inside",
+                       "gap " + std::to_string(gap), b, counter, nops,
+            [&](size_t){
+                b.sob->_bid = from;
+                sink = exec::core<true>::find_new_best_inside(b.sob);
+            });
+    }
+
+    /* a buy (non-partial) that needs every one of 'nlevels' ask levels */
+    static micro_result
+    limit_is_fillable(cache_miss_counter& counter, size_t nops, size_t nlevels)
+    {
+        book b(nops);
+        fill_asks(b, nlevels, 1);
+        plevel p = b.level(nlevels);
+        return measure("_limit_is_fillable",
+                       std::to_string(nlevels) + " levels", b, counter, nops,
+            [&](size_t){
+                sink = b.sob->_limit_is_fillable<true>(
+                           p, nlevels * ORDER_SIZE, false).second;
+            });
+    }
+
+    /* 'naons' AON buys, a level apart, all at/above p */
+    static micro_result
+    aon_overlapping(cache_miss_counter& counter, size_t nops, size_t naons)
+    {
+        book b(nops);
+        for( size_t i = 0; i < naons; ++i ){
+            b.ob->insert_limit_order(true, b.price(-static_cast<long>(i)),
+                                     ORDER_SIZE, nullptr,
+                                     AdvancedOrderTicketAON::build());
+        }
+        plevel p = b.level(-static_cast<long>(naons));
+        return measure("exec::aon::overlapping",
+                       std::to_string(naons) + " aons", b, counter, nops,
+            [&](size_t){
+                sink = exec::aon<true>::overlapping(b.sob, p).size();
+            });
+    }
+
+    /* last trade @ mid */
+    static void
+    trade_at_mid(book& b)
+    {
+        b.ob->insert_limit_order(true, b.price(0), ORDER_SIZE);
+        b.ob->insert_market_order(false, ORDER_SIZE);
+    }
+
+    /* 'nstops' on each side, none triggered */
+    static micro_result
+    stops_idle(cache_miss_counter& counter, size_t nops, size_t nstops)
+    {
+        book b(nops);
+        trade_at_mid(b);
+        for( size_t i = 1; i <= nstops; ++i ){
+            b.ob->insert_stop_order(true, b.price(i), ORDER_SIZE);
+            b.ob->insert_stop_order(false, b.price(-static_cast<long>(i)),
+                                    ORDER_SIZE);
+        }
+        return measure("_look_for_triggered_stops",
+                       std::to_string(nstops) + "/side, idle", b, counter,
+                       nops,
+            [&](size_t){
+                b.sob->_look_for_triggered_stops();
+            });
+    }
+
+    /* last moves up a level each op, triggering the buy stop there */
+    static micro_result
+    stops_triggered(cache_miss_counter& counter, size_t nops)
+    {
+        book b(nops);
+        trade_at_mid(b);
+        for( size_t i = 1; i <= nops; ++i )
+            b.ob->insert_stop_order(true, b.price(i), ORDER_SIZE);
+        return measure("_look_for_triggered_stops", "1 triggered/op", b,
+                       counter, nops,
+            [&](size_t i){
+                b.sob->_last = b.level(1 + i);
+                b.sob->_look_for_triggered_stops();
+            });
+    }
+
+    static std::vector<micro_result>
+    run(cache_miss_counter& counter, size_t nops)
+    {
+        std::vector<micro_result> results;
+        for( size_t depth : {1, 8} )
+            results.push_back( trade(counter, nops, depth) );
+        for( size_t depth : {1, 8} )
+            results.push_back( hit_chain(counter, nops, depth) );
+        for( long gap : {1, 64, 1024} )
+            results.push_back( find_new_best_inside(counter, nops, gap) );
+        for( size_t n : {1, 16, 256} )
+            results.push_back( limit_is_fillable(counter, nops, n) );
+        for( size_t n : {1, 16, 256} )
+            results.push_back( aon_overlapping(counter, nops, n) );
+        results.push_back( stops_idle(counter, nops, 256) );
+        results.push_back( stops_triggered(counter, nops) );
+        return results;
+    }
+};
+
+}; /* detail */
+
+}; /* sob */
+
+
+std::vector<micro_result>
+run_core_benches(cache_miss_counter& counter, size_t nops)
+{ return sob::detail::core_probe::run(counter, nops); }
@@ -0,0 +1,148 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cstdlib>
+
+#include "micro.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace{
+
+const size_t DEF_NOPS = 50000;
+
+void
+display_results(const vector<micro_result>& results, ostream& out)
+{
+    const size_t CW = 12;
+
+    out<< endl << setw(28) << left << "(primitive)" << setw(16) << "(state)"
+       << right << "| " << setw(CW) << "ns/op" << setw(CW) << "misses/op"
+       << endl << string(44, '-') << "|" << string(2 * CW + 1, '-') << endl
+       << fixed;
+    for( auto& r : results ){
+        out<< setw(28) << left << r.name << setw(16) << r.state << right
+           << "| " << setprecision(1) << setw(CW) << r.ns_per_op;
+        if( r.misses_per_op < 0 )
+            out<< setw(CW) << "n/a";
+        else
+            out<< setprecision(3) << setw(CW) << r.misses_per_op;
+        out<< endl;
+    }
+    out<< endl;
+}
+
+}; /* namespace */
+
+
+cache_miss_counter::cache_miss_counter()
+    :
+        _fd(-1)
+    {
+#if defined(__linux__)
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd = static_cast<int>( syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0) );
+#endif
+    }
+
+
+cache_miss_counter::~cache_miss_counter()
+{
+#if defined(__linux__)
+    if( _fd >= 0 )
+        close(_fd);
+#endif
+}
+
+
+void
+cache_miss_counter::start()
+{
+#if defined(__linux__)
+    if( _fd >= 0 ){
+        ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+
+unsigned long long
+cache_miss_counter::stop()
+{
+    unsigned long long n = 0;
+#if defined(__linux__)
+    if( _fd >= 0 ){
+        ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if( read(_fd, &n, sizeof(n)) != sizeof(n) )
+            n = 0;
+    }
+#endif
+    return n;
+}
+
+
+/*
+ * MicroBench [nops] : each primitive called nops times (per state) on a
+ * book built beforehand; single-threaded, inline books
+ */
+int main(int argc, char* argv[])
+{
+    size_t nops = DEF_NOPS;
+    if( argc > 1 )
+        nops = strtoul(argv[1], nullptr, 10);
+    if( nops == 0 ){
+        cerr<< "usage: MicroBench [nops > 0]" << endl;
+        return 1;
+    }
+
+    cache_miss_counter counter;
+    cout<< "*** BEGIN SIMPLEORDERBOOK MICRO BENCHMARKS ***" << endl
+        << "  NOPS " << nops << " - cache misses "
+        << (counter.available() ? "(perf_event_open)" : "unavailable")
+        << endl;
+
+    vector<micro_result> results;
+    try{
+        results = run_core_benches(counter, nops);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+
+    display_results(results, cout);
+    cout<< "*** END SIMPLEORDERBOOK MICRO BENCHMARKS ***" << endl;
+    return 0;
+}
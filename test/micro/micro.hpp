@@ -0,0 +1,63 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#ifndef JO_MICRO_BENCH
+#define JO_MICRO_BENCH
+
+#include <string>
+#include <vector>
+
+#include "../../include/simpleorderbook.hpp"
+
+/*
+ * hardware cache misses for the calling thread (perf_event_open, on linux;
+ * elsewhere - or if the kernel/VM won't give us the counter - unavailable)
+ */
+class cache_miss_counter{
+    int _fd;
+public:
+    cache_miss_counter();
+    ~cache_miss_counter();
+    cache_miss_counter(const cache_miss_counter&) = delete;
+    cache_miss_counter& operator=(const cache_miss_counter&) = delete;
+
+    bool
+    available() const
+    { return _fd >= 0; }
+
+    void
+    start();
+
+    /* misses since start() */
+    unsigned long long
+    stop();
+};
+
+struct micro_result{
+    std::string name;
+    std::string state;
+    size_t nops;
+    double ns_per_op;
+    double misses_per_op; /* < 0 if no counter */
+};
+
+/* core.cpp - every primitive, on each of its pre-built states */
+std::vector<micro_result>
+run_core_benches(cache_miss_counter& counter, size_t nops);
+
+#endif /* JO_MICRO_BENCH */
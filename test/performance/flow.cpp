@@ -0,0 +1,132 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include "performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <random>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+using namespace sob;
+
+/* mostly passive, cancel-heavy flow near the inside */
+flow_params::flow_params()
+    :
+        seed(1),
+        tick_sd(4),
+        cancel_ratio(.90),
+        marketable_ratio(.05),
+        burst_ratio(.10),
+        burst_size(10),
+        stop_ratio(.03),
+        aon_ratio(.01),
+        advanced_ratio(.02)
+    {
+    }
+
+
+/*
+ * n events around a (synthetic) mid that takes a random walk: limits rest
+ * a half-normal # of ticks behind it, stops the same # of ticks past it
+ * (so trades through the mid set them off), market orders - sometimes in
+ * bursts - take liquidity; cancels pick a random order that (as far as the
+ * generator knows) is still live. Its own engine, so it's repeatable.
+ */
+std::vector<flow_event>
+generate_flow(const FullInterface *ob, const flow_params& params, int n)
+{
+    std::mt19937_64 engine(params.seed);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::normal_distribution<double> ticks_out(0, params.tick_sd);
+    std::lognormal_distribution<double> size_distribution(0, 1);
+
+    double incr = ob->tick_size();
+    long nticks = std::lround((ob->max_price() - ob->min_price()) / incr);
+    long margin = std::min(nticks / 4, 100L);
+    long mid = nticks / 2; // ticks above min
+
+    auto price = [&](long t){
+        t = std::min(std::max(t, margin), nticks - margin);
+        return ob->price_to_tick(ob->min_price() + t * incr);
+    };
+    auto size = [&](){
+        size_t s = static_cast<size_t>(size_distribution(engine) * 100);
+        return std::min(std::max(s, size_t(1)), size_t(1000));
+    };
+
+    std::vector<flow_event> flow;
+    flow.reserve(n);
+    std::vector<size_t> live;
+    double p_cancel = params.cancel_ratio / (1 + params.cancel_ratio);
+    size_t burst_left = 0;
+    bool burst_buy = false;
+
+    for( int i = 0; i < n; ++i ){
+        double r = u(engine);
+        if( r < .05 ) // drift
+            mid += (r < .025) ? -1 : 1;
+
+        flow_event e = flow_event();
+        if( !burst_left && !live.empty() && u(engine) < p_cancel ){
+            size_t j = static_cast<size_t>(u(engine) * live.size());
+            j = std::min(j, live.size() - 1);
+            e.etype = flow_event::type::cancel;
+            e.ref = live[j];
+            live[j] = live.back();
+            live.pop_back();
+            flow.push_back(e);
+            continue;
+        }
+
+        e.etype = flow_event::type::add;
+        e.is_buy = u(engine) < .5;
+        e.size = size();
+        long out = static_cast<long>(std::fabs(ticks_out(engine)));
+
+        r = u(engine);
+        if( burst_left || r < params.marketable_ratio ){
+            e.otype = order_type::market;
+            e.size = std::max(e.size / 4, size_t(1));
+            if( burst_left ){
+                e.is_buy = burst_buy;
+                --burst_left;
+            }else if( u(engine) < params.burst_ratio ){
+                burst_buy = e.is_buy;
+                burst_left = params.burst_size > 1 ? params.burst_size - 1 : 0;
+            }
+        }else if( r < params.marketable_ratio + params.stop_ratio ){
+            e.otype = order_type::stop;
+            e.price = price(e.is_buy ? mid + 1 + out : mid - 1 - out);
+            live.push_back(i);
+        }else{
+            e.otype = order_type::limit;
+            e.price = price(e.is_buy ? mid - out : mid + 1 + out);
+            r = u(engine);
+            e.aon = r < params.aon_ratio;
+            e.bracket = !e.aon && r < params.aon_ratio + params.advanced_ratio;
+            live.push_back(i);
+        }
+        flow.push_back(e);
+    }
+    return flow;
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
@@ -24,9 +24,14 @@ along with this program. If not, see http://www.gnu.org/licenses.
 #include <vector>
 #include <tuple>
 #include <exception>
+#include <system_error>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
 #include <future>
+#include <thread>
 
 namespace {
 
@@ -36,11 +41,47 @@ using namespace sob;
 typedef function<double(FullInterface*,int)> test_ty;
 typedef map<int, map< int, double>> exec_results_ty;
 typedef map<string, map<int, exec_results_ty> > total_results_ty;
+typedef map<int, map<int, double>> shard_results_ty; // [nshards][norders]
+typedef map<string, map<int, pair<double,double>>> inline_results_ty; // [test][norders]
+typedef map<int, pair<double,double>> journal_results_ty; // [norders]
+typedef map<int, pair<double,double>> snapshot_results_ty; // [norders]
+typedef map<int, pair<double,double>> vwap_results_ty; // [ntrades]
+typedef map<int, pair<double,double>> deltas_results_ty; // [norders]
+
+/* distribution of per-order latencies (ns) */
+struct latency_dist{
+    size_t count;
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+/* [nproducers][norders] -> (insert-to-ack, insert-to-fill-callback) */
+typedef map<int, map<int, pair<latency_dist, latency_dist>>> latency_results_ty;
+
+/* sustained events/sec, per-event latency, and (the last run's) counters */
+struct flow_summary{
+    double events_per_sec;
+    latency_dist latency;
+    engine_stats stats;
+};
+typedef map<int, flow_summary> flow_results_ty; // [norders]
+
+/* aggregate orders/sec and what each book cost */
+struct book_scaling_summary{
+    double orders_per_sec;
+    size_t tick_memory;
+    size_t rss;
+    size_t threads;
+};
+typedef map<int, book_scaling_summary> book_scaling_results_ty; // [nbooks]
 
 
 const vector<int> DEF_NORDERS = {1000, 10000, 100000, 1000000};
+const vector<int> DEF_NBOOKS = {1, 10, 100, 1000, 10000};
 const int DEF_NRUNS = 9;
 const int DEF_NTHREADS = 3;
+const unsigned long DEF_FLOW_SEED = 1; // (for regression tracking)
 
 const vector<proxy_info_ty>
 proxies = {
@@ -50,12 +91,25 @@ proxies = {
                            make_tuple(.0, 10000.0)} )
 };
 
+/* compared threaded vs. inline */
+const vector< pair<string, const test_ty> >
+inline_tests = {
+        {"n_limits", TEST_n_limits},
+        {"n_basics", TEST_n_basics}
+};
+
 const vector< pair<string, const test_ty> >
 tests = {
         {"n_limits", TEST_n_limits},
         {"n_basics", TEST_n_basics},
+        {"n_brackets", TEST_n_brackets},
+        {"n_OCOs", TEST_n_OCOs},
         {"n_pulls", TEST_n_pulls},
-        {"n_replaces", TEST_n_replaces}
+        {"n_replaces", TEST_n_replaces},
+        {"n_modifies", TEST_n_modifies},
+        {"n_pegged", TEST_n_pegged},
+        {"n_client_repegs", TEST_n_client_repegs},
+        {"n_grows", TEST_n_grows}
 };
 
 
@@ -81,6 +135,87 @@ display_performance_results( const total_results_ty& results,
                              std::ostream& out,
                              const vector<int>& norders);
 
+shard_results_ty
+exec_shard_scaling(int nbooks, int nruns, const vector<int>& norders);
+
+void
+display_shard_results( const shard_results_ty& results,
+                       std::ostream& out,
+                       int nbooks,
+                       const vector<int>& norders);
+
+inline_results_ty
+exec_inline_speedup(int nruns, const vector<int>& norders);
+
+void
+display_inline_results( const inline_results_ty& results,
+                        std::ostream& out,
+                        const vector<int>& norders);
+
+journal_results_ty
+exec_journal_replay(int nruns, const vector<int>& norders);
+
+void
+display_journal_results( const journal_results_ty& results,
+                         std::ostream& out,
+                         const vector<int>& norders);
+
+snapshot_results_ty
+exec_snapshot_restore(int nruns, const vector<int>& norders);
+
+void
+display_snapshot_results( const snapshot_results_ty& results,
+                          std::ostream& out,
+                          const vector<int>& norders);
+
+vwap_results_ty
+exec_timesales_vwap(int nruns, const vector<int>& norders);
+
+void
+display_vwap_results( const vwap_results_ty& results,
+                      std::ostream& out,
+                      const vector<int>& norders);
+
+deltas_results_ty
+exec_book_deltas_mirror(int nruns, const vector<int>& norders);
+
+void
+display_deltas_results( const deltas_results_ty& results,
+                        std::ostream& out,
+                        const vector<int>& norders);
+
+latency_results_ty
+exec_order_latency(int nruns, int nproducers, const vector<int>& norders);
+
+void
+display_latency_results( const latency_results_ty& results,
+                         std::ostream& out );
+
+void
+write_latency_results_csv( const latency_results_ty& results,
+                           std::ostream& out );
+
+void
+write_latency_results_json( const latency_results_ty& results,
+                            std::ostream& out );
+
+flow_results_ty
+exec_flow_replay(int nruns, const vector<int>& norders);
+
+void
+display_flow_results( const flow_results_ty& results,
+                      std::ostream& out,
+                      const vector<int>& norders);
+
+book_scaling_results_ty
+exec_book_scaling(int nruns, int nproducers, int norders);
+
+void
+display_book_scaling_results( const book_scaling_results_ty& results,
+                              std::ostream& out,
+                              int nproducers,
+                              int norders );
+
 }; /* namespace */
 
 
@@ -135,10 +270,123 @@ run_performance_tests(int argc, char* argv[])
         cout<< "END TEST - " << test.first << endl << endl;
     }
 
+    /* one book per core, spread over 1 - N shards (vs. a thread per book) */
+    int nbooks = max(static_cast<int>(thread::hardware_concurrency()), 2);
+    shard_results_ty shard_results;
+    cout<< endl << "BEGIN TEST - sharded_books" << endl << endl;
+    try{
+        shard_results = exec_shard_scaling(nbooks, nruns_in_use,
+                                           norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - sharded_books" << endl << endl;
+
+    /* the same book/orders executed by its dispatcher thread vs. inline */
+    inline_results_ty inline_results;
+    cout<< endl << "BEGIN TEST - inline" << endl << endl;
+    try{
+        inline_results = exec_inline_speedup(nruns_in_use, norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - inline" << endl << endl;
+
+    /* recovery: replaying a journal vs. (the journaled) submitting */
+    journal_results_ty journal_results;
+    cout<< endl << "BEGIN TEST - journal_replay" << endl << endl;
+    try{
+        journal_results = exec_journal_replay(nruns_in_use, norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - journal_replay" << endl << endl;
+
+    /* recovery: snapshot/restore of resting orders */
+    snapshot_results_ty snapshot_results;
+    cout<< endl << "BEGIN TEST - snapshot_restore" << endl << endl;
+    try{
+        snapshot_results = exec_snapshot_restore(nruns_in_use, norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - snapshot_restore" << endl << endl;
+
+    /* analytics: vwap in place vs. copying time & sales out */
+    vwap_results_ty vwap_results;
+    cout<< endl << "BEGIN TEST - timesales_vwap" << endl << endl;
+    try{
+        vwap_results = exec_timesales_vwap(nruns_in_use, norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - timesales_vwap" << endl << endl;
+
+    /* market data: book deltas vs. polling market_depth() */
+    deltas_results_ty deltas_results;
+    cout<< endl << "BEGIN TEST - book_deltas" << endl << endl;
+    try{
+        deltas_results = exec_book_deltas_mirror(nruns_in_use, norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - book_deltas" << endl << endl;
+
+    /* tail latency: per-order insert-to-ack/fill, 1 - NTHREADS producers */
+    latency_results_ty latency_results;
+    cout<< endl << "BEGIN TEST - order_latency" << endl << endl;
+    try{
+        latency_results = exec_order_latency(nruns_in_use, nthreads_in_use,
+                                             norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - order_latency" << endl << endl;
+
+    /* (synthetic) realistic flow: cancel-heavy, near the inside, bursts */
+    flow_results_ty flow_results;
+    cout<< endl << "BEGIN TEST - flow_replay" << endl << endl;
+    try{
+        flow_results = exec_flow_replay(nruns_in_use, norders_in_use);
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - flow_replay" << endl << endl;
+
+    /* 1 - 10,000 books (a thread or two each) fed by NTHREADS producers */
+    book_scaling_results_ty book_scaling_results;
+    cout<< endl << "BEGIN TEST - book_scaling" << endl << endl;
+    try{
+        book_scaling_results = exec_book_scaling(nruns_in_use, nthreads_in_use,
+                                                 norders_in_use.back());
+    }catch(std::exception& e){
+        cerr<< e.what() << endl;
+        return 1;
+    }
+    cout<< "END TEST - book_scaling" << endl << endl;
+
     streamsize old_precision = cout.precision();
     cout.precision(6);
     cout<< fixed << endl << endl;
     display_performance_results(results, std::cout, norders_in_use);
+    display_shard_results(shard_results, std::cout, nbooks, norders_in_use);
+    display_inline_results(inline_results, std::cout, norders_in_use);
+    display_journal_results(journal_results, std::cout, norders_in_use);
+    display_snapshot_results(snapshot_results, std::cout, norders_in_use);
+    display_vwap_results(vwap_results, std::cout, norders_in_use);
+    display_deltas_results(deltas_results, std::cout, norders_in_use);
+    display_latency_results(latency_results, std::cout);
+    display_flow_results(flow_results, std::cout, norders_in_use);
+    display_book_scaling_results(book_scaling_results, std::cout,
+                                 nthreads_in_use, norders_in_use.back());
     {
         using namespace std::chrono;
         auto now_t = system_clock::to_time_t( system_clock::now() );
@@ -156,6 +404,22 @@ run_performance_tests(int argc, char* argv[])
         std::ofstream f("perf-test-" + buf);
         f << fixed;
         display_performance_results(results, f, norders_in_use);
+        display_shard_results(shard_results, f, nbooks, norders_in_use);
+        display_inline_results(inline_results, f, norders_in_use);
+        display_journal_results(journal_results, f, norders_in_use);
+        display_snapshot_results(snapshot_results, f, norders_in_use);
+        display_vwap_results(vwap_results, f, norders_in_use);
+        display_deltas_results(deltas_results, f, norders_in_use);
+        display_latency_results(latency_results, f);
+        display_flow_results(flow_results, f, norders_in_use);
+        display_book_scaling_results(book_scaling_results, f,
+                                     nthreads_in_use, norders_in_use.back());
+
+        /* (machine-readable) */
+        std::ofstream fcsv("perf-test-" + buf + "-latency.csv");
+        write_latency_results_csv(latency_results, fcsv);
+        std::ofstream fjson("perf-test-" + buf + "-latency.json");
+        write_latency_results_json(latency_results, fjson);
     }
     cout<< endl << right;
     cout.precision(old_precision);
@@ -282,6 +546,589 @@ display_performance_results( const total_results_ty& results,
     }
 }
 
+
+shard_results_ty
+exec_shard_scaling(int nbooks, int nruns, const vector<int>& norders)
+{
+    shard_results_ty results;
+
+    vector<int> nshards = {0};
+    for( int n = 1; n < nbooks; n *= 2 )
+        nshards.push_back(n);
+    nshards.push_back(nbooks);
+
+    for( int ns : nshards ){
+        for( int n : norders ){
+            cout<< "  NBOOKS " << nbooks << " - NSHARDS " << ns
+                << " - NORDERS " << n << "::: ";
+            cout.flush();
+            double time_total = 0;
+            for( int i = 0; i < nruns; ++i ){
+                double t = TEST_sharded_books(ns, nbooks, n);
+                time_total += t;
+                cout<< t << " ";
+                cout.flush();
+            }
+            results[ns][n] = time_total / nruns;
+            cout<< endl;
+        }
+    }
+    return results;
+}
+
+
+void
+display_shard_results( const shard_results_ty& results,
+                       std::ostream& out,
+                       int nbooks,
+                       const vector<int>& norders)
+{
+    const size_t CW = 10;
+
+    out<< "sharded_books - " << nbooks << " books (nshards 0 = thread per book)"
+       << endl << endl << setw(CW) << "(nshards)" << "| ";
+    for(int n: norders){
+        out<< setw(CW) << n;
+    }
+    out<< endl << string(CW, '-') << "|" << string(norders.size() * CW + 1, '-')
+       << endl;
+    for( auto& ns : results ){
+        out<< setw(CW) << ns.first << "| ";
+        for( auto& norder : ns.second ){
+            out<< setw(CW) << norder.second;
+        }
+        out<< endl;
+    }
+    out<< endl;
+}
+
+
+inline_results_ty
+exec_inline_speedup(int nruns, const vector<int>& norders)
+{
+    inline_results_ty results;
+
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+    for( auto& test : inline_tests ){
+        for( int n : norders ){
+            cout<< "  " << test.first << " - NORDERS " << n << "::: ";
+            cout.flush();
+            double t_thread = 0;
+            double t_inline = 0;
+            for( int i = 0; i < nruns; ++i ){
+                FullInterface *ob = proxy.create(0, 100);
+                double t = test.second(ob, n);
+                proxy.destroy(ob);
+                t_thread += t;
+
+                ob = proxy.create_inline(0, 100);
+                double tt = test.second(ob, n);
+                proxy.destroy(ob);
+                t_inline += tt;
+
+                cout<< t << "/" << tt << " ";
+                cout.flush();
+            }
+            results[test.first][n] = make_pair(t_thread / nruns,
+                                               t_inline / nruns);
+            cout<< endl;
+        }
+    }
+    return results;
+}
+
+
+void
+display_inline_results( const inline_results_ty& results,
+                        std::ostream& out,
+                        const vector<int>& norders)
+{
+    const size_t CW = 10;
+
+    for( auto& test : results ){
+        out<< test.first << " - inline (vs. dispatcher thread)" << endl << endl
+           << setw(CW) << "(norders)" << "| ";
+        for(int n: norders){
+            out<< setw(CW) << n;
+        }
+        out<< endl << string(CW, '-') << "|"
+           << string(norders.size() * CW + 1, '-') << endl;
+
+        out<< setw(CW) << "thread" << "| ";
+        for( auto& n : test.second )
+            out<< setw(CW) << n.second.first;
+        out<< endl << setw(CW) << "inline" << "| ";
+        for( auto& n : test.second )
+            out<< setw(CW) << n.second.second;
+        out<< endl << setw(CW) << "speedup" << "| ";
+        for( auto& n : test.second )
+            out<< setw(CW) << (n.second.first / n.second.second);
+        out<< endl << endl;
+    }
+}
+
+
+journal_results_ty
+exec_journal_replay(int nruns, const vector<int>& norders)
+{
+    journal_results_ty results;
+
+    for( int n : norders ){
+        cout<< "  NORDERS " << n << "::: ";
+        cout.flush();
+        double t_submit = 0;
+        double t_replay = 0;
+        for( int i = 0; i < nruns; ++i ){
+            auto t = TEST_journal_replay(n);
+            t_submit += t.first;
+            t_replay += t.second;
+            cout<< t.first << "/" << t.second << " ";
+            cout.flush();
+        }
+        results[n] = make_pair(t_submit / nruns, t_replay / nruns);
+        cout<< endl;
+    }
+    return results;
+}
+
+
+void
+display_journal_results( const journal_results_ty& results,
+                         std::ostream& out,
+                         const vector<int>& norders)
+{
+    const size_t CW = 10;
+
+    out<< "journal_replay - n_basics, 1/100 (vs. submitting, journaled)"
+       << endl << endl << setw(CW) << "(norders)" << "| ";
+    for(int n: norders){
+        out<< setw(CW) << n;
+    }
+    out<< endl << string(CW, '-') << "|"
+       << string(norders.size() * CW + 1, '-') << endl;
+
+    out<< setw(CW) << "submit" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.first;
+    out<< endl << setw(CW) << "replay" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.second;
+    out<< endl << setw(CW) << "speedup" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << (n.second.first / n.second.second);
+    out<< endl << endl;
+}
+
+
+snapshot_results_ty
+exec_snapshot_restore(int nruns, const vector<int>& norders)
+{
+    snapshot_results_ty results;
+
+    for( int n : norders ){
+        cout<< "  NORDERS " << n << "::: ";
+        cout.flush();
+        double t_snap = 0;
+        double t_restore = 0;
+        for( int i = 0; i < nruns; ++i ){
+            auto t = TEST_snapshot_restore(n);
+            t_snap += t.first;
+            t_restore += t.second;
+            cout<< t.first << "/" << t.second << " ";
+            cout.flush();
+        }
+        results[n] = make_pair(t_snap / nruns, t_restore / nruns);
+        cout<< endl;
+    }
+    return results;
+}
+
+
+void
+display_snapshot_results( const snapshot_results_ty& results,
+                          std::ostream& out,
+                          const vector<int>& norders)
+{
+    const size_t CW = 10;
+
+    out<< "snapshot_restore - resting limits, 1/100"
+       << endl << endl << setw(CW) << "(norders)" << "| ";
+    for(int n: norders){
+        out<< setw(CW) << n;
+    }
+    out<< endl << string(CW, '-') << "|"
+       << string(norders.size() * CW + 1, '-') << endl;
+
+    out<< setw(CW) << "snapshot" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.first;
+    out<< endl << setw(CW) << "restore" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.second;
+    out<< endl << endl;
+}
+
+
+vwap_results_ty
+exec_timesales_vwap(int nruns, const vector<int>& norders)
+{
+    vwap_results_ty results;
+
+    for( int n : norders ){
+        cout<< "  NTRADES " << n << "::: ";
+        cout.flush();
+        double t_copy = 0;
+        double t_vwap = 0;
+        for( int i = 0; i < nruns; ++i ){
+            auto t = TEST_timesales_vwap(n);
+            t_copy += t.first;
+            t_vwap += t.second;
+            cout<< t.first << "/" << t.second << " ";
+            cout.flush();
+        }
+        results[n] = make_pair(t_copy / nruns, t_vwap / nruns);
+        cout<< endl;
+    }
+    return results;
+}
+
+
+void
+display_vwap_results( const vwap_results_ty& results,
+                      std::ostream& out,
+                      const vector<int>& norders)
+{
+    const size_t CW = 10;
+
+    out<< "timesales_vwap - 1/100 (vs. copying time & sales out)"
+       << endl << endl << setw(CW) << "(ntrades)" << "| ";
+    for(int n: norders){
+        out<< setw(CW) << n;
+    }
+    out<< endl << string(CW, '-') << "|"
+       << string(norders.size() * CW + 1, '-') << endl;
+
+    out<< setw(CW) << "copy" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.first;
+    out<< endl << setw(CW) << "vwap" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.second;
+    out<< endl << setw(CW) << "speedup" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << (n.second.first / n.second.second);
+    out<< endl << endl;
+}
+
+
+deltas_results_ty
+exec_book_deltas_mirror(int nruns, const vector<int>& norders)
+{
+    deltas_results_ty results;
+
+    for( int n : norders ){
+        cout<< "  NORDERS " << n << "::: ";
+        cout.flush();
+        double t_poll = 0;
+        double t_deltas = 0;
+        for( int i = 0; i < nruns; ++i ){
+            auto t = TEST_book_deltas_mirror(n);
+            t_poll += t.first;
+            t_deltas += t.second;
+            cout<< t.first << "/" << t.second << " ";
+            cout.flush();
+        }
+        results[n] = make_pair(t_poll / nruns, t_deltas / nruns);
+        cout<< endl;
+    }
+    return results;
+}
+
+
+void
+display_deltas_results( const deltas_results_ty& results,
+                        std::ostream& out,
+                        const vector<int>& norders)
+{
+    const size_t CW = 10;
+
+    out<< "book_deltas - 1/100 (L2 mirror vs. polling market_depth)"
+       << endl << endl << setw(CW) << "(norders)" << "| ";
+    for(int n: norders){
+        out<< setw(CW) << n;
+    }
+    out<< endl << string(CW, '-') << "|"
+       << string(norders.size() * CW + 1, '-') << endl;
+
+    out<< setw(CW) << "poll" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.first;
+    out<< endl << setw(CW) << "deltas" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << n.second.second;
+    out<< endl << setw(CW) << "speedup" << "| ";
+    for( auto& n : results )
+        out<< setw(CW) << (n.second.first / n.second.second);
+    out<< endl << endl;
+}
+
+
+latency_dist
+build_latency_dist(vector<double>& v)
+{
+    latency_dist d = latency_dist();
+    d.count = v.size();
+    if( v.empty() )
+        return d;
+
+    sort(v.begin(), v.end());
+    auto at = [&](double q){
+        size_t i = static_cast<size_t>(ceil(q * v.size()));
+        return v[ i ? i - 1 : 0 ];
+    };
+    d.p50 = at(.50);
+    d.p99 = at(.99);
+    d.p999 = at(.999);
+    d.max = v.back();
+    return d;
+}
+
+
+/* 1, 2, 4 ... 'nproducers' producers; every run's orders pooled */
+latency_results_ty
+exec_order_latency(int nruns, int nproducers, const vector<int>& norders)
+{
+    vector<int> sweep;
+    for( int p = 1; p < nproducers; p *= 2 )
+        sweep.push_back(p);
+    sweep.push_back( max(nproducers, 1) );
+
+    latency_results_ty results;
+    for( int p : sweep ){
+        for( int n : norders ){
+            cout<< "  NPRODUCERS " << p << " NORDERS " << n << "::: ";
+            cout.flush();
+            vector<double> acks, fills;
+            for( int i = 0; i < nruns; ++i ){
+                auto r = TEST_order_latency(p, n);
+                acks.insert(acks.end(), r.first.begin(), r.first.end());
+                fills.insert(fills.end(), r.second.begin(), r.second.end());
+                cout<< ". ";
+                cout.flush();
+            }
+            results[p][n] = make_pair( build_latency_dist(acks),
+                                       build_latency_dist(fills) );
+            cout<< endl;
+        }
+    }
+    return results;
+}
+
+
+void
+display_latency_results( const latency_results_ty& results,
+                         std::ostream& out )
+{
+    const size_t CW = 12;
+
+    out<< "order_latency - 1/100 (ns per order, all runs)" << endl << endl
+       << setw(CW) << "(producers)" << setw(CW) << "(norders)"
+       << setw(CW) << "(latency)" << "| " << setw(CW) << "count"
+       << setw(CW) << "p50" << setw(CW) << "p99" << setw(CW) << "p99.9"
+       << setw(CW) << "max" << endl
+       << string(CW * 3, '-') << "|" << string(CW * 5 + 1, '-') << endl;
+
+    auto row = [&](int p, int n, string what, const latency_dist& d){
+        out<< setw(CW) << p << setw(CW) << n << setw(CW) << what << "| "
+           << setw(CW) << d.count << setprecision(0)
+           << setw(CW) << d.p50 << setw(CW) << d.p99
+           << setw(CW) << d.p999 << setw(CW) << d.max
+           << setprecision(6) << endl;
+    };
+    for( auto& p : results ){
+        for( auto& n : p.second ){
+            row(p.first, n.first, "ack", n.second.first);
+            row(p.first, n.first, "fill", n.second.second);
+        }
+    }
+    out<< endl;
+}
+
+
+void
+write_latency_results_csv( const latency_results_ty& results,
+                           std::ostream& out )
+{
+    out<< "nproducers,norders,latency,count,p50_ns,p99_ns,p999_ns,max_ns"
+       << endl << fixed << setprecision(0);
+    auto row = [&](int p, int n, string what, const latency_dist& d){
+        out<< p << "," << n << "," << what << "," << d.count << ","
+           << d.p50 << "," << d.p99 << "," << d.p999 << "," << d.max << endl;
+    };
+    for( auto& p : results ){
+        for( auto& n : p.second ){
+            row(p.first, n.first, "ack", n.second.first);
+            row(p.first, n.first, "fill", n.second.second);
+        }
+    }
+}
+
+
+void
+write_latency_results_json( const latency_results_ty& results,
+                            std::ostream& out )
+{
+    out<< fixed << setprecision(0) << "[";
+    auto dist = [&](const latency_dist& d){
+        out<< "{\"count\": " << d.count << ", \"p50_ns\": " << d.p50
+           << ", \"p99_ns\": " << d.p99 << ", \"p999_ns\": " << d.p999
+           << ", \"max_ns\": " << d.max << "}";
+    };
+    bool first = true;
+    for( auto& p : results ){
+        for( auto& n : p.second ){
+            out<< (first ? "" : ",") << endl
+               << "  {\"nproducers\": " << p.first
+               << ", \"norders\": " << n.first << ", \"ack\": ";
+            dist(n.second.first);
+            out<< ", \"fill\": ";
+            dist(n.second.second);
+            out<< "}";
+            first = false;
+        }
+    }
+    out<< endl << "]" << endl;
+}
+
+
+/* the same (seeded) flow every run */
+flow_results_ty
+exec_flow_replay(int nruns, const vector<int>& norders)
+{
+    flow_params params;
+    params.seed = DEF_FLOW_SEED;
+
+    flow_results_ty results;
+    for( int n : norders ){
+        cout<< "  NEVENTS " << n << "::: ";
+        cout.flush();
+        double t = 0;
+        vector<double> latencies;
+        flow_replay_result r;
+        for( int i = 0; i < nruns; ++i ){
+            r = TEST_flow_replay(params, n);
+            t += r.seconds;
+            latencies.insert(latencies.end(), r.latencies.begin(),
+                             r.latencies.end());
+            cout<< r.seconds << " ";
+            cout.flush();
+        }
+        flow_summary& s = results[n];
+        s.events_per_sec = (static_cast<double>(n) * nruns) / t;
+        s.latency = build_latency_dist(latencies);
+        s.stats = r.stats;
+        cout<< endl;
+    }
+    return results;
+}
+
+
+void
+display_flow_results( const flow_results_ty& results,
+                      std::ostream& out,
+                      const vector<int>& norders)
+{
+    const size_t CW = 10;
+    flow_params params;
+
+    out<< "flow_replay - 1/100 (seed " << DEF_FLOW_SEED << ", "
+       << fixed << setprecision(2) << params.cancel_ratio
+       << " cancels/order, latency in ns)"
+       << endl << endl << setw(CW) << "(nevents)" << "| ";
+    for(int n: norders){
+        out<< setw(CW) << n;
+    }
+    out<< endl << string(CW, '-') << "|"
+       << string(norders.size() * CW + 1, '-') << endl;
+
+    auto row = [&](string name, function<double(const flow_summary&)> get,
+                   int precision){
+        out<< setw(CW) << name << "| " << setprecision(precision);
+        for( auto& n : results )
+            out<< setw(CW) << get(n.second);
+        out<< setprecision(6) << endl;
+    };
+    row("events/s", [](const flow_summary& s){ return s.events_per_sec; }, 0);
+    row("p50", [](const flow_summary& s){ return s.latency.p50; }, 0);
+    row("p99", [](const flow_summary& s){ return s.latency.p99; }, 0);
+    row("p99.9", [](const flow_summary& s){ return s.latency.p999; }, 0);
+    row("max", [](const flow_summary& s){ return s.latency.max; }, 0);
+    row("fills", [](const flow_summary& s){
+        return static_cast<double>(s.stats.matches); }, 0);
+    row("cascades", [](const flow_summary& s){
+        return static_cast<double>(s.stats.cascades); }, 0);
+    out<< endl;
+}
+
+
+/* stops (w/ what it got through) if we can't create any more books/threads */
+book_scaling_results_ty
+exec_book_scaling(int nruns, int nproducers, int norders)
+{
+    book_scaling_results_ty results;
+    for( int nbooks : DEF_NBOOKS ){
+        cout<< "  NBOOKS " << nbooks << " - NPRODUCERS " << nproducers
+            << " - NORDERS " << norders << "::: ";
+        cout.flush();
+        double t = 0;
+        book_scaling_result r;
+        try{
+            for( int i = 0; i < nruns; ++i ){
+                r = TEST_book_scaling(nbooks, nproducers, norders);
+                t += r.seconds;
+                cout<< r.seconds << " ";
+                cout.flush();
+            }
+        }catch(std::system_error& e){
+            cout<< "stopped (" << e.what() << ")" << endl;
+            break;
+        }
+        book_scaling_summary& s = results[nbooks];
+        s.orders_per_sec = (static_cast<double>(norders) * nruns) / t;
+        s.tick_memory = r.tick_memory;
+        s.rss = r.rss;
+        s.threads = r.threads;
+        cout<< endl;
+    }
+    return results;
+}
+
+
+void
+display_book_scaling_results( const book_scaling_results_ty& results,
+                              std::ostream& out,
+                              int nproducers,
+                              int norders )
+{
+    const size_t CW = 12;
+
+    out<< "book_scaling - 1/100, 0-100 (" << nproducers << " producers, "
+       << norders << " orders; bytes per book)" << endl << endl
+       << setw(CW) << "(nbooks)" << "| " << setw(CW) << "orders/s"
+       << setw(CW) << "tick mem" << setw(CW) << "RSS" << setw(CW)
+       << "threads" << setw(CW) << "thrd/book" << endl
+       << string(CW, '-') << "|" << string(5 * CW + 1, '-') << endl
+       << fixed;
+    for( auto& b : results ){
+        const book_scaling_summary& s = b.second;
+        out<< setw(CW) << b.first << "| " << setprecision(0)
+           << setw(CW) << s.orders_per_sec << setw(CW) << s.tick_memory
+           << setw(CW) << s.rss << setw(CW) << s.threads << setprecision(2)
+           << setw(CW) << static_cast<double>(s.threads) / b.first << endl;
+    }
+    out<< setprecision(6) << endl;
+}
+
 }; /* namespace */
 
 #endif /* RUN_PERFORMANCE_TESTS */
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses.
 #ifdef RUN_PERFORMANCE_TESTS
 
 #include <vector>
+#include <utility>
 
 int
 run_performance_tests(int argc, char* argv[]);
@@ -35,9 +36,86 @@ double TEST_##name(sob::FullInterface *full_orderbook, int n)
 /* tests/insert.cpp */
 DECL_PERFORMANCE_TEST_FUNC(n_limits);
 DECL_PERFORMANCE_TEST_FUNC(n_basics);
+DECL_PERFORMANCE_TEST_FUNC(n_brackets);
+DECL_PERFORMANCE_TEST_FUNC(n_OCOs);
 /* tests/pull.cpp */
 DECL_PERFORMANCE_TEST_FUNC(n_pulls);
 DECL_PERFORMANCE_TEST_FUNC(n_replaces);
+DECL_PERFORMANCE_TEST_FUNC(n_modifies);
+/* tests/pegged.cpp */
+DECL_PERFORMANCE_TEST_FUNC(n_pegged);
+DECL_PERFORMANCE_TEST_FUNC(n_client_repegs);
+/* tests/grow.cpp */
+DECL_PERFORMANCE_TEST_FUNC(n_grows);
+/* tests/shards.cpp */
+double
+TEST_sharded_books(int nshards, int nbooks, int n);
+/* tests/journal.cpp */
+std::pair<double, double>
+TEST_journal_replay(int n);
+/* tests/snapshot.cpp */
+std::pair<double, double>
+TEST_snapshot_restore(int n);
+/* tests/timesales.cpp */
+std::pair<double, double>
+TEST_timesales_vwap(int n);
+/* tests/market_data.cpp */
+std::pair<double, double>
+TEST_book_deltas_mirror(int n);
+/* tests/latency.cpp */
+std::pair<std::vector<double>, std::vector<double>>
+TEST_order_latency(int nproducers, int n);
+/* tests/books.cpp */
+struct book_scaling_result{
+    double seconds;     /* to get all n orders in */
+    size_t tick_memory; /* per book, from FactoryProxy::tick_memory_required */
+    size_t rss;         /* per book, RSS added creating them (0 if unknown) */
+    size_t threads;     /* added creating them, total (0 if unknown) */
+};
+book_scaling_result
+TEST_book_scaling(int nbooks, int nproducers, int n);
+
+/*
+ * synthetic (ITCH-like) order flow, see flow.cpp; the same params (seed)
+ * generate the same flow
+ */
+struct flow_params{
+    unsigned long seed;
+    double tick_sd;          /* limits/stops ~ |N(0, tick_sd)| ticks out */
+    double cancel_ratio;     /* cancels per new order */
+    double marketable_ratio; /* new orders that are market orders */
+    double burst_ratio;      /* market orders that start a burst */
+    size_t burst_size;       /* market orders in a burst (same side) */
+    double stop_ratio;       /* new orders that are stops */
+    double aon_ratio;        /* limits that are AON */
+    double advanced_ratio;   /* limits w/ a bracket */
+    flow_params();
+};
+
+struct flow_event{
+    enum class type : uint8_t { add, cancel };
+    type etype;
+    sob::order_type otype; /* add: limit, market or stop */
+    bool is_buy;
+    double price;          /* limit or stop */
+    size_t size;
+    bool aon;
+    bool bracket;
+    size_t ref;            /* cancel: # of the add event it cancels */
+};
+
+std::vector<flow_event>
+generate_flow(const sob::FullInterface *ob, const flow_params& params, int n);
+
+/* tests/flow.cpp */
+struct flow_replay_result{
+    double seconds;
+    std::vector<double> latencies; /* ns, per event */
+    sob::engine_stats stats;
+};
+
+flow_replay_result
+TEST_flow_replay(const flow_params& params, int n);
 
 std::vector<double>
 generate_prices(const sob::FullInterface *ob, double min, double max, int n);
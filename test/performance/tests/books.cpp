@@ -0,0 +1,126 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <vector>
+#include <future>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+namespace {
+
+/* a field (in kB for VmRSS) from /proc/self/status; 0 if we can't tell */
+size_t
+proc_status(const string& field)
+{
+#if defined(__linux__)
+    ifstream in("/proc/self/status");
+    string line;
+    while( getline(in, line) ){
+        if( line.compare(0, field.size(), field) == 0
+            && line.size() > field.size() && line[field.size()] == ':' )
+        {
+            return stoul(line.substr(field.size() + 1));
+        }
+    }
+#endif
+    return 0;
+}
+
+size_t
+resident_bytes()
+{ return proc_status("VmRSS") * 1024; }
+
+size_t
+thread_count()
+{ return proc_status("Threads"); }
+
+}; /* namespace */
+
+
+/*
+ * 'nbooks' (threaded) books from FactoryProxy::create, driven by
+ * 'nproducers' threads: order i, a limit, goes to book i % nbooks from
+ * producer i % nproducers, so few books means producers share them and
+ * many books means each producer spreads over lots of them; n in total.
+ * Also what creating the books cost: the ladder the proxy says each needs,
+ * the RSS and the threads they actually added.
+ */
+book_scaling_result
+TEST_book_scaling(int nbooks, int nproducers, int n)
+{
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+
+    book_scaling_result result = book_scaling_result();
+    result.tick_memory = proxy.tick_memory_required(0, 100);
+
+    size_t rss = resident_bytes();
+    size_t nthreads = thread_count();
+
+    vector<FullInterface*> books;
+    books.reserve(nbooks);
+    try{
+        for( int i = 0; i < nbooks; ++i )
+            books.push_back( proxy.create(0, 100) );
+    }catch(...){
+        /* (e.g out of threads) */
+        for( auto ob : books )
+            proxy.destroy(ob);
+        throw;
+    }
+
+    result.rss = (max(resident_bytes(), rss) - rss) / nbooks;
+    result.threads = max(thread_count(), nthreads) - nthreads;
+
+    /* all books have the same range */
+    vector<double> prices = generate_prices(books.front(), 0, 100, n);
+    double mid = (books.front()->max_price() + books.front()->min_price()) / 2;
+
+    auto start = chrono::steady_clock::now();
+    vector<future<void>> futs;
+    for( int p = 0; p < nproducers; ++p ){
+        futs.push_back( async(launch::async, [&, p](){
+            for( int i = p; i < n; i += nproducers ){
+                FullInterface *ob = books[i % nbooks];
+                if( !ob->insert_limit_order(prices[i] < mid, prices[i], 100) )
+                    throw runtime_error("insert limit order failed");
+            }
+        }) );
+    }
+    for( auto& f : futs )
+        f.get();
+    auto end = chrono::steady_clock::now();
+
+    for( auto ob : books )
+        proxy.destroy(ob);
+
+    chrono::duration<double> sec = end - start;
+    result.seconds = sec.count();
+    return result;
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
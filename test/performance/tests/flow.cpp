@@ -0,0 +1,103 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+/*
+ * replay n events of synthetic flow (generate_flow) against a new book,
+ * one at a time, timing each; returns the total seconds, each event's
+ * latency (ns) and the book's engine counters at the end
+ */
+flow_replay_result
+TEST_flow_replay(const flow_params& params, int n)
+{
+    using clock = chrono::steady_clock;
+
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+    FullInterface *ob = proxy.create(0, 100);
+    auto flow = generate_flow(ob, params, n);
+    double incr = ob->tick_size();
+
+    /* avoid liquidity exc (market orders, triggered stops and exits) */
+    ob->insert_limit_order( true, ob->min_price(), n * 1000 );
+    ob->insert_limit_order( false, ob->max_price(), n * 1000 );
+
+    flow_replay_result result;
+    result.latencies.resize(flow.size());
+    vector<id_type> ids(flow.size(), 0);
+
+    auto start = clock::now();
+    for( size_t i = 0; i < flow.size(); ++i ){
+        const flow_event& e = flow[i];
+        auto t = clock::now();
+        if( e.etype == flow_event::type::cancel ){
+            /* (it may have filled already) */
+            ob->pull_order( ids[e.ref] );
+        }else{
+            switch( e.otype ){
+            case order_type::market:
+                ids[i] = ob->insert_market_order( e.is_buy, e.size );
+                break;
+            case order_type::stop:
+                ids[i] = ob->insert_stop_order( e.is_buy, e.price, e.size );
+                break;
+            case order_type::limit:
+                if( e.aon ){
+                    ids[i] = ob->insert_limit_order(
+                        e.is_buy, e.price, e.size, nullptr,
+                        AdvancedOrderTicketAON::build() );
+                }else if( e.bracket ){
+                    double loss = ob->price_to_tick(
+                        e.price + (e.is_buy ? -5 : 5) * incr );
+                    double target = ob->price_to_tick(
+                        e.price + (e.is_buy ? 5 : -5) * incr );
+                    auto aot = e.is_buy
+                        ? AdvancedOrderTicketBRACKET::build_sell_stop(loss, target)
+                        : AdvancedOrderTicketBRACKET::build_buy_stop(loss, target);
+                    ids[i] = ob->insert_limit_order( e.is_buy, e.price, e.size,
+                                                     nullptr, aot );
+                }else{
+                    ids[i] = ob->insert_limit_order( e.is_buy, e.price, e.size );
+                }
+                break;
+            default:
+                throw runtime_error("invalid flow order type");
+            }
+            if( !ids[i] )
+                throw runtime_error("flow insert " + e.otype + " failed");
+        }
+        result.latencies[i] = static_cast<double>(
+            chrono::duration_cast<chrono::nanoseconds>(clock::now() - t).count() );
+    }
+    chrono::duration<double> sec = clock::now() - start;
+    result.seconds = sec.count();
+    result.stats = dynamic_cast<ManagementInterface*>(ob)->stats();
+
+    proxy.destroy(ob);
+    return result;
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
@@ -0,0 +1,57 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+/* n resting orders, then n one-tick grows (alternating above/below) */
+double
+TEST_n_grows(FullInterface *full_orderbook, int n)
+{
+    ManagementInterface *ob = dynamic_cast<ManagementInterface*>(full_orderbook);
+
+    double incr = ob->tick_size();
+    double mid = ob->price_to_tick((ob->max_price() + ob->min_price()) / 2);
+    auto prices = generate_prices(ob, ob->min_price(), ob->max_price(), n);
+    for(int i = 0; i < n; ++i){
+        if( !ob->insert_limit_order(prices[i] < mid, prices[i], 100) ){
+            throw runtime_error("insert limit order failed");
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i){
+        if( i % 2 ){
+            ob->grow_book_above( ob->max_price() + incr );
+        }else{
+            ob->grow_book_below( ob->min_price() - incr );
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    chrono::duration<double> sec = end - start;
+    return sec.count();
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
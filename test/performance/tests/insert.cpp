@@ -87,4 +87,70 @@ TEST_n_basics(FullInterface *ob, int n)
     return sec.count();
 }
 
+
+double
+TEST_n_brackets(FullInterface *ob, int n)
+{
+    double incr = ob->tick_size();
+    double lo = ob->price_to_tick(ob->min_price() + 10 * incr);
+    double hi = ob->price_to_tick(ob->max_price() - 10 * incr);
+    auto prices = generate_prices(ob, lo, hi, n);
+    auto sizes = generate_sizes(1, 1000, n);
+    auto buy_sells = generate_buy_sells(n);
+    id_type id = 0;
+
+    /* avoid liquidity exc (triggered exits become market orders) */
+    ob->insert_limit_order( true, ob->min_price(), n * 3000);
+    ob->insert_limit_order( false, ob->max_price(), n * 3000);
+
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i){
+        double p = prices[i];
+        double offset = 5 * incr;
+        auto aot = buy_sells[i]
+            ? AdvancedOrderTicketBRACKET::build_sell_stop(
+                ob->price_to_tick(p - offset), ob->price_to_tick(p + offset) )
+            : AdvancedOrderTicketBRACKET::build_buy_stop(
+                ob->price_to_tick(p + offset), ob->price_to_tick(p - offset) );
+        id = ob->insert_limit_order( buy_sells[i], p, sizes[i], nullptr, aot );
+        if( !id ){
+            throw runtime_error("insert bracket order failed");
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    chrono::duration<double> sec = end - start;
+    return sec.count();
+}
+
+
+double
+TEST_n_OCOs(FullInterface *ob, int n)
+{
+    double incr = ob->tick_size();
+    double lo = ob->price_to_tick(ob->min_price() + 10 * incr);
+    double hi = ob->price_to_tick(ob->max_price() - 10 * incr);
+    auto prices = generate_prices(ob, lo, hi, n);
+    auto sizes = generate_sizes(1, 1000, n);
+    auto buy_sells = generate_buy_sells(n);
+    id_type id = 0;
+
+    /* avoid liquidity exc (triggered stops become market orders) */
+    ob->insert_limit_order( true, ob->min_price(), n * 2000);
+    ob->insert_limit_order( false, ob->max_price(), n * 2000);
+
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i){
+        bool buy = buy_sells[i];
+        double stop = ob->price_to_tick(prices[i] + (buy ? 5 : -5) * incr);
+        auto aot = AdvancedOrderTicketOCO::build_stop(buy, stop, sizes[i]);
+        id = ob->insert_limit_order( buy, prices[i], sizes[i], nullptr, aot );
+        if( !id ){
+            throw runtime_error("insert OCO order failed");
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    chrono::duration<double> sec = end - start;
+    return sec.count();
+}
+
 #endif /* RUN_PERFORMANCE_TESTS */
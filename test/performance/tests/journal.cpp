@@ -0,0 +1,62 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+/*
+ * n basic orders submitted (w/ a journal running) vs. rebuilding the
+ * book from that journal (recovery); seconds for each
+ */
+pair<double, double>
+TEST_journal_replay(int n)
+{
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+    const string path = "perf-test.journal";
+    std::remove(path.c_str());
+
+    FullInterface *ob = proxy.create(0, 100);
+    dynamic_cast<ManagementInterface*>(ob)->start_journal(path);
+    double t_submit = TEST_n_basics(ob, n);
+    dynamic_cast<ManagementInterface*>(ob)->stop_journal();
+    id_type last_id = ob->last_id();
+    proxy.destroy(ob);
+
+    ob = proxy.create(0, 100);
+    auto start = chrono::steady_clock::now();
+    dynamic_cast<ManagementInterface*>(ob)->replay_journal(path);
+    auto end = chrono::steady_clock::now();
+    if( ob->last_id() != last_id ){
+        throw runtime_error("replay diverged");
+    }
+    proxy.destroy(ob);
+    std::remove(path.c_str());
+
+    chrono::duration<double> sec = end - start;
+    return make_pair(t_submit, sec.count());
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
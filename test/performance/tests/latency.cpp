@@ -0,0 +1,101 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace sob;
+
+/*
+ * 'nproducers' threads send n orders (between them) to one book, each
+ * waiting for the ack of one before sending the next; three limits near
+ * the inside to every market order. Returns the insert-to-ack latency of
+ * every order and the insert-to-fill-callback latency of every market
+ * order that filled, in nanoseconds
+ */
+pair<vector<double>, vector<double>>
+TEST_order_latency(int nproducers, int n)
+{
+    using clock = chrono::steady_clock;
+
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+    FullInterface *ob = proxy.create(0, 100);
+
+    /* (the generators aren't thread safe) */
+    int per = max(n / nproducers, 1);
+    size_t total = static_cast<size_t>(per) * nproducers;
+    auto prices = generate_prices(ob, 45, 55, total);
+    auto sizes = generate_sizes(1, 100, total);
+    auto buy_sells = generate_buy_sells(total);
+
+    auto ns = [](clock::duration d){
+        return static_cast<double>(
+            chrono::duration_cast<chrono::nanoseconds>(d).count() );
+    };
+
+    /* fills[] is written by the callback thread; -1 is 'not filled' */
+    vector<clock::time_point> sent(total);
+    vector<double> acks(total), fills(total, -1);
+
+    auto produce = [&](int p){
+        for( size_t i = p * per; i < static_cast<size_t>(p + 1) * per; ++i ){
+            sent[i] = clock::now();
+            if( i % 4 == 3 ){
+                auto f = ob->insert_market_order_async(
+                    buy_sells[i], sizes[i],
+                    [&, i](callback_msg msg, id_type, id_type, double, size_t){
+                        if( msg == callback_msg::fill && fills[i] < 0 )
+                            fills[i] = ns(clock::now() - sent[i]);
+                    }
+                );
+                try{
+                    f.get();
+                }catch(liquidity_exception&){
+                    /* (not, or only partly, filled; still an ack) */
+                }
+            }else{
+                ob->insert_limit_order_async(buy_sells[i], prices[i],
+                                             sizes[i]).get();
+            }
+            acks[i] = ns(clock::now() - sent[i]);
+        }
+    };
+
+    vector<thread> producers;
+    for( int p = 0; p < nproducers; ++p )
+        producers.emplace_back(produce, p);
+    for( auto& t : producers )
+        t.join();
+    ob->wait_for_async_callbacks();
+    proxy.destroy(ob);
+
+    vector<double> filled;
+    for( double f : fills ){
+        if( f >= 0 )
+            filled.push_back(f);
+    }
+    return make_pair(acks, filled);
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
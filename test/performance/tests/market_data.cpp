@@ -0,0 +1,92 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <map>
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+/*
+ * keeping an L2 mirror of the book in sync after each of n orders:
+ * polling market_depth() and diffing it vs. applying the book deltas;
+ * seconds (on the consumer side) for each
+ */
+pair<double, double>
+TEST_book_deltas_mirror(int n)
+{
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+    FullInterface *ob = proxy.create_inline(0, 100);
+    dynamic_cast<ManagementInterface*>(ob)->start_book_deltas(1 << 16);
+
+    auto prices = generate_prices(ob, 45, 55, n);
+    auto sizes = generate_sizes(1, 1000, n);
+    auto buy_sells = generate_buy_sells(n);
+
+    map<double, pair<size_t, side_of_market>> polled;
+    map<pair<double, bool>, size_t> mirror;
+    vector<book_delta> buf;
+    unsigned long long seq = 0;
+    size_t npolled = 0, ndeltas = 0;
+
+    chrono::duration<double> t_poll(0), t_deltas(0);
+    for( int i = 0; i < n; ++i ){
+        ob->insert_limit_order(buy_sells[i], prices[i], sizes[i]);
+
+        auto start = chrono::steady_clock::now();
+        auto md = ob->market_depth(1000);
+        for( auto& l : md ){ // what changed
+            auto iter = polled.find(l.first);
+            if( iter == polled.end() || iter->second != l.second )
+                ++npolled;
+        }
+        for( auto& l : polled ){
+            if( !md.count(l.first) )
+                ++npolled;
+        }
+        polled.swap(md);
+        auto mid = chrono::steady_clock::now();
+        buf.clear();
+        seq = ob->read_book_deltas(seq, buf);
+        for( const book_delta& d : buf ){
+            if( !d.is_L2() )
+                continue;
+            if( d.dtype == book_delta::type::level_delete )
+                mirror.erase( make_pair(d.price, d.is_buy) );
+            else
+                mirror[ make_pair(d.price, d.is_buy) ] = d.size;
+            ++ndeltas;
+        }
+        auto end = chrono::steady_clock::now();
+        t_poll += mid - start;
+        t_deltas += end - mid;
+    }
+    proxy.destroy(ob);
+
+    if( mirror.size() != polled.size() || !npolled || !ndeltas ){
+        throw runtime_error("book delta mirror mismatch");
+    }
+    return make_pair(t_poll.count(), t_deltas.count());
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+using namespace sob;
+
+namespace {
+
+const int MAX_PEGS = 1000;
+const int MIN_MOVES = 10;
+
+/* (up to) 1000 orders tracking the bid, n/1000 moves of the bid */
+int
+npegs(int n)
+{ return min(n, MAX_PEGS); }
+
+int
+nmoves(int n)
+{ return max(n / MAX_PEGS, MIN_MOVES); }
+
+}; /* namespace */
+
+
+double
+TEST_n_pegged(FullInterface *ob, int n)
+{
+    double incr = ob->tick_size();
+    double mid = ob->price_to_tick((ob->max_price() + ob->min_price()) / 2);
+    double lo = ob->price_to_tick(mid - incr * 10);
+    double hi = ob->price_to_tick(mid - incr * 5);
+
+    ob->insert_limit_order(false, ob->price_to_tick(mid + incr * 10), 100);
+    id_type ref = ob->insert_limit_order(true, lo, 100);
+
+    auto aot = AdvancedOrderTicketPEG::build_primary(1);
+    for(int i = 0; i < npegs(n); ++i){
+        if( !ob->insert_limit_order(true, mid, 100, nullptr, aot) ){
+            throw runtime_error("insert pegged order failed");
+        }
+    }
+
+    /* the book re-prices every peg on each move */
+    int m = nmoves(n);
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < m; ++i){
+        ref = ob->replace_with_limit_order(ref, true, (i % 2) ? lo : hi, 100);
+        if( !ref ){
+            throw runtime_error("replace reference order failed");
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    chrono::duration<double> sec = end - start;
+    return sec.count();
+}
+
+
+double
+TEST_n_client_repegs(FullInterface *ob, int n)
+{
+    double incr = ob->tick_size();
+    double mid = ob->price_to_tick((ob->max_price() + ob->min_price()) / 2);
+    double lo = ob->price_to_tick(mid - incr * 10);
+    double hi = ob->price_to_tick(mid - incr * 5);
+
+    ob->insert_limit_order(false, ob->price_to_tick(mid + incr * 10), 100);
+    id_type ref = ob->insert_limit_order(true, lo, 100);
+
+    vector<id_type> active_ids;
+    for(int i = 0; i < npegs(n); ++i){
+        id_type id = ob->insert_limit_order(true, lo - incr, 100);
+        if( !id ){
+            throw runtime_error("insert limit order failed");
+        }
+        active_ids.push_back(id);
+    }
+
+    /* the client replaces every order on each move */
+    int m = nmoves(n);
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < m; ++i){
+        double p = (i % 2) ? lo : hi;
+        ref = ob->replace_with_limit_order(ref, true, p, 100);
+        if( !ref ){
+            throw runtime_error("replace reference order failed");
+        }
+        for( id_type& id : active_ids ){
+            id = ob->replace_with_limit_order(id, true, p - incr, 100);
+            if( !id ){
+                throw runtime_error("replace limit order failed");
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    chrono::duration<double> sec = end - start;
+    return sec.count();
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
+
@@ -139,5 +139,46 @@ TEST_n_replaces(FullInterface *ob, int n)
     return sec.count();
 }
 
+
+double
+TEST_n_modifies(FullInterface *ob, int n)
+{
+    double mid = ob->price_to_tick((ob->max_price() + ob->min_price()) / 2);
+    auto prices = generate_prices(ob, ob->min_price(), ob->max_price(), n);
+    auto sizes = generate_sizes(1, 1000000, n);
+    vector<pair<id_type,bool>> active_ids;
+
+    /* no trades should occur */
+    for(int i = 0; i < n; ++i){
+        bool buy = prices[i] < mid;
+        id_type id = ob->insert_limit_order( buy, prices[i], sizes[i] );
+        if( !id ){
+            throw runtime_error("insert limit failed");
+        }
+        active_ids.emplace_back(id, buy);
+    }
+
+    random_shuffle(active_ids.begin(), active_ids.end());
+    random_shuffle(prices.begin(), prices.end());
+    random_shuffle(sizes.begin(), sizes.end());
+
+    /* half size-only, half new (non-trading) price */
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i){
+        const auto& a = active_ids[i];
+        double p = 0;
+        if( i % 2 ){
+            p = a.second ? min(prices[i], mid - ob->tick_size())
+                         : max(prices[i], mid);
+        }
+        if( !ob->modify_order(a.first, sizes[i], p) ){
+            throw runtime_error("modify order failed");
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    chrono::duration<double> sec = end - start;
+    return sec.count();
+}
+
 #endif /* RUN_PERFORMANCE_TESTS */
 
@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <vector>
+#include <future>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+/*
+ * 'nbooks' books, round-robin over 'nshards' shards (or w/ a dispatcher
+ * thread each if 0), each fed n limits by a thread of its own; total runtime
+ */
+double
+TEST_sharded_books(int nshards, int nbooks, int n)
+{
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+
+    if( nshards > 0 )
+        SimpleOrderbook::StartShards(nshards);
+
+    vector<FullInterface*> books;
+    vector<vector<double>> prices;
+    for( int i = 0; i < nbooks; ++i ){
+        books.push_back( nshards > 0 ? proxy.create_on_shard(0, 100, i % nshards)
+                                     : proxy.create(0, 100) );
+        prices.push_back( generate_prices(books.back(), 0, 100, n) );
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<future<void>> futs;
+    for( int i = 0; i < nbooks; ++i ){
+        FullInterface *ob = books[i];
+        const vector<double> *p = &prices[i];
+        futs.push_back( async(launch::async, [=](){
+            double mid = (ob->max_price() + ob->min_price()) / 2;
+            for( int ii = 0; ii < n; ++ii ){
+                if( !ob->insert_limit_order((*p)[ii] < mid, (*p)[ii], 100) )
+                    throw runtime_error("insert limit order failed");
+            }
+        }) );
+    }
+    for( auto& f : futs )
+        f.get();
+    auto end = chrono::steady_clock::now();
+
+    for( auto ob : books )
+        proxy.destroy(ob);
+
+    if( nshards > 0 )
+        SimpleOrderbook::StopShards();
+
+    chrono::duration<double> sec = end - start;
+    return sec.count();
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+/*
+ * snapshot of a book w/ n resting limits (nothing crosses) and restoring
+ * it into a new book; seconds for each
+ */
+pair<double, double>
+TEST_snapshot_restore(int n)
+{
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+
+    FullInterface *ob = proxy.create(0, 100);
+    auto buy_prices = generate_prices(ob, 1, 49.99, n/2);
+    auto sell_prices = generate_prices(ob, 50, 100, n - n/2);
+    auto sizes = generate_sizes(1, 1000000, n);
+    for( int i = 0; i < n/2; ++i )
+        ob->insert_limit_order(true, buy_prices[i], sizes[i]);
+    for( int i = n/2; i < n; ++i )
+        ob->insert_limit_order(false, sell_prices[i - n/2], sizes[i]);
+
+    stringstream ss;
+    auto start = chrono::steady_clock::now();
+    size_t nsnap = dynamic_cast<ManagementInterface*>(ob)->snapshot(ss);
+    auto mid = chrono::steady_clock::now();
+    proxy.destroy(ob);
+
+    ob = proxy.create(0, 100);
+    auto restart = chrono::steady_clock::now();
+    size_t nrestored = dynamic_cast<ManagementInterface*>(ob)->restore(ss);
+    auto end = chrono::steady_clock::now();
+    if( nsnap != static_cast<size_t>(n) || nrestored != nsnap ){
+        throw runtime_error("restore diverged");
+    }
+    proxy.destroy(ob);
+
+    chrono::duration<double> t_snap = mid - start;
+    chrono::duration<double> t_restore = end - restart;
+    return make_pair(t_snap.count(), t_restore.count());
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */
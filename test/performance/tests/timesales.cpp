@@ -0,0 +1,69 @@
+/*
+Copyright (C) 2017 Jonathon Ogden < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see http://www.gnu.org/licenses.
+*/
+
+#include "../performance.hpp"
+
+#ifdef RUN_PERFORMANCE_TESTS
+
+#include <cmath>
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+using namespace sob;
+
+/*
+ * VWAP over the last n trades: copying time & sales out and summing it
+ * vs. vwap() (in place); seconds for each
+ */
+pair<double, double>
+TEST_timesales_vwap(int n)
+{
+    auto proxy = SimpleOrderbook::BuildFactoryProxy<std::ratio<1,100>>();
+    FullInterface *ob = proxy.create_inline(0, 100);
+    dynamic_cast<ManagementInterface*>(ob)->set_time_and_sales(n);
+
+    auto prices = generate_prices(ob, 1, 99, n);
+    auto sizes = generate_sizes(1, 1000, n);
+    for( int i = 0; i < n; ++i ){
+        ob->insert_limit_order(true, prices[i], sizes[i]);
+        ob->insert_market_order(false, sizes[i]);
+    }
+
+    auto start = chrono::steady_clock::now();
+    double notional = 0;
+    unsigned long long volume = 0;
+    for( auto& t : ob->time_and_sales() ){
+        notional += get<1>(t) * get<2>(t);
+        volume += get<2>(t);
+    }
+    double v1 = notional / volume;
+    auto mid = chrono::steady_clock::now();
+    double v2 = ob->vwap(clock_type::time_point::min(),
+                         clock_type::time_point::max());
+    auto end = chrono::steady_clock::now();
+    proxy.destroy(ob);
+
+    if( std::abs(v1 - v2) > 1e-9 * v1 ){
+        throw runtime_error("vwap mismatch");
+    }
+    chrono::duration<double> t_copy = mid - start;
+    chrono::duration<double> t_vwap = end - mid;
+    return make_pair(t_copy.count(), t_vwap.count());
+}
+
+#endif /* RUN_PERFORMANCE_TESTS */